@@ -0,0 +1,284 @@
+/**
+ * @file    bench_main.c
+ * @brief   Boot-latency benchmark for SetSystemAndBusClockConfig()
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Runs SetSystemAndBusClockConfig() from a cold (reset) simulated RCC for every
+ * system clock speed, bus clock divider and HSI/HSE source, and reports the
+ * cycles spent in each bring-up phase and the number of RCC register reads and
+ * writes as CSV (default) or JSON.
+ *
+ * Usage: bench.out [--json] [--baseline <file.csv>] [--transitions]
+ *   --baseline     Compares each configuration against a previous CSV run and
+ *                  exits with 1 if any of them takes more cycles than before.
+ *   --transitions  Instead of cold boots, times the switch from every working
+ *                  configuration to every other one (runtime reconfiguration).
+ *
+ * Build with MOCK_REGISTERS = 1, e.g.
+ *   clang -DMOCK_REGISTERS=1 startup.c clock_solver.c clock_notify.c clock_profile.c clock_fast_start.c clock_gate.c clock_governor.c clock_health.c clock_restart.c cycle_counter.c power_profile.c rcc_owner.c rcc_txn.c rcc_trace.c rcc_sim.c usart_baud.c bench_main.c -o bench.out
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "startup.h"
+#include "rcc_sim.h"
+
+#define BENCH_NUM_SPEEDS      ((uint32_t)SYS_CLOCK_SPEED_MAX_ENUM_VAL)
+#define BENCH_NUM_BUS_DIVS    3U
+#define BENCH_NUM_SOURCES     2U
+#define BENCH_NUM_RUNS        (BENCH_NUM_SPEEDS * BENCH_NUM_BUS_DIVS * BENCH_NUM_SOURCES)
+#define BENCH_LINE_MAX        256U
+
+typedef struct
+{
+  System_Clock_Speeds_t speed;
+  unsigned int busClockDivider;
+  bool isHsiClock;
+  int32_t result;
+  uint64_t totalCycles;
+  uint64_t phaseCycles[RCC_SIM_PHASE_COUNT];
+  uint32_t reads;
+  uint32_t writes;
+} Bench_Run_t;
+
+static const char *const s_SpeedNames[BENCH_NUM_SPEEDS + 1U] =
+{
+  "undefined", "160M", "80M", "40M", "20M", "10M", "5M", "2.5M", "1.25M"
+};
+
+static const unsigned int s_BusClockDividers[BENCH_NUM_BUS_DIVS] = { 0U, 2U, 4U };
+
+static Bench_Run_t s_Runs[BENCH_NUM_RUNS];
+
+/**
+ * @brief  Cold-boots the simulator and times one clock configuration
+ */
+static void RunOne(Bench_Run_t *run)
+{
+  RccSim_Init(NULL);
+  RccSim_ResetPhaseCycles();
+  RccSim_ResetAccessCounts();
+
+  uint64_t startCycles = RccSim_GetCycles();
+  run->result = SetSystemAndBusClockConfig(run->speed, run->busClockDivider, run->isHsiClock);
+  run->totalCycles = RccSim_GetCycles() - startCycles;
+
+  for (uint32_t phase = 0U; phase < (uint32_t)RCC_SIM_PHASE_COUNT; phase++)
+  {
+    run->phaseCycles[phase] = RccSim_GetPhaseCycles((RccSim_Phase_t)phase);
+  }
+  run->reads = RccSim_GetReadCount();
+  run->writes = RccSim_GetWriteCount();
+}
+
+static const char *SourceName(bool isHsiClock)
+{
+  return isHsiClock ? "HSI" : "HSE";
+}
+
+/**
+ * @brief  Times the switch between every pair of configurations that boot
+ */
+static void PrintTransitionsCsv(void)
+{
+  printf("from_speed,from_bus_div,from_source,to_speed,to_bus_div,to_source,result,total_cycles\n");
+  for (uint32_t i = 0U; i < BENCH_NUM_RUNS; i++)
+  {
+    const Bench_Run_t *from = &s_Runs[i];
+    if (from->result != 0)
+    {
+      continue;
+    }
+
+    for (uint32_t j = 0U; j < BENCH_NUM_RUNS; j++)
+    {
+      const Bench_Run_t *to = &s_Runs[j];
+      RccSim_Init(NULL);
+      (void)SetSystemAndBusClockConfig(from->speed, from->busClockDivider, from->isHsiClock);
+
+      uint64_t startCycles = RccSim_GetCycles();
+      int32_t result = SetSystemAndBusClockConfig(to->speed, to->busClockDivider, to->isHsiClock);
+      printf("%s,%u,%s,%s,%u,%s,%d,%llu\n",
+             s_SpeedNames[from->speed], from->busClockDivider, SourceName(from->isHsiClock),
+             s_SpeedNames[to->speed], to->busClockDivider, SourceName(to->isHsiClock),
+             result, (unsigned long long)(RccSim_GetCycles() - startCycles));
+    }
+  }
+}
+
+static void PrintCsv(void)
+{
+  printf("speed,bus_div,source,result,total_cycles");
+  for (uint32_t phase = 0U; phase < (uint32_t)RCC_SIM_PHASE_COUNT; phase++)
+  {
+    printf(",%s", RccSim_GetPhaseName((RccSim_Phase_t)phase));
+  }
+  printf(",reads,writes\n");
+
+  for (uint32_t i = 0U; i < BENCH_NUM_RUNS; i++)
+  {
+    const Bench_Run_t *run = &s_Runs[i];
+    printf("%s,%u,%s,%d,%llu", s_SpeedNames[run->speed], run->busClockDivider,
+           SourceName(run->isHsiClock), run->result, (unsigned long long)run->totalCycles);
+    for (uint32_t phase = 0U; phase < (uint32_t)RCC_SIM_PHASE_COUNT; phase++)
+    {
+      printf(",%llu", (unsigned long long)run->phaseCycles[phase]);
+    }
+    printf(",%u,%u\n", run->reads, run->writes);
+  }
+}
+
+static void PrintJson(void)
+{
+  printf("[\n");
+  for (uint32_t i = 0U; i < BENCH_NUM_RUNS; i++)
+  {
+    const Bench_Run_t *run = &s_Runs[i];
+    printf("  {\"speed\": \"%s\", \"bus_div\": %u, \"source\": \"%s\", \"result\": %d, "
+           "\"total_cycles\": %llu, \"phases\": {",
+           s_SpeedNames[run->speed], run->busClockDivider, SourceName(run->isHsiClock),
+           run->result, (unsigned long long)run->totalCycles);
+    for (uint32_t phase = 0U; phase < (uint32_t)RCC_SIM_PHASE_COUNT; phase++)
+    {
+      printf("%s\"%s\": %llu", (phase == 0U) ? "" : ", ",
+             RccSim_GetPhaseName((RccSim_Phase_t)phase),
+             (unsigned long long)run->phaseCycles[phase]);
+    }
+    printf("}, \"reads\": %u, \"writes\": %u}%s\n", run->reads, run->writes,
+           (i + 1U < BENCH_NUM_RUNS) ? "," : "");
+  }
+  printf("]\n");
+}
+
+static const Bench_Run_t *FindRun(const char *speedName, unsigned int busClockDivider, const char *sourceName)
+{
+  for (uint32_t i = 0U; i < BENCH_NUM_RUNS; i++)
+  {
+    const Bench_Run_t *run = &s_Runs[i];
+    if ((strcmp(s_SpeedNames[run->speed], speedName) == 0) &&
+        (run->busClockDivider == busClockDivider) &&
+        (strcmp(SourceName(run->isHsiClock), sourceName) == 0))
+    {
+      return run;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief  Compares the runs against a baseline CSV produced by an earlier run
+ * @retval Number of configurations that got slower or started failing
+ */
+static uint32_t CheckBaseline(const char *path)
+{
+  FILE *file = fopen(path, "r");
+  if (file == NULL)
+  {
+    fprintf(stderr, "Cannot open baseline %s\n", path);
+    return 1U;
+  }
+
+  uint32_t regressions = 0U;
+  char line[BENCH_LINE_MAX];
+  while (fgets(line, sizeof(line), file) != NULL)
+  {
+    char speedName[16];
+    char sourceName[8];
+    unsigned int busClockDivider = 0U;
+    int result = 0;
+    unsigned long long totalCycles = 0ULL;
+    if (sscanf(line, "%15[^,],%u,%7[^,],%d,%llu", speedName, &busClockDivider, sourceName,
+               &result, &totalCycles) != 5)
+    {
+      continue; // Header or blank line
+    }
+
+    const Bench_Run_t *run = FindRun(speedName, busClockDivider, sourceName);
+    if (run == NULL)
+    {
+      continue;
+    }
+
+    if ((run->totalCycles > totalCycles) || ((result == 0) && (run->result != 0)))
+    {
+      fprintf(stderr, "REGRESSION %s bus_div=%u %s: %llu -> %llu cycles, result %d -> %d\n",
+              speedName, busClockDivider, sourceName, totalCycles,
+              (unsigned long long)run->totalCycles, result, run->result);
+      regressions++;
+    }
+  }
+
+  fclose(file);
+  return regressions;
+}
+
+int32_t main(int argc, char **argv)
+{
+  bool isJson = false;
+  bool isTransitions = false;
+  const char *baselinePath = NULL;
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--json") == 0)
+    {
+      isJson = true;
+    }
+    else if (strcmp(argv[i], "--transitions") == 0)
+    {
+      isTransitions = true;
+    }
+    else if ((strcmp(argv[i], "--baseline") == 0) && ((i + 1) < argc))
+    {
+      baselinePath = argv[++i];
+    }
+    else
+    {
+      fprintf(stderr, "Usage: %s [--json] [--baseline <file.csv>] [--transitions]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  uint32_t index = 0U;
+  for (uint32_t speed = 1U; speed <= BENCH_NUM_SPEEDS; speed++)
+  {
+    for (uint32_t div = 0U; div < BENCH_NUM_BUS_DIVS; div++)
+    {
+      for (uint32_t source = 0U; source < BENCH_NUM_SOURCES; source++)
+      {
+        Bench_Run_t *run = &s_Runs[index++];
+        run->speed = (System_Clock_Speeds_t)speed;
+        run->busClockDivider = s_BusClockDividers[div];
+        run->isHsiClock = (source == 0U);
+        RunOne(run);
+      }
+    }
+  }
+
+  if (isTransitions)
+  {
+    PrintTransitionsCsv();
+  }
+  else if (isJson)
+  {
+    PrintJson();
+  }
+  else
+  {
+    PrintCsv();
+  }
+
+  if (baselinePath != NULL)
+  {
+    uint32_t regressions = CheckBaseline(baselinePath);
+    if (regressions != 0U)
+    {
+      fprintf(stderr, "%u configuration(s) regressed against %s\n", regressions, baselinePath);
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file    clock_config.hpp
+ * @brief   Compile-time clock configuration for C++
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Header-only C++11 front end for products with one fixed clock
+ * configuration. The configuration is a type, e.g.
+ *
+ *   using BootClock = StaticClockConfig<SYS_CLOCK_SPEED_80M, 4, true>;
+ *   BootClock::Apply();
+ *
+ * The rules of the reference manual are checked by static_assert: listed
+ * RCC_PLLCFGR MUL/DIV codes only, SYS_DIV/BUS_DIV of 1, 2 or 4, and a bus
+ * clock of 20MHz or less. The RCC_PLLCFGR and RCC_CR images are constants,
+ * so Apply() skips BuildClockConfig() and its argument checks. The switch
+ * itself is the normal one: SetClockConfig() still reads RCC_CR and
+ * RCC_PLLCFGR to see which steps are needed, and derives the frequencies for
+ * the clock cache and the notifiers from the images
+ * (GetClockConfigSysClockHz()/GetClockConfigBusClockHz()).
+ *
+ */
+
+#ifndef CLOCK_CONFIG__HPP
+#define CLOCK_CONFIG__HPP
+
+#include <stdint.h>
+#include "rcc_access.h"
+#include "startup.h"
+
+namespace clock_config_detail
+{
+  // Factors as decoded by the RCC (see GetClockConfigSysClockHz())
+  constexpr uint32_t MulFactor(uint32_t code)
+  {
+    return (code == 1U) ? 2U : ((code == 2U) ? 4U : 1U);
+  }
+
+  constexpr uint32_t DivFactor(uint32_t code)
+  {
+    return (code == 1U) ? 2U : ((code == 2U) ? 4U : ((code == 4U) ? 8U : 1U));
+  }
+
+  constexpr uint32_t DividerFactor(uint32_t code)
+  {
+    return (code == 0U) ? 1U : ((code == 1U) ? 2U : 4U);
+  }
+
+  // BUS_DIV code for a SetSystemAndBusClockConfig() style divider, 0xFF if invalid
+  constexpr uint32_t BusDividerCode(unsigned int busClockDivider)
+  {
+    return (busClockDivider <= 1U) ? 0U : ((busClockDivider == 2U) ? 1U : ((busClockDivider == 4U) ? 2U : 0xFFU));
+  }
+
+  /**
+   * @brief PLL MUL/DIV and SYS_DIV codes of each speed, as in BuildClockConfig()
+   */
+  template <System_Clock_Speeds_t SysClockSpeed>
+  struct SpeedCodes
+  {
+    static_assert(static_cast<int>(SysClockSpeed) < 0, "Unknown System_Clock_Speeds_t value");
+  };
+
+  template <> struct SpeedCodes<SYS_CLOCK_SPEED_160M>  { static constexpr uint32_t mul = 2U, div = 0U, sysDiv = 0U; };
+  template <> struct SpeedCodes<SYS_CLOCK_SPEED_80M>   { static constexpr uint32_t mul = 1U, div = 0U, sysDiv = 0U; };
+  template <> struct SpeedCodes<SYS_CLOCK_SPEED_40M>   { static constexpr uint32_t mul = 0U, div = 0U, sysDiv = 0U; };
+  template <> struct SpeedCodes<SYS_CLOCK_SPEED_20M>   { static constexpr uint32_t mul = 0U, div = 1U, sysDiv = 0U; };
+  template <> struct SpeedCodes<SYS_CLOCK_SPEED_10M>   { static constexpr uint32_t mul = 0U, div = 2U, sysDiv = 0U; };
+  template <> struct SpeedCodes<SYS_CLOCK_SPEED_5M>    { static constexpr uint32_t mul = 0U, div = 4U, sysDiv = 0U; };
+  template <> struct SpeedCodes<SYS_CLOCK_SPEED_2_5M>  { static constexpr uint32_t mul = 0U, div = 4U, sysDiv = 1U; };
+  template <> struct SpeedCodes<SYS_CLOCK_SPEED_1_25M> { static constexpr uint32_t mul = 0U, div = 4U, sysDiv = 2U; };
+}
+
+/**
+ * @brief Clock configuration from raw register field codes
+ * @tparam MulCode RCC_PLLCFGR MUL (0b000 = x1, 0b001 = x2, 0b010 = x4)
+ * @tparam DivCode RCC_PLLCFGR DIV (0b000 = /1, 0b001 = /2, 0b010 = /4, 0b100 = /8)
+ * @tparam SysDivCode RCC_CR SYS_DIV (0b00 = /1, 0b01 = /2, 0b10 = /4)
+ * @tparam BusDivCode RCC_CR BUS_DIV (0b00 = /1, 0b01 = /2, 0b10 = /4)
+ * @tparam IsHsiClock Run from HSI if true, otherwise from HSE
+ */
+template <uint32_t MulCode, uint32_t DivCode, uint32_t SysDivCode, uint32_t BusDivCode, bool IsHsiClock>
+struct StaticClockConfigCodes
+{
+  // Unlisted MUL/DIV codes act as 1 in hardware, which is never what was meant
+  static_assert(MulCode <= 2U, "RCC_PLLCFGR MUL must be 0b000, 0b001 or 0b010");
+  static_assert((DivCode <= 2U) || (DivCode == 4U), "RCC_PLLCFGR DIV must be 0b000, 0b001, 0b010 or 0b100");
+  static_assert(SysDivCode <= 2U, "SYS_DIV must divide by 1, 2 or 4");
+  static_assert(BusDivCode <= 2U, "BUS_DIV must divide by 1, 2 or 4");
+
+  static constexpr uint32_t pllcfgr = (MulCode << RCC_PLLCFGR_MUL_Pos) | (DivCode << RCC_PLLCFGR_DIV_Pos);
+  static constexpr uint32_t crDividers = ((SysDivCode << RCC_CR_SYS_DIV_Pos) & RCC_CR_SYS_DIV) |
+                                         ((BusDivCode << RCC_CR_BUS_DIV_Pos) & RCC_CR_BUS_DIV);
+
+  // RCC_CR once the switch is done, without the read-only ready flags
+  static constexpr uint32_t cr = crDividers | RCC_CR_PLLON |
+                                 (IsHsiClock ? (RCC_CR_HSION | RCC_CR_CLKSEL_0) : (RCC_CR_HSEON | RCC_CR_CLKSEL_1));
+
+  static constexpr uint32_t sysClockHz = CLOCK_PLL_INPUT_HZ * clock_config_detail::MulFactor(MulCode) /
+                                         clock_config_detail::DivFactor(DivCode) /
+                                         clock_config_detail::DividerFactor(SysDivCode);
+  static constexpr uint32_t busClockHz = sysClockHz / clock_config_detail::DividerFactor(BusDivCode);
+
+  static_assert(busClockHz <= CLOCK_MAX_BUS_CLOCK_HZ, "Bus clock must be 20MHz or less (raise BUS_DIV)");
+
+  /**
+   * @brief  Register images for the C API (SetClockConfig(), StartClockSwitchConfig(), ...)
+   */
+  static constexpr Clock_Config_t Get()
+  {
+    return Clock_Config_t{ pllcfgr, crDividers, IsHsiClock };
+  }
+
+  /**
+   * @brief  Blocking switch to this configuration, see SetClockConfig()
+   */
+  static int32_t Apply()
+  {
+    static const Clock_Config_t config = Get();   // Constant-initialized, no guard
+    return SetClockConfig(&config);
+  }
+};
+
+/**
+ * @brief Clock configuration with the arguments of SetSystemAndBusClockConfig()
+ * @tparam SysClockSpeed System clock speed
+ * @tparam BusClockDivider Bus clock divider: 0 or 1 (none), 2 or 4
+ * @tparam IsHsiClock Run from HSI if true, otherwise from HSE
+ */
+template <System_Clock_Speeds_t SysClockSpeed, unsigned int BusClockDivider, bool IsHsiClock>
+struct StaticClockConfig
+  : StaticClockConfigCodes<clock_config_detail::SpeedCodes<SysClockSpeed>::mul,
+                           clock_config_detail::SpeedCodes<SysClockSpeed>::div,
+                           clock_config_detail::SpeedCodes<SysClockSpeed>::sysDiv,
+                           clock_config_detail::BusDividerCode(BusClockDivider), IsHsiClock>
+{
+  static_assert(clock_config_detail::BusDividerCode(BusClockDivider) != 0xFFU,
+                "Bus clock divider must be 0, 1, 2 or 4");
+};
+
+#endif // CLOCK_CONFIG__HPP
@@ -0,0 +1,177 @@
+/**
+ * @file    clock_fast_start.c
+ * @brief   Fast start on HSI with background migration to HSE
+ * @author  SMC
+ * @date    September 2025
+ *
+ * See clock_fast_start.h. ClockFastStart_Poll() never waits on the hardware;
+ * call it from the idle loop, a SysTick handler or an RTOS task.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "rcc_access.h"
+#include "rcc_txn.h"
+#include "rcc_owner.h"
+#include "cycle_counter.h"
+#include "clock_fast_start.h"
+
+/**
+ * @brief Migration in progress
+ */
+typedef struct
+{
+  Clock_Migration_State_t state;
+  Clock_Config_t target;          /*!< Same PLL and dividers, on HSE              */
+  Cycle_Wait_t hseWait;           /*!< HSERDY after the early HSEON               */
+  int32_t status;                 /*!< Result of the migration once it has ended  */
+} Clock_Fast_Start_State_t;
+
+static Clock_Fast_Start_State_t s_FastStart = { .state = CLOCK_MIGRATION_IDLE, .status = CLOCK_ERROR_NOT_STARTED };
+
+/**
+ * @brief  Sets or clears HSEON while the system keeps running on HSI
+ * @retval false if another context holds the RCC or a switch is running
+ */
+static bool SetHseOn(bool isOn)
+{
+  uint32_t ownerId = RccOwner_GetContextId();
+  if (!RccOwner_TryAcquireIdle(ownerId))
+  {
+    return false;
+  }
+
+  Rcc_Txn_t txn;
+  RccTxn_Begin(&txn);
+  RccTxn_Unlock(&txn);
+  RccTxn_Modify(&txn, RCC_CR_OFFSET, RCC_CR_HSEON, isOn ? RCC_CR_HSEON : 0U);
+  RccTxn_Lock(&txn);
+  RccTxn_Commit(&txn);
+  (void)RccOwner_Release(ownerId);
+  return true;
+}
+
+static void EndMigration(Clock_Migration_State_t state, int32_t status)
+{
+  s_FastStart.state = state;
+  s_FastStart.status = status;
+}
+
+/**
+ * @brief  Called by the switch driver when the switch to HSE ends
+ */
+static void OnSwitchDone(int32_t status, void *context)
+{
+  (void)context;
+  EndMigration((status == CLOCK_OK) ? CLOCK_MIGRATION_DONE : CLOCK_MIGRATION_FAILED, status);
+}
+
+/**
+ * @brief  Brings the clocks up on HSI and starts the migration to HSE
+ * @note   Blocking for the HSI bring-up only. On return the system runs from
+ *         HSI with the requested PLL, SYS_DIV and BUS_DIV settings and HSE is
+ *         starting up.
+ * @param config Register images (isHsiClock is ignored)
+ * @retval CLOCK_OK if the system runs from HSI, otherwise a negative Clock_Status_t
+ */
+int32_t ClockFastStart_Begin(const Clock_Config_t *config)
+{
+  if (config == NULL)
+  {
+    return CLOCK_ERROR_INVALID_ARG;
+  }
+  if ((s_FastStart.state == CLOCK_MIGRATION_WAIT_HSE) || (s_FastStart.state == CLOCK_MIGRATION_SWITCHING))
+  {
+    return CLOCK_ERROR_BUSY;
+  }
+
+  // Held across the bring-up and the HSEON write so nothing gets in between
+  uint32_t ownerId = RccOwner_GetContextId();
+  if (!RccOwner_TryAcquireIdle(ownerId))
+  {
+    return CLOCK_ERROR_BUSY;
+  }
+
+  Clock_Config_t hsiConfig = *config;
+  hsiConfig.isHsiClock = true;
+  int32_t status = SetClockConfig(&hsiConfig);
+  if (status != CLOCK_OK)
+  {
+    (void)RccOwner_Release(ownerId);
+    EndMigration(CLOCK_MIGRATION_FAILED, status);
+    return status;
+  }
+
+  // Only one oscillator may be on when DEF_CLOCK is cleared, which has
+  // already happened, so HSE can now start next to HSI
+  s_FastStart.target = *config;
+  s_FastStart.target.isHsiClock = false;
+  (void)SetHseOn(true);
+  (void)RccOwner_Release(ownerId);
+  CycleWait_Start(&s_FastStart.hseWait, RCC_CR_OFFSET, RCC_CR_HSERDY, RCC_CR_HSERDY,
+                  CycleCounter_Now(), HSERDY_MAX_TIME_IN_CYCLES);
+  EndMigration(CLOCK_MIGRATION_WAIT_HSE, CLOCK_IN_PROGRESS);
+  return CLOCK_OK;
+}
+
+/**
+ * @brief  Advances the migration to HSE
+ * @note   Once HSERDY is set the switch is started with
+ *         StartClockSwitchConfig(); it is retried on the next poll if another
+ *         switch is running or another context holds the RCC. If HSERDY is not set within 4200 cycles HSE is
+ *         turned off again and the system stays on HSI.
+ * @retval Migration state after the poll
+ */
+Clock_Migration_State_t ClockFastStart_Poll(void)
+{
+  switch (s_FastStart.state)
+  {
+    case CLOCK_MIGRATION_WAIT_HSE:
+    {
+      Cycle_Wait_Result_t result = CycleWait_Poll(&s_FastStart.hseWait, NULL);
+      if (result == CYCLE_WAIT_TIMEOUT)
+      {
+        if (!SetHseOn(false))
+        {
+          break;    // RCC busy or a switch running, turn HSE off on the next poll
+        }
+        EndMigration(CLOCK_MIGRATION_FAILED, CLOCK_ERROR_OSC_TIMEOUT);
+      }
+      else if ((result == CYCLE_WAIT_DONE) &&
+               (StartClockSwitchConfig(&s_FastStart.target, OnSwitchDone, NULL) == CLOCK_OK))
+      {
+        s_FastStart.state = CLOCK_MIGRATION_SWITCHING;
+        (void)PollClockSwitch();
+      }
+      break;
+    }
+
+    case CLOCK_MIGRATION_SWITCHING:
+      (void)PollClockSwitch();
+      break;
+
+    default:
+      break;
+  }
+  return s_FastStart.state;
+}
+
+/**
+ * @brief  Returns the migration state without advancing it
+ */
+Clock_Migration_State_t ClockFastStart_GetState(void)
+{
+  return s_FastStart.state;
+}
+
+/**
+ * @brief  Returns how the migration ended
+ * @retval CLOCK_OK once on HSE, CLOCK_IN_PROGRESS while migrating, otherwise
+ *         the negative Clock_Status_t that stopped it
+ */
+int32_t ClockFastStart_GetStatus(void)
+{
+  return s_FastStart.status;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file    clock_fast_start.h
+ * @brief   Fast start on HSI with background migration to HSE
+ * @author  SMC
+ * @date    September 2025
+ *
+ * The system is brought up on HSI (ready within 1400 cycles) at the target
+ * PLL setting, so the application runs at full speed without waiting for the
+ * crystal (up to 4200 cycles). The crystal is then started while the system
+ * keeps running on HSI. Once HSERDY is set, the system is switched to HSE
+ * through the normal switch path, with the clock-change notifiers called
+ * around it.
+ *
+ * The manual has no direct HSI to HSE handover: the switch goes back through
+ * DEF_CLOCK, which turns both oscillators off. So HSE starts again during the
+ * switch and the system runs at 8MHz for up to about 5200 cycles. The early
+ * start only proves the crystal works, so a dead crystal never takes the
+ * system off HSI.
+ *
+ */
+
+#ifndef CLOCK_FAST_START__H
+#define CLOCK_FAST_START__H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "startup.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Progress of the migration to HSE
+ */
+typedef enum {
+  CLOCK_MIGRATION_IDLE = 0,     // No fast start done
+  CLOCK_MIGRATION_WAIT_HSE,     // Running on HSI, waiting for HSERDY
+  CLOCK_MIGRATION_SWITCHING,    // Switching to HSE
+  CLOCK_MIGRATION_DONE,         // Running on HSE
+  CLOCK_MIGRATION_FAILED,       // HSE not ready in time or switch failed, see ClockFastStart_GetStatus()
+} Clock_Migration_State_t;
+
+int32_t ClockFastStart_Begin(const Clock_Config_t *config);
+Clock_Migration_State_t ClockFastStart_Poll(void);
+Clock_Migration_State_t ClockFastStart_GetState(void);
+int32_t ClockFastStart_GetStatus(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLOCK_FAST_START__H
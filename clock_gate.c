@@ -0,0 +1,276 @@
+/**
+ * @file    clock_gate.c
+ * @brief   Table-driven peripheral clock gating and reset
+ * @author  SMC
+ * @date    September 2025
+ *
+ * See clock_gate.h. All stores go through an RCC transaction (rcc_txn.c), so
+ * each register is read at most once and written once per call, in the order
+ * the reference manual requires. The calls take the RCC ownership token and
+ * are turned away while a clock switch has the RCC.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "rcc_access.h"
+#include "rcc_txn.h"
+#include "rcc_owner.h"
+#include "startup.h"
+#include "clock_gate.h"
+
+/**
+ * @brief Where a peripheral's enable and reset bits are
+ */
+typedef struct
+{
+  uint8_t bus;              /*!< Clock_Bus_t                          */
+  uint8_t bit;              /*!< Bit in RCC_xxxENR and RCC_xxxRSTR    */
+} Clock_Gate_Entry_t;
+
+// STM32F4 bit positions, see clock_gate.h
+static const Clock_Gate_Entry_t s_GateTable[CLOCK_PERIPH_COUNT] =
+{
+  [CLOCK_PERIPH_GPIOA]  = { CLOCK_BUS_AHB1, 0U },
+  [CLOCK_PERIPH_GPIOB]  = { CLOCK_BUS_AHB1, 1U },
+  [CLOCK_PERIPH_GPIOC]  = { CLOCK_BUS_AHB1, 2U },
+  [CLOCK_PERIPH_GPIOD]  = { CLOCK_BUS_AHB1, 3U },
+  [CLOCK_PERIPH_GPIOE]  = { CLOCK_BUS_AHB1, 4U },
+  [CLOCK_PERIPH_GPIOH]  = { CLOCK_BUS_AHB1, 7U },
+  [CLOCK_PERIPH_CRC]    = { CLOCK_BUS_AHB1, 12U },
+  [CLOCK_PERIPH_DMA1]   = { CLOCK_BUS_AHB1, 21U },
+  [CLOCK_PERIPH_DMA2]   = { CLOCK_BUS_AHB1, 22U },
+  [CLOCK_PERIPH_RNG]    = { CLOCK_BUS_AHB2, 6U },
+  [CLOCK_PERIPH_OTGFS]  = { CLOCK_BUS_AHB2, 7U },
+  [CLOCK_PERIPH_TIM2]   = { CLOCK_BUS_APB1, 0U },
+  [CLOCK_PERIPH_TIM3]   = { CLOCK_BUS_APB1, 1U },
+  [CLOCK_PERIPH_TIM4]   = { CLOCK_BUS_APB1, 2U },
+  [CLOCK_PERIPH_TIM5]   = { CLOCK_BUS_APB1, 3U },
+  [CLOCK_PERIPH_WWDG]   = { CLOCK_BUS_APB1, 11U },
+  [CLOCK_PERIPH_SPI2]   = { CLOCK_BUS_APB1, 14U },
+  [CLOCK_PERIPH_SPI3]   = { CLOCK_BUS_APB1, 15U },
+  [CLOCK_PERIPH_USART2] = { CLOCK_BUS_APB1, 17U },
+  [CLOCK_PERIPH_I2C1]   = { CLOCK_BUS_APB1, 21U },
+  [CLOCK_PERIPH_I2C2]   = { CLOCK_BUS_APB1, 22U },
+  [CLOCK_PERIPH_I2C3]   = { CLOCK_BUS_APB1, 23U },
+  [CLOCK_PERIPH_PWR]    = { CLOCK_BUS_APB1, 28U },
+  [CLOCK_PERIPH_TIM1]   = { CLOCK_BUS_APB2, 0U },
+  [CLOCK_PERIPH_USART1] = { CLOCK_BUS_APB2, 4U },
+  [CLOCK_PERIPH_USART6] = { CLOCK_BUS_APB2, 5U },
+  [CLOCK_PERIPH_ADC1]   = { CLOCK_BUS_APB2, 8U },
+  [CLOCK_PERIPH_SDIO]   = { CLOCK_BUS_APB2, 11U },
+  [CLOCK_PERIPH_SPI1]   = { CLOCK_BUS_APB2, 12U },
+  [CLOCK_PERIPH_SPI4]   = { CLOCK_BUS_APB2, 13U },
+  [CLOCK_PERIPH_SYSCFG] = { CLOCK_BUS_APB2, 14U },
+  [CLOCK_PERIPH_TIM9]   = { CLOCK_BUS_APB2, 16U },
+  [CLOCK_PERIPH_TIM10]  = { CLOCK_BUS_APB2, 17U },
+  [CLOCK_PERIPH_TIM11]  = { CLOCK_BUS_APB2, 18U },
+};
+
+static const uint32_t s_EnableOffsets[CLOCK_BUS_COUNT] =
+{
+  RCC_AHB1ENR_OFFSET, RCC_AHB2ENR_OFFSET, RCC_APB1ENR_OFFSET, RCC_APB2ENR_OFFSET
+};
+
+static const uint32_t s_ResetOffsets[CLOCK_BUS_COUNT] =
+{
+  RCC_AHB1RSTR_OFFSET, RCC_AHB2RSTR_OFFSET, RCC_APB1RSTR_OFFSET, RCC_APB2RSTR_OFFSET
+};
+
+/**
+ * @brief How the enable registers change
+ */
+typedef enum
+{
+  CLOCK_GATE_SET_BITS = 0,  /*!< Enable the set, leave the others     */
+  CLOCK_GATE_CLEAR_BITS,    /*!< Disable the set, leave the others    */
+  CLOCK_GATE_EXACT,         /*!< Enable the set, disable the others   */
+} Clock_Gate_Op_t;
+
+/**
+ * @brief  Takes the RCC for a gating call
+ * @retval CLOCK_OK with the token held, otherwise CLOCK_ERROR_BUSY
+ */
+static int32_t Acquire(uint32_t ownerId)
+{
+  return RccOwner_TryAcquireIdle(ownerId) ? CLOCK_OK : CLOCK_ERROR_BUSY;
+}
+
+/**
+ * @brief  Turns a peripheral set into one mask per bus
+ * @param peripherals Set of CLOCK_PERIPH_SET() values
+ * @param masks Receives the RCC_xxxENR/RCC_xxxRSTR bits, indexed by Clock_Bus_t
+ * @retval CLOCK_OK, or CLOCK_ERROR_INVALID_ARG for bits beyond CLOCK_PERIPH_COUNT
+ */
+int32_t ClockGate_GetMasks(Clock_Peripheral_Set_t peripherals, uint32_t masks[CLOCK_BUS_COUNT])
+{
+  if ((masks == NULL) || ((peripherals & ~CLOCK_PERIPH_SET_ALL) != 0U))
+  {
+    return CLOCK_ERROR_INVALID_ARG;
+  }
+
+  for (uint32_t bus = 0U; bus < (uint32_t)CLOCK_BUS_COUNT; bus++)
+  {
+    masks[bus] = 0U;
+  }
+  for (uint32_t periph = 0U; periph < (uint32_t)CLOCK_PERIPH_COUNT; periph++)
+  {
+    if ((peripherals & CLOCK_PERIPH_SET(periph)) != 0U)
+    {
+      masks[s_GateTable[periph].bus] |= 1UL << s_GateTable[periph].bit;
+    }
+  }
+  return CLOCK_OK;
+}
+
+/**
+ * @brief  Changes the enable registers of every bus the set touches
+ */
+static int32_t ApplyEnables(Clock_Peripheral_Set_t peripherals, Clock_Gate_Op_t op)
+{
+  uint32_t masks[CLOCK_BUS_COUNT];
+  int32_t status = ClockGate_GetMasks(peripherals, masks);
+  if (status != CLOCK_OK)
+  {
+    return status;
+  }
+
+  uint32_t ownerId = RccOwner_GetContextId();
+  status = Acquire(ownerId);
+  if (status != CLOCK_OK)
+  {
+    return status;
+  }
+
+  Rcc_Txn_t txn;
+  RccTxn_Begin(&txn);
+  RccTxn_Unlock(&txn);
+  for (uint32_t bus = 0U; bus < (uint32_t)CLOCK_BUS_COUNT; bus++)
+  {
+    if (op == CLOCK_GATE_EXACT)
+    {
+      RccTxn_Write(&txn, s_EnableOffsets[bus], masks[bus]);   // No read needed
+    }
+    else if (masks[bus] != 0U)
+    {
+      RccTxn_Modify(&txn, s_EnableOffsets[bus], masks[bus], (op == CLOCK_GATE_SET_BITS) ? masks[bus] : 0U);
+    }
+  }
+  RccTxn_Lock(&txn);
+  RccTxn_Commit(&txn);
+
+  (void)RccOwner_Release(ownerId);
+  return CLOCK_OK;
+}
+
+/**
+ * @brief  Turns on the clocks of a set of peripherals
+ * @note   One read and one store per bus the set touches. Other peripherals
+ *         keep their clocks.
+ * @param peripherals Set of CLOCK_PERIPH_SET() values
+ * @retval CLOCK_OK, CLOCK_ERROR_BUSY if a switch or another context has the
+ *         RCC, CLOCK_ERROR_INVALID_ARG for unknown peripherals
+ */
+int32_t ClockGate_Enable(Clock_Peripheral_Set_t peripherals)
+{
+  return ApplyEnables(peripherals, CLOCK_GATE_SET_BITS);
+}
+
+/**
+ * @brief  Turns off the clocks of a set of peripherals
+ * @param peripherals Set of CLOCK_PERIPH_SET() values
+ * @retval Same as ClockGate_Enable()
+ */
+int32_t ClockGate_Disable(Clock_Peripheral_Set_t peripherals)
+{
+  return ApplyEnables(peripherals, CLOCK_GATE_CLEAR_BITS);
+}
+
+/**
+ * @brief  Clocks exactly the given peripherals and gates all others
+ * @note   Meant for init: four stores and no reads. Bits this table does not
+ *         know are cleared too.
+ * @param peripherals Set of CLOCK_PERIPH_SET() values
+ * @retval Same as ClockGate_Enable()
+ */
+int32_t ClockGate_SetEnabled(Clock_Peripheral_Set_t peripherals)
+{
+  return ApplyEnables(peripherals, CLOCK_GATE_EXACT);
+}
+
+/**
+ * @brief  Pulses the reset of a set of peripherals
+ * @note   Sets their RCC_xxxRSTR bits with one store per bus, then clears
+ *         them with a second. Clock enables are left as they are.
+ * @param peripherals Set of CLOCK_PERIPH_SET() values
+ * @retval Same as ClockGate_Enable()
+ */
+int32_t ClockGate_Reset(Clock_Peripheral_Set_t peripherals)
+{
+  uint32_t masks[CLOCK_BUS_COUNT];
+  int32_t status = ClockGate_GetMasks(peripherals, masks);
+  if (status != CLOCK_OK)
+  {
+    return status;
+  }
+
+  uint32_t ownerId = RccOwner_GetContextId();
+  status = Acquire(ownerId);
+  if (status != CLOCK_OK)
+  {
+    return status;
+  }
+
+  // A transaction stores each register once, so the pulse takes two:
+  // assert with the RCC unlocked, release and lock
+  Rcc_Txn_t txn;
+  RccTxn_Begin(&txn);
+  RccTxn_Unlock(&txn);
+  uint32_t resetValues[CLOCK_BUS_COUNT];
+  for (uint32_t bus = 0U; bus < (uint32_t)CLOCK_BUS_COUNT; bus++)
+  {
+    if (masks[bus] != 0U)
+    {
+      resetValues[bus] = RccTxn_Read(&txn, s_ResetOffsets[bus]);
+      RccTxn_Write(&txn, s_ResetOffsets[bus], resetValues[bus] | masks[bus]);
+    }
+  }
+  RccTxn_Commit(&txn);
+
+  for (uint32_t bus = 0U; bus < (uint32_t)CLOCK_BUS_COUNT; bus++)
+  {
+    if (masks[bus] != 0U)
+    {
+      RccTxn_Write(&txn, s_ResetOffsets[bus], resetValues[bus] & ~masks[bus]);
+    }
+  }
+  RccTxn_Lock(&txn);
+  RccTxn_Commit(&txn);
+
+  (void)RccOwner_Release(ownerId);
+  return CLOCK_OK;
+}
+
+/**
+ * @brief  Returns the set of peripherals whose clock is on
+ * @note   Reads the four enable registers; no token needed.
+ */
+Clock_Peripheral_Set_t ClockGate_GetEnabled(void)
+{
+  uint32_t enables[CLOCK_BUS_COUNT];
+  for (uint32_t bus = 0U; bus < (uint32_t)CLOCK_BUS_COUNT; bus++)
+  {
+    enables[bus] = RccRead(s_EnableOffsets[bus]);
+  }
+
+  Clock_Peripheral_Set_t peripherals = 0U;
+  for (uint32_t periph = 0U; periph < (uint32_t)CLOCK_PERIPH_COUNT; periph++)
+  {
+    if ((enables[s_GateTable[periph].bus] & (1UL << s_GateTable[periph].bit)) != 0U)
+    {
+      peripherals |= CLOCK_PERIPH_SET(periph);
+    }
+  }
+  return peripherals;
+}
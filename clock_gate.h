@@ -0,0 +1,104 @@
+/**
+ * @file    clock_gate.h
+ * @brief   Table-driven peripheral clock gating and reset
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Peripherals are passed as a set (CLOCK_PERIPH_SET() of the enum values).
+ * The set is turned into one mask per bus and every RCC_xxxENR/RCC_xxxRSTR
+ * register involved is changed with a single store, inside one unlock/lock
+ * sequence.
+ *
+ * The reference manual lists the enable and reset registers but not their
+ * bits. The bit positions below follow the STM32F4 RCC layout, which the
+ * register map matches; check them against the silicon before relying on
+ * them.
+ *
+ */
+
+#ifndef CLOCK_GATE__H
+#define CLOCK_GATE__H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Peripherals with a clock enable and reset bit in the RCC
+ */
+typedef enum {
+  // AHB1
+  CLOCK_PERIPH_GPIOA = 0,
+  CLOCK_PERIPH_GPIOB,
+  CLOCK_PERIPH_GPIOC,
+  CLOCK_PERIPH_GPIOD,
+  CLOCK_PERIPH_GPIOE,
+  CLOCK_PERIPH_GPIOH,
+  CLOCK_PERIPH_CRC,
+  CLOCK_PERIPH_DMA1,
+  CLOCK_PERIPH_DMA2,
+  // AHB2
+  CLOCK_PERIPH_RNG,
+  CLOCK_PERIPH_OTGFS,
+  // APB1
+  CLOCK_PERIPH_TIM2,
+  CLOCK_PERIPH_TIM3,
+  CLOCK_PERIPH_TIM4,
+  CLOCK_PERIPH_TIM5,
+  CLOCK_PERIPH_WWDG,
+  CLOCK_PERIPH_SPI2,
+  CLOCK_PERIPH_SPI3,
+  CLOCK_PERIPH_USART2,
+  CLOCK_PERIPH_I2C1,
+  CLOCK_PERIPH_I2C2,
+  CLOCK_PERIPH_I2C3,
+  CLOCK_PERIPH_PWR,
+  // APB2
+  CLOCK_PERIPH_TIM1,
+  CLOCK_PERIPH_USART1,
+  CLOCK_PERIPH_USART6,
+  CLOCK_PERIPH_ADC1,
+  CLOCK_PERIPH_SDIO,
+  CLOCK_PERIPH_SPI1,
+  CLOCK_PERIPH_SPI4,
+  CLOCK_PERIPH_SYSCFG,
+  CLOCK_PERIPH_TIM9,
+  CLOCK_PERIPH_TIM10,
+  CLOCK_PERIPH_TIM11,
+  CLOCK_PERIPH_COUNT,
+} Clock_Peripheral_t;
+
+/**
+ * @brief Buses, in RCC register order
+ */
+typedef enum {
+  CLOCK_BUS_AHB1 = 0,
+  CLOCK_BUS_AHB2,
+  CLOCK_BUS_APB1,
+  CLOCK_BUS_APB2,
+  CLOCK_BUS_COUNT,
+} Clock_Bus_t;
+
+/**
+ * @brief Set of peripherals, one bit per Clock_Peripheral_t
+ */
+typedef uint64_t Clock_Peripheral_Set_t;
+
+#define CLOCK_PERIPH_SET(periph)         (1ULL << (uint32_t)(periph))
+#define CLOCK_PERIPH_SET_ALL             ((1ULL << (uint32_t)CLOCK_PERIPH_COUNT) - 1ULL)
+
+int32_t ClockGate_GetMasks(Clock_Peripheral_Set_t peripherals, uint32_t masks[CLOCK_BUS_COUNT]);
+int32_t ClockGate_Enable(Clock_Peripheral_Set_t peripherals);
+int32_t ClockGate_Disable(Clock_Peripheral_Set_t peripherals);
+int32_t ClockGate_SetEnabled(Clock_Peripheral_Set_t peripherals);
+int32_t ClockGate_Reset(Clock_Peripheral_Set_t peripherals);
+Clock_Peripheral_Set_t ClockGate_GetEnabled(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLOCK_GATE__H
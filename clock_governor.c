@@ -0,0 +1,245 @@
+/**
+ * @file    clock_governor.c
+ * @brief   Load-driven system clock governor
+ * @author  SMC
+ * @date    September 2025
+ *
+ * See clock_governor.h. Call all functions from the same context (normally
+ * the idle loop); the idle accounting is not protected against preemption.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "cycle_counter.h"
+#include "clock_solver.h"
+#include "clock_governor.h"
+
+/**
+ * @brief Levels, utilization window and switch in progress
+ */
+typedef struct
+{
+  Clock_Config_t levels[CLOCK_GOVERNOR_MAX_LEVELS];   /*!< Index 0 is the fastest           */
+  System_Clock_Speeds_t speeds[CLOCK_GOVERNOR_MAX_LEVELS];
+  uint32_t levelCount;
+  uint32_t level;               /*!< Level the clocks run at, once isStarted           */
+  uint32_t targetLevel;         /*!< Level being switched to                           */
+  bool isSwitching;
+  bool isInitialized;
+  bool isStarted;               /*!< The switch started by ClockGovernor_Init() ended well */
+  uint32_t windowCycles;
+  uint8_t upPercent;
+  uint8_t downPercent;
+  uint32_t windowStartCycles;
+  uint32_t idleCycles;          /*!< Idle cycles in the current window                 */
+  bool isIdle;
+  uint32_t idleStartCycles;
+  uint32_t utilization;         /*!< Percent busy in the last complete window          */
+} Clock_Governor_State_t;
+
+static Clock_Governor_State_t s_Governor;
+
+static void RestartWindow(uint32_t now)
+{
+  s_Governor.windowStartCycles = now;
+  s_Governor.idleCycles = 0U;
+  if (s_Governor.isIdle)
+  {
+    s_Governor.idleStartCycles = now;
+  }
+}
+
+/**
+ * @brief  Ends the level switch once PollClockSwitch() reports its result
+ */
+static int32_t PollLevelSwitch(void)
+{
+  int32_t status = PollClockSwitch();
+  if (status == CLOCK_IN_PROGRESS)
+  {
+    return status;
+  }
+
+  s_Governor.isSwitching = false;
+  if (status == CLOCK_OK)
+  {
+    s_Governor.level = s_Governor.targetLevel;
+    s_Governor.isStarted = true;
+  }
+  else if (!s_Governor.isStarted)
+  {
+    s_Governor.isInitialized = false;   // The clocks never reached a level
+  }
+  RestartWindow(CycleCounter_Now());   // The old window was measured at the old clock
+  return status;
+}
+
+/**
+ * @brief  Starts the switch to a level and runs it as far as it goes
+ * @note   A divider-only switch ends within this call.
+ */
+static int32_t StartLevelSwitch(uint32_t level)
+{
+  int32_t status = StartClockSwitchConfig(&s_Governor.levels[level], NULL, NULL);
+  if (status != CLOCK_OK)
+  {
+    return status;    // e.g. CLOCK_ERROR_BUSY, tried again after the next window
+  }
+
+  s_Governor.targetLevel = level;
+  s_Governor.isSwitching = true;
+  return PollLevelSwitch();
+}
+
+/**
+ * @brief  Builds the levels and starts the switch to the fastest one
+ * @note   If that switch cannot start or fails, the governor stays
+ *         uninitialized and ClockGovernor_Init() has to be called again.
+ * @param config Governor settings
+ * @retval CLOCK_OK or CLOCK_IN_PROGRESS if the switch started, otherwise a
+ *         negative Clock_Status_t (invalid settings, a level that can't be
+ *         built, CLOCK_ERROR_BUSY or the failure of the switch)
+ */
+int32_t ClockGovernor_Init(const Clock_Governor_Config_t *config)
+{
+  if ((config == NULL) || (config->windowCycles == 0U) || (config->downPercent >= config->upPercent) ||
+      (config->upPercent > 100U) || (config->maxSysClockSpeed == SYS_CLOCK_SPEED_UNDEFINED) ||
+      (config->maxSysClockSpeed > config->minSysClockSpeed) ||
+      (config->minSysClockSpeed > SYS_CLOCK_SPEED_MAX_ENUM_VAL) || s_Governor.isSwitching)
+  {
+    return CLOCK_ERROR_INVALID_ARG;
+  }
+
+  static const unsigned int busClockDividers[] = { 0U, 2U, 4U };
+  Clock_Governor_State_t governor = { 0 };
+  for (uint32_t speed = (uint32_t)config->maxSysClockSpeed; speed <= (uint32_t)config->minSysClockSpeed; speed++)
+  {
+    Clock_Config_t *level = &governor.levels[governor.levelCount];
+    int32_t status = CLOCK_ERROR_BUS_LIMIT;
+    for (uint32_t i = 0U; (i < (sizeof(busClockDividers) / sizeof(busClockDividers[0]))) && (status != CLOCK_OK); i++)
+    {
+      status = BuildClockConfig((System_Clock_Speeds_t)speed, busClockDividers[i], config->isHsiClock, level);
+    }
+    if (status != CLOCK_OK)
+    {
+      return status;
+    }
+    if (governor.levelCount > 0U)
+    {
+      (void)ShareClockConfigPll(level, &governor.levels[0]);
+    }
+    governor.speeds[governor.levelCount++] = (System_Clock_Speeds_t)speed;
+  }
+
+  CycleCounter_Enable();
+  governor.windowCycles = config->windowCycles;
+  governor.upPercent = config->upPercent;
+  governor.downPercent = config->downPercent;
+  governor.utilization = 100U;
+  governor.isInitialized = true;
+  governor.windowStartCycles = CycleCounter_Now();
+  s_Governor = governor;
+  int32_t status = StartLevelSwitch(0U);
+  if ((status != CLOCK_OK) && (status != CLOCK_IN_PROGRESS))
+  {
+    s_Governor.isInitialized = false;
+  }
+  return status;
+}
+
+/**
+ * @brief  Marks the start of idle time (e.g. top of the idle loop)
+ */
+void ClockGovernor_IdleEnter(void)
+{
+  s_Governor.idleStartCycles = CycleCounter_Now();
+  s_Governor.isIdle = true;
+}
+
+/**
+ * @brief  Marks the end of idle time
+ */
+void ClockGovernor_IdleExit(void)
+{
+  if (s_Governor.isIdle)
+  {
+    s_Governor.idleCycles += CycleCounter_Now() - s_Governor.idleStartCycles;
+    s_Governor.isIdle = false;
+  }
+}
+
+/**
+ * @brief  Adds idle time the cycle counter did not see (WFI sleep)
+ * @param cycles Sleep time converted to CPU cycles at the current clock
+ */
+void ClockGovernor_AddIdleCycles(uint32_t cycles)
+{
+  s_Governor.idleCycles += cycles;
+}
+
+/**
+ * @brief  Closes the window when it is full and moves one level if needed
+ * @note   Cheap unless a window ends. Also advances a level switch that
+ *         could not finish in one call.
+ * @retval CLOCK_OK, CLOCK_IN_PROGRESS while a level switch runs, otherwise
+ *         the negative Clock_Status_t of the last level switch
+ */
+int32_t ClockGovernor_Update(void)
+{
+  if (!s_Governor.isInitialized)
+  {
+    return CLOCK_ERROR_NOT_STARTED;
+  }
+  if (s_Governor.isSwitching)
+  {
+    return PollLevelSwitch();
+  }
+
+  uint32_t now = CycleCounter_Now();
+  if (s_Governor.isIdle)
+  {
+    s_Governor.idleCycles += now - s_Governor.idleStartCycles;
+    s_Governor.idleStartCycles = now;
+  }
+
+  uint32_t elapsed = now - s_Governor.windowStartCycles;
+  if (elapsed < s_Governor.windowCycles)
+  {
+    return CLOCK_OK;
+  }
+
+  uint32_t idle = (s_Governor.idleCycles < elapsed) ? s_Governor.idleCycles : elapsed;
+  s_Governor.utilization = (uint32_t)(((uint64_t)(elapsed - idle) * 100U) / elapsed);
+  RestartWindow(now);
+
+  uint32_t level = s_Governor.level;
+  if ((s_Governor.utilization > s_Governor.upPercent) && (level > 0U))
+  {
+    return StartLevelSwitch(level - 1U);
+  }
+  if ((s_Governor.utilization < s_Governor.downPercent) && ((level + 1U) < s_Governor.levelCount))
+  {
+    return StartLevelSwitch(level + 1U);
+  }
+  return CLOCK_OK;
+}
+
+/**
+ * @brief  Returns the speed the clocks run at (the last level reached)
+ * @retval SYS_CLOCK_SPEED_UNDEFINED until the first level is reached
+ */
+System_Clock_Speeds_t ClockGovernor_GetSysClockSpeed(void)
+{
+  return (s_Governor.isInitialized && s_Governor.isStarted) ? s_Governor.speeds[s_Governor.level] :
+                                                               SYS_CLOCK_SPEED_UNDEFINED;
+}
+
+/**
+ * @brief  Returns the utilization of the last complete window in percent
+ */
+uint32_t ClockGovernor_GetUtilization(void)
+{
+  return s_Governor.utilization;
+}
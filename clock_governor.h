@@ -0,0 +1,65 @@
+/**
+ * @file    clock_governor.h
+ * @brief   Load-driven system clock governor
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Optional module. The application marks its idle time with
+ * ClockGovernor_IdleEnter()/ClockGovernor_IdleExit() and calls
+ * ClockGovernor_Update() from its idle loop. At the end of every window the
+ * governor computes the CPU utilization and moves one System_Clock_Speeds_t
+ * level up when it is above the up threshold, or one level down when it is
+ * below the down threshold. The gap between the two thresholds is the
+ * hysteresis.
+ *
+ * The levels are built once by ClockGovernor_Init(), each with the smallest
+ * legal bus divider. Levels reachable from the fastest level's PLL setting by
+ * SYS_DIV alone share that setting (ShareClockConfigPll()), so stepping
+ * between them is a divider-only switch of a few cycles. Only the slower
+ * levels need the full switch through DEF_CLOCK. Switches are non-blocking
+ * and advance on later updates.
+ *
+ * Windows are counted in CPU cycles (cycle_counter.h). On target the DWT
+ * counter stops while the core sleeps in WFI, so the sleep time is passed
+ * with ClockGovernor_AddIdleCycles() instead, e.g. from a low-power timer.
+ *
+ */
+
+#ifndef CLOCK_GOVERNOR__H
+#define CLOCK_GOVERNOR__H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "startup.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CLOCK_GOVERNOR_MAX_LEVELS        ((uint32_t)SYS_CLOCK_SPEED_MAX_ENUM_VAL)
+
+/**
+ * @brief Governor settings
+ */
+typedef struct {
+  System_Clock_Speeds_t maxSysClockSpeed;   // Fastest level, e.g. 80MHz (160MHz breaks the bus limit)
+  System_Clock_Speeds_t minSysClockSpeed;   // Slowest level
+  bool isHsiClock;
+  uint32_t windowCycles;                    // Utilization window in CPU cycles
+  uint8_t upPercent;                        // Step up when utilization is above this
+  uint8_t downPercent;                      // Step down when utilization is below this (< upPercent)
+} Clock_Governor_Config_t;
+
+int32_t ClockGovernor_Init(const Clock_Governor_Config_t *config);
+void ClockGovernor_IdleEnter(void);
+void ClockGovernor_IdleExit(void);
+void ClockGovernor_AddIdleCycles(uint32_t cycles);
+int32_t ClockGovernor_Update(void);
+System_Clock_Speeds_t ClockGovernor_GetSysClockSpeed(void);
+uint32_t ClockGovernor_GetUtilization(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLOCK_GOVERNOR__H
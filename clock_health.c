@@ -0,0 +1,208 @@
+/**
+ * @file    clock_health.c
+ * @brief   Periodic check that the RCC still runs the requested clocks
+ * @author  SMC
+ * @date    September 2025
+ *
+ * See clock_health.h. A fault is counted once when the RCC leaves the
+ * requested configuration, however many checks see it.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "rcc_access.h"
+#include "clock_notify.h"
+#include "startup.h"
+#include "clock_health.h"
+
+static bool s_IsAutoRestore = false;
+static bool s_IsFaulted = false;        /*!< Current fault already reported       */
+static bool s_IsRestoring = false;      /*!< Restore switch of ours is running    */
+static uint32_t s_RestoreAttempts = 0U; /*!< Restores started for the current fault */
+static Clock_Health_t s_LastHealth = CLOCK_HEALTH_NOT_CONFIGURED;
+static Clock_Health_Stats_t s_Stats;
+
+/**
+ * @brief  Compares RCC_CR with a configuration
+ */
+static Clock_Health_t Diagnose(uint32_t rccCrReg, const Clock_Config_t *config)
+{
+  uint32_t clksel = rccCrReg & RCC_CR_CLKSEL;
+  uint32_t requestedClksel = config->isHsiClock ? RCC_CR_CLKSEL_0 : RCC_CR_CLKSEL_1;
+  uint32_t oscReadyBit = config->isHsiClock ? RCC_CR_HSIRDY : RCC_CR_HSERDY;
+
+  if (((rccCrReg & RCC_CR_DEF_CLOCK) != 0U) || (clksel == 0U))
+  {
+    return CLOCK_HEALTH_DEF_CLOCK;
+  }
+  if (clksel != requestedClksel)
+  {
+    return CLOCK_HEALTH_WRONG_SOURCE;
+  }
+  if ((rccCrReg & RCC_CR_PLL_RDY) == 0U)
+  {
+    return CLOCK_HEALTH_PLL_NOT_READY;
+  }
+  if ((rccCrReg & oscReadyBit) == 0U)
+  {
+    return CLOCK_HEALTH_OSC_NOT_READY;
+  }
+  if ((rccCrReg & (RCC_CR_SYS_DIV | RCC_CR_BUS_DIV)) != config->crDividers)
+  {
+    return CLOCK_HEALTH_WRONG_DIVIDERS;
+  }
+  return CLOCK_HEALTH_OK;
+}
+
+/**
+ * @brief  Status passed to the post-change notifiers for a fault
+ */
+static int32_t FaultStatus(Clock_Health_t health)
+{
+  switch (health)
+  {
+    case CLOCK_HEALTH_PLL_NOT_READY:
+      return CLOCK_ERROR_PLL_TIMEOUT;
+
+    case CLOCK_HEALTH_OSC_NOT_READY:
+      return CLOCK_ERROR_OSC_TIMEOUT;
+
+    default:
+      return CLOCK_ERROR_FALLBACK;
+  }
+}
+
+/**
+ * @brief  Counts a new fault, re-reads the clock cache and tells the drivers
+ */
+static void ReportFault(Clock_Health_t health)
+{
+  s_Stats.faults++;
+  if (health == CLOCK_HEALTH_DEF_CLOCK)
+  {
+    s_Stats.fallbacks++;
+  }
+
+  Clock_Notify_Info_t info;
+  info.oldSysClockHz = GetSystemClockHz();
+  info.oldBusClockHz = GetBusClockHz();
+  SystemClockUpdate();
+  info.newSysClockHz = GetSystemClockHz();
+  info.newBusClockHz = GetBusClockHz();
+  info.status = FaultStatus(health);
+  if ((info.newSysClockHz != info.oldSysClockHz) || (info.newBusClockHz != info.oldBusClockHz))
+  {
+    // May interrupt a registration; the walk uses the table published before it
+    ClockNotify_PostChange(&info);
+  }
+}
+
+static void OnRestoreDone(int32_t status, void *context)
+{
+  (void)context;
+  s_IsRestoring = false;
+  if (status != CLOCK_OK)
+  {
+    s_Stats.restoreFailures++;
+  }
+}
+
+/**
+ * @brief  Resets the monitor
+ * @param isAutoRestore Switch the requested configuration back on after a fault
+ */
+void ClockHealth_Init(bool isAutoRestore)
+{
+  s_IsAutoRestore = isAutoRestore;
+  s_IsFaulted = false;
+  s_IsRestoring = false;
+  s_RestoreAttempts = 0U;
+  s_LastHealth = CLOCK_HEALTH_NOT_CONFIGURED;
+  s_Stats = (Clock_Health_Stats_t){ 0U };
+}
+
+/**
+ * @brief  Checks the RCC against the last configuration a switch reached
+ * @note   One RCC_CR read, nothing else while healthy. Safe to call from
+ *         SysTick or the idle loop, but from one context only.
+ *         After a failed switch the RCC is not where the failed request
+ *         wanted it, but that is no silent fault: the switch already
+ *         returned its error and called the notifiers. It is not counted,
+ *         and auto-restore goes back to the last good configuration rather
+ *         than retry the failed one.
+ * @retval CLOCK_HEALTH_OK, or what is wrong
+ */
+Clock_Health_t ClockHealth_Check(void)
+{
+  s_Stats.checks++;
+  if (IsClockSwitchInProgress())
+  {
+    if (s_IsRestoring)
+    {
+      (void)PollClockSwitch();
+    }
+    s_LastHealth = CLOCK_HEALTH_SWITCHING;
+    return s_LastHealth;
+  }
+
+  const Clock_Driver_t *driver = ClockDriver_GetDefault();
+  Clock_Config_t config;
+  if (!ClockDriver_GetGoodConfig(driver, &config))
+  {
+    s_LastHealth = CLOCK_HEALTH_NOT_CONFIGURED;
+    return s_LastHealth;
+  }
+
+  Clock_Health_t health = Diagnose(RccRead(RCC_CR_OFFSET), &config);
+  if (health == CLOCK_HEALTH_OK)
+  {
+    s_IsFaulted = false;
+    s_RestoreAttempts = 0U;
+  }
+  else
+  {
+    if (!s_IsFaulted)
+    {
+      s_IsFaulted = true;
+      if (ClockDriver_GetLastStatus(driver) == CLOCK_OK)
+      {
+        ReportFault(health);
+      }
+    }
+
+    // Busy means another context holds the RCC: try again on the next check
+    if (s_IsAutoRestore && (s_RestoreAttempts < CLOCK_HEALTH_MAX_RESTORES) &&
+        (StartClockSwitchConfig(&config, OnRestoreDone, NULL) == CLOCK_OK))
+    {
+      s_RestoreAttempts++;
+      s_Stats.restores++;
+      s_IsRestoring = true;
+      (void)PollClockSwitch();
+    }
+  }
+
+  s_LastHealth = health;
+  return health;
+}
+
+/**
+ * @brief  Returns the result of the last check
+ */
+Clock_Health_t ClockHealth_GetLast(void)
+{
+  return s_LastHealth;
+}
+
+/**
+ * @brief  Returns the counters since ClockHealth_Init()
+ * @param stats Filled in with the counters
+ */
+void ClockHealth_GetStats(Clock_Health_Stats_t *stats)
+{
+  if (stats != NULL)
+  {
+    *stats = s_Stats;
+  }
+}
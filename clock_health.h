@@ -0,0 +1,74 @@
+/**
+ * @file    clock_health.h
+ * @brief   Periodic check that the RCC still runs the requested clocks
+ * @author  SMC
+ * @date    September 2025
+ *
+ * The RCC falls back to DEF_CLOCK (8MHz) on its own when a configuration
+ * turns invalid, e.g. when an oscillator or the PLL drops out, and nothing
+ * reports it. ClockHealth_Check() compares RCC_CR (CLKSEL, DEF_CLOCK,
+ * PLL_RDY, HSIRDY/HSERDY, SYS_DIV/BUS_DIV) with the last configuration a
+ * switch of the startup driver reached (ClockDriver_GetGoodConfig()), with a
+ * single register read. Call it from SysTick or the idle loop.
+ *
+ * When the RCC leaves that configuration the clock cache is read back from
+ * the registers and the post-change clock notifiers are called with the
+ * failure status, so peripheral drivers can follow the slower clocks. A
+ * switch that failed has already reported itself and is not counted again.
+ * With auto-restore the last good configuration is switched back on through
+ * the startup driver, non-blocking. The switch only starts if the RCC token is
+ * free (rcc_owner.h); otherwise the next check tries again. Checks advance
+ * the restore switch, and so does RCC_IRQHandler() if it is wired up. After
+ * CLOCK_HEALTH_MAX_RESTORES failed restores of one fault the monitor only
+ * reports until the RCC is healthy again.
+ *
+ */
+
+#ifndef CLOCK_HEALTH__H
+#define CLOCK_HEALTH__H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "startup.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CLOCK_HEALTH_MAX_RESTORES        3U    /*!< Restore attempts per fault */
+
+/**
+ * @brief Result of a check
+ */
+typedef enum {
+  CLOCK_HEALTH_OK = 0,              // Running the requested configuration
+  CLOCK_HEALTH_NOT_CONFIGURED,      // No switch requested yet, nothing to compare with
+  CLOCK_HEALTH_SWITCHING,           // A switch is running
+  CLOCK_HEALTH_DEF_CLOCK,           // Fell back to DEF_CLOCK
+  CLOCK_HEALTH_WRONG_SOURCE,        // CLKSEL shows the other oscillator
+  CLOCK_HEALTH_PLL_NOT_READY,       // PLL_RDY cleared
+  CLOCK_HEALTH_OSC_NOT_READY,       // HSIRDY/HSERDY of the source cleared
+  CLOCK_HEALTH_WRONG_DIVIDERS,      // SYS_DIV/BUS_DIV differ from the request
+} Clock_Health_t;
+
+/**
+ * @brief Counters since ClockHealth_Init()
+ */
+typedef struct {
+  uint32_t checks;
+  uint32_t faults;          // Times the RCC silently left the last good configuration
+  uint32_t fallbacks;       // Those that ended on DEF_CLOCK
+  uint32_t restores;        // Restore switches started
+  uint32_t restoreFailures; // Restore switches that did not succeed
+} Clock_Health_Stats_t;
+
+void ClockHealth_Init(bool isAutoRestore);
+Clock_Health_t ClockHealth_Check(void);
+Clock_Health_t ClockHealth_GetLast(void);
+void ClockHealth_GetStats(Clock_Health_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLOCK_HEALTH__H
@@ -0,0 +1,225 @@
+/**
+ * @file    clock_notify.c
+ * @brief   Clock-change notifier registry
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Entries are kept sorted by priority when registered so a notification is a
+ * plain walk over the table. Pre-change callbacks run in priority order
+ * (lowest value first) and post-change callbacks in reverse, so the driver
+ * that stopped first is restarted last.
+ *
+ * Register and unregister shift entries, so they are turned away while a
+ * walk runs. A callback may not change the table it is called from, and
+ * IsClockSwitchInProgress() alone does not cover that: a switch is back in
+ * IDLE before it calls the post-change callbacks.
+ *
+ * A walk may also interrupt a change, e.g. the health check from SysTick
+ * while thread mode registers a driver. So there are two tables: a change is
+ * made in the one that is not published and then published with one store,
+ * and a walk only ever sees a whole table.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "startup.h"
+#include "clock_notify.h"
+
+/**
+ * @brief One registered driver
+ */
+typedef struct
+{
+  Clock_Notify_Callback_t preChange;
+  Clock_Notify_Callback_t postChange;
+  void *context;
+  uint8_t priority;
+  int32_t handle;
+} Clock_Notify_Entry_t;
+
+/**
+ * @brief Registered drivers, sorted by priority
+ */
+typedef struct
+{
+  Clock_Notify_Entry_t entries[CLOCK_NOTIFY_MAX_ENTRIES];
+  uint32_t numEntries;
+} Clock_Notify_Table_t;
+
+static Clock_Notify_Table_t s_Tables[2];
+static atomic_uint_least32_t s_Published = 0U;    /*!< Index of the table the walks use          */
+static atomic_bool s_IsChanging = false;          /*!< A register or unregister is in progress   */
+static atomic_uint_least32_t s_WalkDepth = 0U;    /*!< Notifications running, nested ones included */
+static int32_t s_NextHandle = 0;
+
+/**
+ * @brief  Claims the registry for one change and stages a copy of the table
+ * @retval Table to change and publish with EndChange(), NULL if the table may
+ *         not be changed now
+ */
+static Clock_Notify_Table_t *BeginChange(void)
+{
+  if (atomic_exchange(&s_IsChanging, true))
+  {
+    return NULL;
+  }
+  if (IsClockSwitchInProgress() || (atomic_load(&s_WalkDepth) != 0U))
+  {
+    atomic_store(&s_IsChanging, false);
+    return NULL;
+  }
+
+  // No walk is running now, and any that starts uses the published table
+  uint32_t published = (uint32_t)atomic_load(&s_Published);
+  Clock_Notify_Table_t *staged = &s_Tables[published ^ 1U];
+  *staged = s_Tables[published];
+  return staged;
+}
+
+/**
+ * @brief  Publishes the staged table (if not NULL) and releases the registry
+ */
+static void EndChange(const Clock_Notify_Table_t *staged)
+{
+  if (staged != NULL)
+  {
+    atomic_store(&s_Published, (uint32_t)(staged - s_Tables));
+  }
+  atomic_store(&s_IsChanging, false);
+}
+
+/**
+ * @brief  Table for one notification; pair with LeaveWalk()
+ */
+static const Clock_Notify_Table_t *EnterWalk(void)
+{
+  (void)atomic_fetch_add(&s_WalkDepth, 1U);
+  return &s_Tables[atomic_load(&s_Published)];
+}
+
+static void LeaveWalk(void)
+{
+  (void)atomic_fetch_sub(&s_WalkDepth, 1U);
+}
+
+/**
+ * @brief  Registers a pair of clock-change callbacks
+ * @note   Not allowed while a clock switch is running, a notification is
+ *         walking the table (e.g. from a callback) or another context is
+ *         changing it.
+ * @param preChange Called before the clocks change (may be NULL)
+ * @param postChange Called once the switch has ended (may be NULL)
+ * @param priority Lower values are notified first before, and last after, the change
+ * @param context Passed back to both callbacks
+ * @retval Handle (>= 0) for ClockNotify_Unregister(), CLOCK_ERROR_INVALID_ARG
+ *         if both callbacks are NULL, CLOCK_ERROR_BUSY during a clock switch,
+ *         a notification or another change, or CLOCK_ERROR_REGISTRY_FULL if
+ *         all CLOCK_NOTIFY_MAX_ENTRIES are in use
+ */
+int32_t ClockNotify_Register(Clock_Notify_Callback_t preChange, Clock_Notify_Callback_t postChange,
+                             uint8_t priority, void *context)
+{
+  if ((preChange == NULL) && (postChange == NULL))
+  {
+    return CLOCK_ERROR_INVALID_ARG;
+  }
+  Clock_Notify_Table_t *table = BeginChange();
+  if (table == NULL)
+  {
+    return CLOCK_ERROR_BUSY;
+  }
+  if (table->numEntries >= CLOCK_NOTIFY_MAX_ENTRIES)
+  {
+    EndChange(NULL);
+    return CLOCK_ERROR_REGISTRY_FULL;
+  }
+
+  // Insert after any entry of the same priority to keep registration order
+  uint32_t index = table->numEntries;
+  while ((index > 0U) && (table->entries[index - 1U].priority > priority))
+  {
+    table->entries[index] = table->entries[index - 1U];
+    index--;
+  }
+
+  int32_t handle = s_NextHandle;
+  s_NextHandle = (s_NextHandle == INT32_MAX) ? 0 : (s_NextHandle + 1);
+
+  table->entries[index].preChange = preChange;
+  table->entries[index].postChange = postChange;
+  table->entries[index].context = context;
+  table->entries[index].priority = priority;
+  table->entries[index].handle = handle;
+  table->numEntries++;
+  EndChange(table);
+  return handle;
+}
+
+/**
+ * @brief  Removes callbacks added by ClockNotify_Register()
+ * @param handle Value returned by ClockNotify_Register()
+ * @retval CLOCK_OK, CLOCK_ERROR_INVALID_ARG for an unknown handle or
+ *         CLOCK_ERROR_BUSY during a clock switch, a notification or another
+ *         change
+ */
+int32_t ClockNotify_Unregister(int32_t handle)
+{
+  Clock_Notify_Table_t *table = BeginChange();
+  if (table == NULL)
+  {
+    return CLOCK_ERROR_BUSY;
+  }
+
+  for (uint32_t i = 0U; i < table->numEntries; i++)
+  {
+    if (table->entries[i].handle == handle)
+    {
+      for (uint32_t j = i + 1U; j < table->numEntries; j++)
+      {
+        table->entries[j - 1U] = table->entries[j];
+      }
+      table->numEntries--;
+      EndChange(table);
+      return CLOCK_OK;
+    }
+  }
+  EndChange(NULL);
+  return CLOCK_ERROR_INVALID_ARG;
+}
+
+/**
+ * @brief  Calls every pre-change callback, lowest priority value first
+ * @param info Current and requested clock frequencies
+ */
+void ClockNotify_PreChange(const Clock_Notify_Info_t *info)
+{
+  const Clock_Notify_Table_t *table = EnterWalk();
+  for (uint32_t i = 0U; i < table->numEntries; i++)
+  {
+    if (table->entries[i].preChange != NULL)
+    {
+      table->entries[i].preChange(info, table->entries[i].context);
+    }
+  }
+  LeaveWalk();
+}
+
+/**
+ * @brief  Calls every post-change callback, highest priority value first
+ * @param info Previous and resulting clock frequencies and the switch status
+ */
+void ClockNotify_PostChange(const Clock_Notify_Info_t *info)
+{
+  const Clock_Notify_Table_t *table = EnterWalk();
+  for (uint32_t i = table->numEntries; i > 0U; i--)
+  {
+    if (table->entries[i - 1U].postChange != NULL)
+    {
+      table->entries[i - 1U].postChange(info, table->entries[i - 1U].context);
+    }
+  }
+  LeaveWalk();
+}
@@ -0,0 +1,54 @@
+/**
+ * @file    clock_notify.h
+ * @brief   Clock-change notifier registry
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Peripheral drivers (USART, SPI, I2C, timers) register callbacks that the
+ * clock switch calls before the system/bus clock changes and after the new
+ * clock is in effect, e.g. to pause DMA and then recompute baud rate or
+ * prescaler values. The registry is a fixed-size table, nothing is allocated.
+ *
+ */
+
+#ifndef CLOCK_NOTIFY__H
+#define CLOCK_NOTIFY__H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CLOCK_NOTIFY_MAX_ENTRIES         8U    /*!< Registry capacity */
+
+/**
+ * @brief Clock frequencies around a change
+ */
+typedef struct {
+  uint32_t oldSysClockHz;   // System clock before the switch
+  uint32_t oldBusClockHz;   // Bus clock before the switch
+  uint32_t newSysClockHz;   // Requested (pre) or resulting (post) system clock
+  uint32_t newBusClockHz;   // Requested (pre) or resulting (post) bus clock
+  int32_t status;           // Post only: CLOCK_OK or the negative Clock_Status_t of the switch
+} Clock_Notify_Info_t;
+
+/**
+ * @brief Pre-change or post-change callback
+ * @note  Runs in the context that advances the clock switch (caller of
+ *        SetSystemAndBusClockConfig(), PollClockSwitch() or RCC_IRQHandler()).
+ */
+typedef void (*Clock_Notify_Callback_t)(const Clock_Notify_Info_t *info, void *context);
+
+int32_t ClockNotify_Register(Clock_Notify_Callback_t preChange, Clock_Notify_Callback_t postChange,
+                             uint8_t priority, void *context);
+int32_t ClockNotify_Unregister(int32_t handle);
+void ClockNotify_PreChange(const Clock_Notify_Info_t *info);
+void ClockNotify_PostChange(const Clock_Notify_Info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLOCK_NOTIFY__H
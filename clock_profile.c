@@ -0,0 +1,136 @@
+/**
+ * @file    clock_profile.c
+ * @brief   Optional timing of the clock bring-up phases
+ * @author  SMC
+ * @date    September 2025
+ *
+ * See clock_profile.h. Each mark closes the phase that started at the
+ * previous mark (or at ClockProfile_Start()), so the phases of one switch add
+ * up to its total time, including any time the caller spent between the
+ * split-phase Begin and Complete calls.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "clock_profile.h"
+
+#if (CLOCK_PROFILE_ENABLE == 1)
+
+#include "cycle_counter.h"
+
+/**
+ * @brief Running totals of one phase
+ */
+typedef struct
+{
+  uint32_t count;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint64_t sumCycles;
+} Clock_Profile_Totals_t;
+
+static Clock_Profile_Record_t s_Records[CLOCK_PROFILE_RING_SIZE];
+static uint32_t s_NumRecords = 0U;      /*!< Records written so far (wraps the ring) */
+static Clock_Profile_Totals_t s_Totals[CLOCK_PHASE_COUNT];
+static uint32_t s_LastMark = 0U;
+
+/**
+ * @brief  Marks the start of a clock switch
+ */
+void ClockProfile_Start(void)
+{
+  s_LastMark = CycleCounter_Now();
+}
+
+/**
+ * @brief  Ends a phase: records its duration since the previous mark
+ * @param phase Phase that just ended
+ */
+void ClockProfile_Mark(Clock_Phase_t phase)
+{
+  uint32_t now = CycleCounter_Now();
+  uint32_t cycles = now - s_LastMark;
+  s_LastMark = now;
+
+  if (phase >= CLOCK_PHASE_COUNT)
+  {
+    return;
+  }
+
+  Clock_Profile_Record_t *record = &s_Records[s_NumRecords % CLOCK_PROFILE_RING_SIZE];
+  record->timestamp = now;
+  record->cycles = cycles;
+  record->phase = phase;
+  s_NumRecords++;
+
+  Clock_Profile_Totals_t *totals = &s_Totals[phase];
+  if ((totals->count == 0U) || (cycles < totals->minCycles))
+  {
+    totals->minCycles = cycles;
+  }
+  if (cycles > totals->maxCycles)
+  {
+    totals->maxCycles = cycles;
+  }
+  totals->sumCycles += cycles;
+  totals->count++;
+}
+
+/**
+ * @brief  Clears the ring buffer and the statistics
+ */
+void ClockProfile_Reset(void)
+{
+  for (uint32_t phase = 0U; phase < (uint32_t)CLOCK_PHASE_COUNT; phase++)
+  {
+    s_Totals[phase].count = 0U;
+    s_Totals[phase].minCycles = 0U;
+    s_Totals[phase].maxCycles = 0U;
+    s_Totals[phase].sumCycles = 0U;
+  }
+  s_NumRecords = 0U;
+}
+
+/**
+ * @brief  Returns the running statistics of one phase
+ * @param phase Phase to query
+ * @param stats Filled in with count and min/max/mean cycles
+ * @retval false if the phase has not been recorded yet (or is invalid)
+ */
+bool ClockProfile_GetStats(Clock_Phase_t phase, Clock_Profile_Stats_t *stats)
+{
+  if ((phase >= CLOCK_PHASE_COUNT) || (stats == NULL) || (s_Totals[phase].count == 0U))
+  {
+    return false;
+  }
+
+  const Clock_Profile_Totals_t *totals = &s_Totals[phase];
+  stats->count = totals->count;
+  stats->minCycles = totals->minCycles;
+  stats->maxCycles = totals->maxCycles;
+  stats->meanCycles = (uint32_t)(totals->sumCycles / totals->count);
+  return true;
+}
+
+/**
+ * @brief  Copies the most recent phase records, oldest first
+ * @param records Destination
+ * @param maxRecords Capacity of records
+ * @retval Number of records copied (at most CLOCK_PROFILE_RING_SIZE)
+ */
+uint32_t ClockProfile_ReadRecords(Clock_Profile_Record_t *records, uint32_t maxRecords)
+{
+  uint32_t available = (s_NumRecords < CLOCK_PROFILE_RING_SIZE) ? s_NumRecords : CLOCK_PROFILE_RING_SIZE;
+  uint32_t count = (available < maxRecords) ? available : maxRecords;
+  uint32_t first = s_NumRecords - count;
+
+  for (uint32_t i = 0U; i < count; i++)
+  {
+    records[i] = s_Records[(first + i) % CLOCK_PROFILE_RING_SIZE];
+  }
+  return count;
+}
+
+#endif // if (CLOCK_PROFILE_ENABLE == 1)
@@ -0,0 +1,88 @@
+/**
+ * @file    clock_profile.h
+ * @brief   Optional timing of the clock bring-up phases
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Build with CLOCK_PROFILE_ENABLE = 1 to timestamp each phase of a clock
+ * switch (unlock, return to DEF_CLOCK, PLL lock, HSI/HSE ready, CLKSEL switch
+ * and relock) with the CPU cycle counter. The durations go into a small ring
+ * buffer and into running min/max/mean values per phase that firmware can
+ * read at any time, e.g. to report a slow oscillator from the field.
+ *
+ * With CLOCK_PROFILE_ENABLE = 0 (default) the hooks expand to nothing and no
+ * code or data is generated.
+ *
+ */
+
+#ifndef CLOCK_PROFILE__H
+#define CLOCK_PROFILE__H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CLOCK_PROFILE_ENABLE
+  #define CLOCK_PROFILE_ENABLE           0
+#endif
+
+#define CLOCK_PROFILE_RING_SIZE          32U   /*!< Phase records kept, power of two */
+
+/**
+ * @brief Phases of a full clock switch, in the order they happen
+ */
+typedef enum
+{
+  CLOCK_PHASE_UNLOCK = 0,       /*!< Unlock keys (and DEF_CLOCK request)           */
+  CLOCK_PHASE_DEF_CLOCK,        /*!< CLKSEL back on DEF_CLOCK                      */
+  CLOCK_PHASE_PLL_LOCK,         /*!< PLL configuration until PLL_RDY               */
+  CLOCK_PHASE_OSC_READY,        /*!< Remaining wait for HSIRDY/HSERDY              */
+  CLOCK_PHASE_CLKSEL,           /*!< DEF_CLOCK cleared until CLKSEL switched       */
+  CLOCK_PHASE_RELOCK,           /*!< RCC_LOCK written                              */
+  CLOCK_PHASE_COUNT
+} Clock_Phase_t;
+
+/**
+ * @brief One timed phase
+ */
+typedef struct
+{
+  uint32_t timestamp;       /*!< Cycle count at the end of the phase   */
+  uint32_t cycles;          /*!< Duration of the phase                 */
+  Clock_Phase_t phase;
+} Clock_Profile_Record_t;
+
+/**
+ * @brief Running statistics of one phase
+ */
+typedef struct
+{
+  uint32_t count;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint32_t meanCycles;
+} Clock_Profile_Stats_t;
+
+#if (CLOCK_PROFILE_ENABLE == 1)
+
+void ClockProfile_Start(void);
+void ClockProfile_Mark(Clock_Phase_t phase);
+void ClockProfile_Reset(void);
+bool ClockProfile_GetStats(Clock_Phase_t phase, Clock_Profile_Stats_t *stats);
+uint32_t ClockProfile_ReadRecords(Clock_Profile_Record_t *records, uint32_t maxRecords);
+
+  #define CLOCK_PROFILE_START()          ClockProfile_Start()
+  #define CLOCK_PROFILE_MARK(phase)      ClockProfile_Mark(phase)
+#else
+  #define CLOCK_PROFILE_START()          ((void)0)
+  #define CLOCK_PROFILE_MARK(phase)      ((void)0)
+#endif // if (CLOCK_PROFILE_ENABLE == 1)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLOCK_PROFILE__H
@@ -0,0 +1,307 @@
+/**
+ * @file    clock_restart.c
+ * @brief   Warm-restart fast path using the last known good clock configuration
+ * @author  SMC
+ * @date    September 2025
+ *
+ * See clock_restart.h. The record is refreshed by a post-change clock
+ * notifier, so runtime switches (power profiles, governor) keep it current.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "rcc_access.h"
+#include "rcc_txn.h"
+#include "rcc_owner.h"
+#include "clock_notify.h"
+#include "startup.h"
+#include "clock_restart.h"
+
+#define CLOCK_RESTART_MAGIC              0x524B4C43UL   /*!< "CLKR" read as little-endian */
+#define CLOCK_RESTART_NOTIFY_PRIORITY    128U           /*!< Middle of the range, 255 is left to usart_baud.c */
+
+// RCC_CR bits a recorded image may hold
+#define RECORD_CR_BITS                   (RCC_CR_HSION | RCC_CR_HSEON | RCC_CR_CLKSEL | RCC_CR_PLLON | \
+                                          RCC_CR_SYS_DIV | RCC_CR_BUS_DIV)
+
+/**
+ * @brief Last known good configuration, kept across warm resets
+ */
+typedef struct
+{
+  uint32_t magic;
+  uint32_t cr;              /*!< RCC_CR image: oscillator, CLKSEL, PLLON and dividers */
+  uint32_t pllcfgr;         /*!< RCC_PLLCFGR image                                    */
+  uint32_t checksum;        /*!< Checksum() of the fields above                       */
+} Clock_Restart_Record_t;
+
+#if (MOCK_REGISTERS == 1)
+static Clock_Restart_Record_t s_Record;
+#else
+static Clock_Restart_Record_t s_Record __attribute__((section(CLOCK_RESTART_SECTION)));
+#endif // if (MOCK_REGISTERS == 1)
+
+static Clock_Reset_Cause_t s_ResetCause = CLOCK_RESET_POWER_ON;
+static int32_t s_NotifyHandle = CLOCK_ERROR_NOT_STARTED;
+
+/**
+ * @brief  FNV-1a over the record fields, so stale or random RAM is rejected
+ */
+static uint32_t Checksum(const Clock_Restart_Record_t *record)
+{
+  const uint32_t words[] = { record->magic, record->cr, record->pllcfgr };
+  uint32_t hash = 2166136261UL;
+  for (uint32_t i = 0U; i < (sizeof(words) / sizeof(words[0])); i++)
+  {
+    for (uint32_t shift = 0U; shift < 32U; shift += 8U)
+    {
+      hash = (hash ^ ((words[i] >> shift) & 0xFFUL)) * 16777619UL;
+    }
+  }
+  return hash;
+}
+
+/**
+ * @brief  Turns the RCC_CSR flags into a reset cause
+ * @note   A watchdog or software reset also pulls NRST, so the pin flag is
+ *         only the cause when no other flag is set.
+ */
+static Clock_Reset_Cause_t DecodeResetCause(uint32_t csr)
+{
+  if ((csr & (RCC_CSR_PORRSTF | RCC_CSR_BORRSTF)) != 0U)
+  {
+    return CLOCK_RESET_POWER_ON;
+  }
+  if ((csr & RCC_CSR_WWDGRSTF) != 0U)
+  {
+    return CLOCK_RESET_WWDG;
+  }
+  if ((csr & RCC_CSR_IWDGRSTF) != 0U)
+  {
+    return CLOCK_RESET_IWDG;
+  }
+  if ((csr & RCC_CSR_SFTRSTF) != 0U)
+  {
+    return CLOCK_RESET_SOFTWARE;
+  }
+  if ((csr & RCC_CSR_LPWRRSTF) != 0U)
+  {
+    return CLOCK_RESET_LOW_POWER;
+  }
+  return ((csr & RCC_CSR_PINRSTF) != 0U) ? CLOCK_RESET_PIN : CLOCK_RESET_POWER_ON;
+}
+
+/**
+ * @brief  Clears the RCC_CSR reset flags so the next reset reports only its own
+ * @note   Left set if another context holds the RCC or a switch is running;
+ *         the next boot then sees more than one flag, and a power-on flag
+ *         still makes it cold.
+ */
+static void ClearResetFlags(uint32_t csr)
+{
+  uint32_t ownerId = RccOwner_GetContextId();
+  if (((csr & RCC_CSR_RESET_FLAGS) == 0U) || !RccOwner_TryAcquireIdle(ownerId))
+  {
+    return;
+  }
+
+  Rcc_Txn_t txn;
+  RccTxn_Begin(&txn);
+  RccTxn_Unlock(&txn);
+  RccTxn_Write(&txn, RCC_CSR_OFFSET, csr | RCC_CSR_RMVF);
+  RccTxn_Lock(&txn);
+  RccTxn_Commit(&txn);
+  (void)RccOwner_Release(ownerId);
+}
+
+/**
+ * @brief  Records the configuration the RCC runs after a successful switch
+ */
+static void OnClockPostChange(const Clock_Notify_Info_t *info, void *context)
+{
+  (void)context;
+  if (info->status != CLOCK_OK)
+  {
+    return;
+  }
+
+  uint32_t cr = RccRead(RCC_CR_OFFSET);
+  uint32_t clksel = cr & RCC_CR_CLKSEL;
+  if (((cr & (RCC_CR_DEF_CLOCK | RCC_CR_PLL_RDY)) != RCC_CR_PLL_RDY) ||
+      ((clksel != RCC_CR_CLKSEL_0) && (clksel != RCC_CR_CLKSEL_1)))
+  {
+    return;
+  }
+
+  Clock_Config_t config;
+  config.pllcfgr = RccRead(RCC_PLLCFGR_OFFSET) & (RCC_PLLCFGR_MUL | RCC_PLLCFGR_DIV);
+  config.crDividers = cr & (RCC_CR_SYS_DIV | RCC_CR_BUS_DIV);
+  config.isHsiClock = (clksel == RCC_CR_CLKSEL_0);
+  ClockRestart_Save(&config);
+}
+
+/**
+ * @brief  Brings up the clocks at boot, from the retained record after a warm reset
+ * @note   Call once, early, instead of SetClockConfig(). On a warm reset with
+ *         a valid record the recorded images are applied; if that fails, or
+ *         on a cold reset, coldConfig is. The configuration that ends up
+ *         running is recorded, and a post-change notifier keeps the record up
+ *         to date from then on.
+ * @param coldConfig Configuration for a cold start
+ * @param budgetCycles Cold start only: budget for SetClockConfigWithFallback(),
+ *        0 for SetClockConfig()
+ * @param isWarmStart Filled in with true if the record was used (may be NULL)
+ * @retval CLOCK_OK (0) on success, otherwise a negative Clock_Status_t
+ */
+int32_t ClockRestart_Boot(const Clock_Config_t *coldConfig, uint32_t budgetCycles, bool *isWarmStart)
+{
+  if (coldConfig == NULL)
+  {
+    return CLOCK_ERROR_INVALID_ARG;
+  }
+
+  uint32_t csr = RccRead(RCC_CSR_OFFSET);
+  s_ResetCause = DecodeResetCause(csr);
+
+  // Warm reset: straight to the recorded images. If the RCC still runs them,
+  // SetClockConfig() only reads RCC_CR and RCC_PLLCFGR.
+  Clock_Config_t config;
+  bool isWarm = false;
+  int32_t status = CLOCK_ERROR_NOT_STARTED;
+  if ((s_ResetCause != CLOCK_RESET_POWER_ON) && ClockRestart_Load(&config))
+  {
+    status = SetClockConfig(&config);
+    isWarm = (status == CLOCK_OK);
+  }
+
+  if (!isWarm)
+  {
+    config = *coldConfig;
+    if (budgetCycles != 0U)
+    {
+      status = SetClockConfigWithFallback(coldConfig, budgetCycles, &config.isHsiClock);
+    }
+    else
+    {
+      status = SetClockConfig(coldConfig);
+    }
+
+    if (status == CLOCK_OK)
+    {
+      ClockRestart_Save(&config);
+    }
+    else
+    {
+      ClockRestart_Invalidate();
+    }
+  }
+
+  ClearResetFlags(csr);
+  if (s_NotifyHandle < 0)
+  {
+    s_NotifyHandle = ClockNotify_Register(NULL, OnClockPostChange, CLOCK_RESTART_NOTIFY_PRIORITY, NULL);
+  }
+
+  if (isWarmStart != NULL)
+  {
+    *isWarmStart = isWarm;
+  }
+  return status;
+}
+
+/**
+ * @brief  Returns the reset cause ClockRestart_Boot() found
+ */
+Clock_Reset_Cause_t ClockRestart_GetResetCause(void)
+{
+  return s_ResetCause;
+}
+
+/**
+ * @brief  Records a configuration as the last known good one
+ * @param config Configuration the RCC runs
+ */
+void ClockRestart_Save(const Clock_Config_t *config)
+{
+  if (config == NULL)
+  {
+    return;
+  }
+
+  uint32_t source = config->isHsiClock ? (RCC_CR_HSION | RCC_CR_CLKSEL_0) : (RCC_CR_HSEON | RCC_CR_CLKSEL_1);
+  s_Record.magic = CLOCK_RESTART_MAGIC;
+  s_Record.cr = source | RCC_CR_PLLON | (config->crDividers & (RCC_CR_SYS_DIV | RCC_CR_BUS_DIV));
+  s_Record.pllcfgr = config->pllcfgr & (RCC_PLLCFGR_MUL | RCC_PLLCFGR_DIV);
+  s_Record.checksum = Checksum(&s_Record);
+}
+
+/**
+ * @brief  Reads the last known good configuration back
+ * @param config Filled in if the record is valid
+ * @retval true if the record is intact and describes a legal configuration
+ */
+bool ClockRestart_Load(Clock_Config_t *config)
+{
+  uint32_t cr = s_Record.cr;
+  uint32_t oscBits = cr & (RCC_CR_HSION | RCC_CR_HSEON);
+  uint32_t clksel = cr & RCC_CR_CLKSEL;
+  if ((config == NULL) || (s_Record.magic != CLOCK_RESTART_MAGIC) || (s_Record.checksum != Checksum(&s_Record)) ||
+      ((cr & ~RECORD_CR_BITS) != 0U) || ((s_Record.pllcfgr & ~(RCC_PLLCFGR_MUL | RCC_PLLCFGR_DIV)) != 0U) ||
+      !(((oscBits == RCC_CR_HSION) && (clksel == RCC_CR_CLKSEL_0)) ||
+        ((oscBits == RCC_CR_HSEON) && (clksel == RCC_CR_CLKSEL_1))))
+  {
+    return false;
+  }
+
+  Clock_Config_t loaded;
+  loaded.pllcfgr = s_Record.pllcfgr;
+  loaded.crDividers = cr & (RCC_CR_SYS_DIV | RCC_CR_BUS_DIV);
+  loaded.isHsiClock = (oscBits == RCC_CR_HSION);
+  if (GetClockConfigBusClockHz(&loaded) > CLOCK_MAX_BUS_CLOCK_HZ)
+  {
+    return false;
+  }
+  *config = loaded;
+  return true;
+}
+
+/**
+ * @brief  Forgets the record, so the next boot is cold (e.g. after a firmware
+ *         update that changes the clock plan)
+ */
+void ClockRestart_Invalidate(void)
+{
+  s_Record.magic = 0U;
+  s_Record.checksum = 0U;
+}
+
+#if (MOCK_REGISTERS == 1)
+/**
+ * @brief  Flips bits of the retained record, as decayed RAM or a stray write would
+ * @param word 0 = magic, 1 = RCC_CR image, 2 = RCC_PLLCFGR image, 3 = checksum
+ * @param flipMask Bits to invert
+ */
+void ClockRestart_CorruptRecord(uint32_t word, uint32_t flipMask)
+{
+  switch (word)
+  {
+    case 0U:
+      s_Record.magic ^= flipMask;
+      break;
+
+    case 1U:
+      s_Record.cr ^= flipMask;
+      break;
+
+    case 2U:
+      s_Record.pllcfgr ^= flipMask;
+      break;
+
+    default:
+      s_Record.checksum ^= flipMask;
+      break;
+  }
+}
+#endif // if (MOCK_REGISTERS == 1)
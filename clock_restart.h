@@ -0,0 +1,68 @@
+/**
+ * @file    clock_restart.h
+ * @brief   Warm-restart fast path using the last known good clock configuration
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Every successful clock switch of the RCC at RCC_BASE leaves its RCC_CR and
+ * RCC_PLLCFGR images, with a checksum, in a record in retained RAM. After a
+ * watchdog, software, pin or low-power reset ClockRestart_Boot() applies that
+ * record directly: no speed/divider validation, and no cycle budget spent on
+ * an oscillator that already failed before (the record holds the source the
+ * system actually ran from, e.g. HSI after a fallback from a dead crystal).
+ * If the reset left the RCC running the recorded configuration, nothing is
+ * written at all. After a power-on or brown-out reset, or when the record is
+ * missing or damaged, the cold configuration is applied as usual.
+ *
+ * The reset cause is read from RCC_CSR (bits as listed in rcc_access.h) and
+ * the flags are cleared, so the next reset reports only its own cause.
+ *
+ * The manual gives RCC_BDCR no bits that software may use for storage, so the
+ * record lives in a variable placed in CLOCK_RESTART_SECTION, which the linker
+ * script must keep out of the zero-init and copy-down ranges (.noinit by
+ * default). With MOCK_REGISTERS = 1 it is a plain variable, which survives
+ * RccSim_Reset() like RAM survives a warm reset.
+ *
+ */
+
+#ifndef CLOCK_RESTART__H
+#define CLOCK_RESTART__H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "startup.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CLOCK_RESTART_SECTION
+  #define CLOCK_RESTART_SECTION          ".noinit"   /*!< Retained RAM section of the record */
+#endif
+
+/**
+ * @brief What caused the last reset, from the RCC_CSR flags
+ */
+typedef enum {
+  CLOCK_RESET_POWER_ON = 0,     // Power-on or brown-out reset, or no flag set: RAM contents lost
+  CLOCK_RESET_PIN,              // NRST pin
+  CLOCK_RESET_SOFTWARE,         // Software reset (SYSRESETREQ)
+  CLOCK_RESET_IWDG,             // Independent watchdog
+  CLOCK_RESET_WWDG,             // Window watchdog
+  CLOCK_RESET_LOW_POWER,        // Low-power management reset
+} Clock_Reset_Cause_t;
+
+int32_t ClockRestart_Boot(const Clock_Config_t *coldConfig, uint32_t budgetCycles, bool *isWarmStart);
+Clock_Reset_Cause_t ClockRestart_GetResetCause(void);
+void ClockRestart_Save(const Clock_Config_t *config);
+bool ClockRestart_Load(Clock_Config_t *config);
+void ClockRestart_Invalidate(void);
+#if (MOCK_REGISTERS == 1)
+void ClockRestart_CorruptRecord(uint32_t word, uint32_t flipMask);
+#endif // if (MOCK_REGISTERS == 1)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLOCK_RESTART__H
@@ -0,0 +1,164 @@
+/**
+ * @file    clock_solver.c
+ * @brief   Hz-based clock configuration solver
+ * @author  SMC
+ * @date    September 2025
+ *
+ * The search is exhaustive: 8 MUL codes x 8 DIV codes x 4 SYS_DIV codes x
+ * 4 BUS_DIV codes, decoded exactly as the reference manual describes
+ * (unlisted codes act as 1 for the PLL and 0b11 as 4 for the dividers).
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "rcc_access.h"
+#include "clock_solver.h"
+
+#define PLLCFGR_NUM_CODES                8U    /*!< MUL and DIV are 3-bit fields      */
+#define CR_DIV_NUM_CODES                 4U    /*!< SYS_DIV and BUS_DIV are 2-bit fields */
+
+/**
+ * @brief  Frequency of the PLL output (before SYS_DIV) for a configuration
+ */
+static uint32_t GetPllOutputHz(const Clock_Config_t *config)
+{
+  Clock_Config_t pllOnly = *config;
+  pllOnly.crDividers = 0U;
+  return GetClockConfigSysClockHz(&pllOnly);
+}
+
+/**
+ * @brief  Finds the register images for a system clock given in Hz
+ * @note   Among all combinations that produce exactly sysClockHz, returns the
+ *         one with the highest bus clock not above maxBusClockHz (and never
+ *         above the 20MHz limit of the manual). Ties go to the lowest PLL
+ *         output, which also keeps the canonical encodings of
+ *         BuildClockConfig(). No register is touched.
+ * @param sysClockHz Desired system clock in Hz
+ * @param maxBusClockHz Highest acceptable bus clock in Hz (clamped to 20MHz)
+ * @param isHsiClock If true use the internal HSI clock, otherwise the external HSE clock
+ * @param config Filled in with the register images on success
+ * @retval CLOCK_OK, CLOCK_ERROR_INVALID_ARG for a zero argument,
+ *         CLOCK_ERROR_UNREACHABLE if no MUL/DIV/SYS_DIV gives sysClockHz exactly,
+ *         or CLOCK_ERROR_BUS_LIMIT if it is reachable but no BUS_DIV brings the
+ *         bus clock down to maxBusClockHz
+ */
+int32_t SolveClockConfig(uint32_t sysClockHz, uint32_t maxBusClockHz, bool isHsiClock, Clock_Config_t *config)
+{
+  if ((config == NULL) || (sysClockHz == 0U) || (maxBusClockHz == 0U))
+  {
+    return CLOCK_ERROR_INVALID_ARG;
+  }
+
+  if (maxBusClockHz > CLOCK_MAX_BUS_CLOCK_HZ)
+  {
+    maxBusClockHz = CLOCK_MAX_BUS_CLOCK_HZ;
+  }
+
+  bool isReachable = false;
+  bool isFound = false;
+  uint32_t bestBusHz = 0U;
+  uint32_t bestPllHz = 0U;
+  Clock_Config_t candidate = { .isHsiClock = isHsiClock };
+
+  for (uint32_t mul = 0U; mul < PLLCFGR_NUM_CODES; mul++)
+  {
+    for (uint32_t div = 0U; div < PLLCFGR_NUM_CODES; div++)
+    {
+      candidate.pllcfgr = (mul << RCC_PLLCFGR_MUL_Pos) | (div << RCC_PLLCFGR_DIV_Pos);
+      uint32_t pllHz = GetPllOutputHz(&candidate);
+
+      for (uint32_t sysDiv = 0U; sysDiv < CR_DIV_NUM_CODES; sysDiv++)
+      {
+        for (uint32_t busDiv = 0U; busDiv < CR_DIV_NUM_CODES; busDiv++)
+        {
+          candidate.crDividers = (sysDiv << RCC_CR_SYS_DIV_Pos) | (busDiv << RCC_CR_BUS_DIV_Pos);
+          if (GetClockConfigSysClockHz(&candidate) != sysClockHz)
+          {
+            continue;
+          }
+
+          isReachable = true;
+          uint32_t busHz = GetClockConfigBusClockHz(&candidate);
+          if (busHz > maxBusClockHz)
+          {
+            continue;
+          }
+
+          // Strictly better only, so aliased codes (e.g. BUS_DIV 0b11) never win
+          if (!isFound || (busHz > bestBusHz) || ((busHz == bestBusHz) && (pllHz < bestPllHz)))
+          {
+            *config = candidate;
+            bestBusHz = busHz;
+            bestPllHz = pllHz;
+            isFound = true;
+          }
+        }
+      }
+    }
+  }
+
+  if (!isReachable)
+  {
+    return CLOCK_ERROR_UNREACHABLE;
+  }
+  return isFound ? CLOCK_OK : CLOCK_ERROR_BUS_LIMIT;
+}
+
+/**
+ * @brief  Configures the system clock to a frequency given in Hz
+ * @note   SolveClockConfig() followed by SetClockConfig(), so the same minimal
+ *         transition rules apply.
+ * @param sysClockHz Desired system clock in Hz
+ * @param maxBusClockHz Highest acceptable bus clock in Hz (clamped to 20MHz)
+ * @param isHsiClock If true use the internal HSI clock, otherwise the external HSE clock
+ * @retval CLOCK_OK (0) on success, otherwise a negative Clock_Status_t
+ */
+int32_t SetSystemClockHz(uint32_t sysClockHz, uint32_t maxBusClockHz, bool isHsiClock)
+{
+  Clock_Config_t config;
+  int32_t status = SolveClockConfig(sysClockHz, maxBusClockHz, isHsiClock, &config);
+  if (status != CLOCK_OK)
+  {
+    return status;
+  }
+
+  return SetClockConfig(&config);
+}
+
+/**
+ * @brief  Moves a configuration onto another configuration's PLL setting
+ * @note   Succeeds if SYS_DIV alone can give the same system clock from the
+ *         anchor's PLL output on the same source. BUS_DIV is kept, so the bus
+ *         clock stays the same too. A switch between two configurations on
+ *         one PLL setting is then a divider-only RCC_CR store instead of a
+ *         trip through DEF_CLOCK.
+ * @param config Register images to move, unchanged if it cannot be moved
+ * @param anchor Register images whose PLL setting and source to use
+ * @retval true if config now uses the anchor's PLL setting
+ */
+bool ShareClockConfigPll(Clock_Config_t *config, const Clock_Config_t *anchor)
+{
+  static const uint32_t sysDivs[] = { 0U, RCC_CR_SYS_DIV_0, RCC_CR_SYS_DIV_1 };
+
+  if ((config == NULL) || (anchor == NULL) || (config->isHsiClock != anchor->isHsiClock))
+  {
+    return false;
+  }
+
+  uint32_t sysClockHz = GetClockConfigSysClockHz(config);
+  for (uint32_t i = 0U; i < (sizeof(sysDivs) / sizeof(sysDivs[0])); i++)
+  {
+    Clock_Config_t candidate = *config;
+    candidate.pllcfgr = anchor->pllcfgr;
+    candidate.crDividers = sysDivs[i] | (config->crDividers & RCC_CR_BUS_DIV);
+    if (GetClockConfigSysClockHz(&candidate) == sysClockHz)
+    {
+      *config = candidate;
+      return true;
+    }
+  }
+  return false;
+}
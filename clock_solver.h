@@ -0,0 +1,32 @@
+/**
+ * @file    clock_solver.h
+ * @brief   Hz-based clock configuration solver
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Finds the RCC_PLLCFGR MUL/DIV and RCC_CR SYS_DIV/BUS_DIV values that give a
+ * system clock in Hz, for targets the System_Clock_Speeds_t enum does not
+ * cover.
+ *
+ */
+
+#ifndef CLOCK_SOLVER__H
+#define CLOCK_SOLVER__H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "startup.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int32_t SolveClockConfig(uint32_t sysClockHz, uint32_t maxBusClockHz, bool isHsiClock, Clock_Config_t *config);
+int32_t SetSystemClockHz(uint32_t sysClockHz, uint32_t maxBusClockHz, bool isHsiClock);
+bool ShareClockConfigPll(Clock_Config_t *config, const Clock_Config_t *anchor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLOCK_SOLVER__H
@@ -0,0 +1,163 @@
+/**
+ * @file    cycle_counter.c
+ * @brief   CPU cycle counter and cycle-bounded register waits
+ * @author  SMC
+ * @date    September 2025
+ *
+ * See cycle_counter.h. The counter is 32 bits wide and wraps; all intervals
+ * are computed with unsigned subtraction, which is correct for waits shorter
+ * than 2^32 cycles.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "rcc_access.h"
+#include "cycle_counter.h"
+
+#if (MOCK_REGISTERS == 1)
+
+static uint32_t SimCycles(void)
+{
+  return (uint32_t)RccSim_GetCycles();
+}
+
+static CycleCounter_Source_t s_Source = SimCycles;
+
+#else
+
+// Cortex-M4 debug registers (ARMv7-M Architecture Reference Manual, C1.6 and C1.8)
+#define CORE_DEMCR                       (*(volatile uint32_t *)0xE000EDFCUL)
+#define CORE_DEMCR_TRCENA                (1UL << 24U)   /*!< Enables the DWT unit          */
+#define DWT_CTRL                         (*(volatile uint32_t *)0xE0001000UL)
+#define DWT_CTRL_CYCCNTENA               (1UL << 0U)    /*!< Enables CYCCNT                */
+#define DWT_CYCCNT                       (*(volatile uint32_t *)0xE0001004UL)
+
+#endif // if (MOCK_REGISTERS == 1)
+
+/**
+ * @brief  Starts the cycle counter if it is not already running
+ * @note   Cheap to call repeatedly; leaves a running counter untouched so a
+ *         debugger or profiler using it is not disturbed.
+ */
+void CycleCounter_Enable(void)
+{
+#if (MOCK_REGISTERS != 1)
+  if ((DWT_CTRL & DWT_CTRL_CYCCNTENA) == 0U)
+  {
+    CORE_DEMCR |= CORE_DEMCR_TRCENA;
+    DWT_CYCCNT = 0U;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+  }
+#endif // if (MOCK_REGISTERS != 1)
+}
+
+/**
+ * @brief  Returns the current CPU cycle count
+ */
+uint32_t CycleCounter_Now(void)
+{
+#if (MOCK_REGISTERS == 1)
+  return s_Source();
+#else
+  return DWT_CYCCNT;
+#endif // if (MOCK_REGISTERS == 1)
+}
+
+/**
+ * @brief  Returns the cycle count of the CPU driving an RCC
+ * @note   On target there is one CPU and this is CycleCounter_Now(). With
+ *         MOCK_REGISTERS = 1 every simulated RCC counts its own cycles, unless
+ *         a host source was set with CycleCounter_SetSource().
+ * @param rccBase RCC_BASE or a simulated RCC (RccSimInst_GetBase())
+ */
+uint32_t CycleCounter_NowAt(uintptr_t rccBase)
+{
+#if (MOCK_REGISTERS == 1)
+  if (s_Source == SimCycles)
+  {
+    return (uint32_t)RccSimInst_GetCycles(RccSimInst_FromBase(rccBase));
+  }
+  return s_Source();
+#else
+  (void)rccBase;
+  return DWT_CYCCNT;
+#endif // if (MOCK_REGISTERS == 1)
+}
+
+#if (MOCK_REGISTERS == 1)
+/**
+ * @brief  Replaces the host cycle source (NULL restores the RCC simulator's)
+ * @param source Function returning a free-running 32-bit cycle count
+ */
+void CycleCounter_SetSource(CycleCounter_Source_t source)
+{
+  s_Source = (source != NULL) ? source : SimCycles;
+}
+#endif // if (MOCK_REGISTERS == 1)
+
+/**
+ * @brief  Sets up a wait without touching the register
+ * @param wait Wait to set up
+ * @param offset RCC register offset from RCC_BASE
+ * @param mask Bits to check
+ * @param value Expected value of the masked bits
+ * @param startCycles CycleCounter_Now() right after the write that started the
+ *        hardware event (PLLON, HSION/HSEON, DEF_CLOCK, ...)
+ * @param timeoutCycles Manual limit for the event
+ */
+void CycleWait_Start(Cycle_Wait_t *wait, uint32_t offset, uint32_t mask, uint32_t value,
+                     uint32_t startCycles, uint32_t timeoutCycles)
+{
+  CycleWait_StartAt(wait, RCC_BASE, offset, mask, value, startCycles, timeoutCycles);
+}
+
+/**
+ * @brief  Sets up a wait on a register of the RCC at a given base address
+ * @param wait Wait to set up
+ * @param rccBase RCC_BASE or a simulated RCC (RccSimInst_GetBase())
+ * @param offset Register offset from rccBase
+ * @param mask Bits to check
+ * @param value Expected value of the masked bits
+ * @param startCycles CycleCounter_NowAt(rccBase) right after the write that
+ *        started the hardware event
+ * @param timeoutCycles Manual limit for the event
+ */
+void CycleWait_StartAt(Cycle_Wait_t *wait, uintptr_t rccBase, uint32_t offset, uint32_t mask, uint32_t value,
+                       uint32_t startCycles, uint32_t timeoutCycles)
+{
+  wait->rccBase = rccBase;
+  wait->offset = offset;
+  wait->mask = mask;
+  wait->value = value;
+  wait->startCycles = startCycles;
+  wait->timeoutCycles = timeoutCycles;
+  wait->elapsedCycles = 0U;
+}
+
+/**
+ * @brief  Checks a wait once
+ * @note   The time is taken before the register is read, so a timeout is only
+ *         reported if a read started at or after the limit still missed the
+ *         bits, i.e. the hardware really exceeded the limit.
+ * @param wait Wait set up by CycleWait_Start() or CycleWait_StartAt()
+ * @param regValue Filled in with the register value read (may be NULL)
+ * @retval CYCLE_WAIT_DONE, CYCLE_WAIT_PENDING or CYCLE_WAIT_TIMEOUT
+ */
+Cycle_Wait_Result_t CycleWait_Poll(Cycle_Wait_t *wait, uint32_t *regValue)
+{
+  uint32_t elapsed = CycleCounter_NowAt(wait->rccBase) - wait->startCycles;
+  uint32_t value = RccReadAt(wait->rccBase, wait->offset);
+  if (regValue != NULL)
+  {
+    *regValue = value;
+  }
+
+  wait->elapsedCycles = elapsed;
+  if ((value & wait->mask) == wait->value)
+  {
+    return CYCLE_WAIT_DONE;
+  }
+  return (elapsed >= wait->timeoutCycles) ? CYCLE_WAIT_TIMEOUT : CYCLE_WAIT_PENDING;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file    cycle_counter.h
+ * @brief   CPU cycle counter and cycle-bounded register waits
+ * @author  SMC
+ * @date    September 2025
+ *
+ * On target the counter is the Cortex-M4 DWT cycle counter (DWT_CYCCNT). With
+ * MOCK_REGISTERS = 1 it reads a pluggable host source, by default the virtual
+ * cycle counter of the RCC simulator. Each simulated RCC has its own counter,
+ * which CycleCounter_NowAt() and waits on that RCC read.
+ *
+ * Waits are measured from the CPU cycle their hardware event was started, so
+ * they end exactly at the limit given in the reference manual instead of after
+ * a number of loop iterations.
+ *
+ */
+
+#ifndef CYCLE_COUNTER__H
+#define CYCLE_COUNTER__H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Result of a cycle-bounded wait
+ */
+typedef enum
+{
+  CYCLE_WAIT_PENDING = 0,   /*!< Bits not there yet, limit not reached  */
+  CYCLE_WAIT_DONE,          /*!< Register shows the expected bits       */
+  CYCLE_WAIT_TIMEOUT,       /*!< Limit reached without the bits         */
+} Cycle_Wait_Result_t;
+
+/**
+ * @brief Wait for (RCC register & mask) == value within timeoutCycles
+ */
+typedef struct
+{
+  uintptr_t rccBase;        /*!< RCC the register belongs to                      */
+  uint32_t offset;          /*!< RCC register offset from rccBase                 */
+  uint32_t mask;
+  uint32_t value;
+  uint32_t startCycles;     /*!< Counter value when the hardware event started    */
+  uint32_t timeoutCycles;   /*!< Manual limit for the event                       */
+  uint32_t elapsedCycles;   /*!< Cycles from startCycles to the last check        */
+} Cycle_Wait_t;
+
+/**
+ * @brief Host stand-in for DWT_CYCCNT
+ */
+typedef uint32_t (*CycleCounter_Source_t)(void);
+
+void CycleCounter_Enable(void);
+uint32_t CycleCounter_Now(void);
+uint32_t CycleCounter_NowAt(uintptr_t rccBase);
+#if (MOCK_REGISTERS == 1)
+void CycleCounter_SetSource(CycleCounter_Source_t source);
+#endif // if (MOCK_REGISTERS == 1)
+
+void CycleWait_Start(Cycle_Wait_t *wait, uint32_t offset, uint32_t mask, uint32_t value,
+                     uint32_t startCycles, uint32_t timeoutCycles);
+void CycleWait_StartAt(Cycle_Wait_t *wait, uintptr_t rccBase, uint32_t offset, uint32_t mask, uint32_t value,
+                       uint32_t startCycles, uint32_t timeoutCycles);
+Cycle_Wait_Result_t CycleWait_Poll(Cycle_Wait_t *wait, uint32_t *regValue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CYCLE_COUNTER__H
@@ -0,0 +1,351 @@
+/**
+ * @file    fault_main.c
+ * @brief   Randomized fault-injection harness for the clock switch
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Property test of SetSystemAndBusClockConfig() against the RCC simulator.
+ * Every run starts from a random working configuration (or from reset),
+ * picks random PLL_RDY, HSIRDY, HSERDY and CLKSEL latencies within the limits
+ * of the reference manual, injects one fault and switches to a random
+ * configuration. The faults are: none, oscillator never ready, PLL never
+ * locks, CLKSEL never switches, the RCC locked again by a bad RCC_UNL/RCC_UNH
+ * write, and a fallback to DEF_CLOCK, the last two at a random cycle.
+ *
+ * Properties checked after every call:
+ *   - it returns within FAULT_BUDGET_CYCLES and no switch is left running
+ *   - without a fault it succeeds; with one it returns an error the fault
+ *     explains, or succeeds with the fault having had no effect
+ *   - the RCC is locked
+ *   - on success the RCC runs the requested configuration, and the cached
+ *     frequencies match the RCC, unless the fault struck during the final
+ *     RCC_LOCK write, after the driver had checked the switch
+ *   - once the fault is gone, the same request succeeds
+ *
+ * Usage: fault.out [--runs <n>] [--seed <n>] [--run <index>]
+ *   --run  Replays a single run of a failing sweep (same --seed).
+ *
+ * Build with MOCK_REGISTERS = 1, e.g.
+ *   clang -DMOCK_REGISTERS=1 startup.c clock_solver.c clock_notify.c clock_profile.c clock_fast_start.c clock_gate.c clock_governor.c clock_health.c clock_restart.c cycle_counter.c power_profile.c rcc_owner.c rcc_txn.c rcc_trace.c rcc_sim.c usart_baud.c fault_main.c -o fault.out
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "rcc_access.h"
+#include "startup.h"
+
+#define FAULT_DEFAULT_RUNS               1000000UL
+#define FAULT_DEFAULT_SEED               0x5EED5EEDUL
+
+// Longest legal switch: back to DEF_CLOCK, HSE start-up (the PLL locks in its
+// shadow) and the CLKSEL switch, plus the register accesses in between.
+#define FAULT_ACCESS_SLACK_CYCLES        64UL
+#define FAULT_BUDGET_CYCLES              (RCC_SIM_CLKSEL_MAX_CYCLES + RCC_SIM_HSERDY_MAX_CYCLES + \
+                                          RCC_SIM_CLKSEL_MAX_CYCLES + FAULT_ACCESS_SLACK_CYCLES)
+
+typedef enum
+{
+  FAULT_NONE = 0,
+  FAULT_OSC_NEVER_READY,
+  FAULT_PLL_NEVER_LOCKS,
+  FAULT_CLKSEL_STUCK,
+  FAULT_RELOCK,
+  FAULT_FALLBACK,
+  FAULT_COUNT
+} Fault_t;
+
+static const char *const s_FaultNames[FAULT_COUNT] =
+{
+  "none", "osc_never_ready", "pll_never_locks", "clksel_stuck", "relock", "fallback"
+};
+
+/**
+ * @brief One randomly chosen configuration
+ */
+typedef struct
+{
+  System_Clock_Speeds_t speed;
+  unsigned int busClockDivider;
+  bool isHsiClock;
+} Fault_Request_t;
+
+typedef struct
+{
+  uint32_t runs;
+  uint32_t errors;
+  uint64_t maxCycles;
+} Fault_Stats_t;
+
+static Fault_Stats_t s_Stats[FAULT_COUNT];
+static uint64_t s_Rng;
+static uint64_t s_FaultAt;          /*!< Cycle of the injected relock/fallback, UINT64_MAX if none */
+
+/**
+ * @brief  xorshift64* generator, reproducible across hosts
+ */
+static uint32_t Random(void)
+{
+  s_Rng ^= s_Rng >> 12;
+  s_Rng ^= s_Rng << 25;
+  s_Rng ^= s_Rng >> 27;
+  return (uint32_t)((s_Rng * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+/**
+ * @brief  Random value in [min, max]
+ */
+static uint32_t RandomRange(uint32_t min, uint32_t max)
+{
+  return min + (Random() % (max - min + 1U));
+}
+
+/**
+ * @brief  Picks a random request that passes BuildClockConfig()
+ */
+static Fault_Request_t RandomRequest(Clock_Config_t *config)
+{
+  static const unsigned int busClockDividers[] = { 0U, 2U, 4U };
+  Fault_Request_t request;
+  do
+  {
+    request.speed = (System_Clock_Speeds_t)RandomRange(1U, (uint32_t)SYS_CLOCK_SPEED_MAX_ENUM_VAL);
+    request.busClockDivider = busClockDividers[RandomRange(0U, 2U)];
+    request.isHsiClock = (RandomRange(0U, 1U) == 0U);
+  } while (BuildClockConfig(request.speed, request.busClockDivider, request.isHsiClock, config) != CLOCK_OK);
+  return request;
+}
+
+/**
+ * @brief  Checks the RCC runs the requested configuration
+ */
+static bool IsRunning(const Clock_Config_t *config)
+{
+  uint32_t cr = RccSim_Peek(RCC_CR_OFFSET);
+  uint32_t clksel = config->isHsiClock ? RCC_CR_CLKSEL_0 : RCC_CR_CLKSEL_1;
+  return ((cr & RCC_CR_CLKSEL) == clksel) && ((cr & RCC_CR_DEF_CLOCK) == 0U) &&
+         ((cr & RCC_CR_PLL_RDY) != 0U) &&
+         ((cr & (RCC_CR_SYS_DIV | RCC_CR_BUS_DIV)) == config->crDividers) &&
+         (RccSim_Peek(RCC_PLLCFGR_OFFSET) == config->pllcfgr);
+}
+
+/**
+ * @brief  Checks the cached frequencies against the simulated registers
+ */
+static bool IsCacheCoherent(void)
+{
+  // DEF_CLOCK set counts as DEF_CLOCK even while CLKSEL is still switching
+  uint32_t cr = RccSim_Peek(RCC_CR_OFFSET);
+  if (((cr & RCC_CR_CLKSEL) == 0U) || ((cr & RCC_CR_DEF_CLOCK) != 0U))
+  {
+    return (GetSystemClockHz() == CLOCK_DEF_CLOCK_HZ) && (GetBusClockHz() == CLOCK_DEF_CLOCK_HZ);
+  }
+
+  Clock_Config_t actual =
+  {
+    .pllcfgr = RccSim_Peek(RCC_PLLCFGR_OFFSET),
+    .crDividers = cr & (RCC_CR_SYS_DIV | RCC_CR_BUS_DIV),
+    .isHsiClock = ((cr & RCC_CR_CLKSEL) == RCC_CR_CLKSEL_0),
+  };
+  return (GetSystemClockHz() == GetClockConfigSysClockHz(&actual)) &&
+         (GetBusClockHz() == GetClockConfigBusClockHz(&actual));
+}
+
+/**
+ * @brief  Errors a fault can explain
+ */
+static bool IsExpectedError(Fault_t fault, int32_t result)
+{
+  switch (fault)
+  {
+    case FAULT_OSC_NEVER_READY:
+      return (result == CLOCK_ERROR_OSC_TIMEOUT);
+    case FAULT_PLL_NEVER_LOCKS:
+      return (result == CLOCK_ERROR_PLL_TIMEOUT);
+    case FAULT_CLKSEL_STUCK:
+      return (result == CLOCK_ERROR_CLKSEL_TIMEOUT);
+    case FAULT_RELOCK:
+    case FAULT_FALLBACK:
+      return (result < CLOCK_OK);
+    case FAULT_NONE:
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief  Checks whether the injected fault struck after the driver's last check
+ */
+static bool IsLateFault(void)
+{
+  return (s_FaultAt != UINT64_MAX) && (s_FaultAt > (RccSim_GetCycles() - RCC_SIM_ACCESS_CYCLES));
+}
+
+/**
+ * @brief  Calls SetSystemAndBusClockConfig() and checks the generic properties
+ * @retval Cycles taken, or UINT64_MAX if a property failed
+ */
+static uint64_t TimedSwitch(const Fault_Request_t *request, int32_t *result)
+{
+  uint64_t startCycles = RccSim_GetCycles();
+  *result = SetSystemAndBusClockConfig(request->speed, request->busClockDivider, request->isHsiClock);
+  uint64_t cycles = RccSim_GetCycles() - startCycles;
+
+  if ((cycles > FAULT_BUDGET_CYCLES) || IsClockSwitchInProgress() ||
+      ((RccSim_Peek(RCC_LOCK_OFFSET) & RCC_LOCK_LOCK_STATUS) == 0U) ||
+      (!IsCacheCoherent() && !IsLateFault()))
+  {
+    return UINT64_MAX;
+  }
+  return cycles;
+}
+
+/**
+ * @brief  Runs one randomized scenario
+ * @retval NULL if every property held, otherwise a description of the failure
+ */
+static const char *RunOne(uint64_t seed, uint32_t index, Fault_t *faultOut)
+{
+  s_Rng = (seed ^ ((uint64_t)index * 0x9E3779B97F4A7C15ULL)) | 1ULL;
+
+  RccSim_Timing_t timing;
+  RccSim_GetDefaultTiming(&timing);
+  timing.pllReadyCycles = RandomRange(1U, RCC_SIM_PLL_RDY_MAX_CYCLES);
+  timing.hsiReadyCycles = RandomRange(1U, RCC_SIM_HSIRDY_MAX_CYCLES);
+  timing.hseReadyCycles = RandomRange(1U, RCC_SIM_HSERDY_MAX_CYCLES);
+  timing.clkselSwitchCycles = RandomRange(1U, RCC_SIM_CLKSEL_MAX_CYCLES);
+  RccSim_Init(&timing);
+  SystemClockUpdate();
+  s_FaultAt = UINT64_MAX;
+
+  // Start from reset one time in four, otherwise from a working configuration
+  int32_t result = CLOCK_OK;
+  Clock_Config_t config;
+  if (RandomRange(0U, 3U) != 0U)
+  {
+    Fault_Request_t from = RandomRequest(&config);
+    if (TimedSwitch(&from, &result) == UINT64_MAX)
+    {
+      return "setup switch broke a property";
+    }
+    if (result != CLOCK_OK)
+    {
+      return "setup switch failed without a fault";
+    }
+  }
+
+  Fault_Request_t to = RandomRequest(&config);
+  Fault_t fault = (Fault_t)RandomRange(0U, (uint32_t)FAULT_COUNT - 1U);
+  *faultOut = fault;
+
+  RccSim_Timing_t faultTiming = timing;
+  switch (fault)
+  {
+    case FAULT_OSC_NEVER_READY:
+      faultTiming.hsiReadyCycles = RCC_SIM_NEVER;
+      faultTiming.hseReadyCycles = RCC_SIM_NEVER;
+      break;
+    case FAULT_PLL_NEVER_LOCKS:
+      faultTiming.pllReadyCycles = RCC_SIM_NEVER;
+      break;
+    case FAULT_CLKSEL_STUCK:
+      faultTiming.clkselSwitchCycles = RCC_SIM_NEVER;
+      break;
+    case FAULT_RELOCK:
+      s_FaultAt = RccSim_GetCycles() + RandomRange(0U, FAULT_BUDGET_CYCLES);
+      RccSim_InjectFault(RCC_SIM_FAULT_RELOCK, s_FaultAt);
+      break;
+    case FAULT_FALLBACK:
+      s_FaultAt = RccSim_GetCycles() + RandomRange(0U, FAULT_BUDGET_CYCLES);
+      RccSim_InjectFault(RCC_SIM_FAULT_FALLBACK, s_FaultAt);
+      break;
+    case FAULT_NONE:
+    default:
+      break;
+  }
+  RccSim_SetTiming(&faultTiming);
+
+  uint64_t cycles = TimedSwitch(&to, &result);
+  if (cycles == UINT64_MAX)
+  {
+    return "switch broke a property (budget, lock or cached clocks)";
+  }
+  if ((result == CLOCK_OK) && !IsRunning(&config) && !IsLateFault())
+  {
+    return "switch reported success but the RCC does not run the request";
+  }
+  if ((result != CLOCK_OK) && !IsExpectedError(fault, result))
+  {
+    return "switch returned an error the fault does not explain";
+  }
+
+  Fault_Stats_t *stats = &s_Stats[fault];
+  stats->runs++;
+  stats->errors += (result != CLOCK_OK) ? 1U : 0U;
+  stats->maxCycles = (cycles > stats->maxCycles) ? cycles : stats->maxCycles;
+
+  // Recovery: with the fault gone the same request has to work
+  RccSim_InjectFault(RCC_SIM_FAULT_NONE, 0U);
+  s_FaultAt = UINT64_MAX;
+  RccSim_SetTiming(&timing);
+  if (TimedSwitch(&to, &result) == UINT64_MAX)
+  {
+    return "recovery switch broke a property";
+  }
+  if ((result != CLOCK_OK) || !IsRunning(&config))
+  {
+    return "recovery switch failed";
+  }
+  return NULL;
+}
+
+int32_t main(int argc, char **argv)
+{
+  uint32_t runs = FAULT_DEFAULT_RUNS;
+  uint64_t seed = FAULT_DEFAULT_SEED;
+  uint32_t first = 0U;
+  for (int i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "--runs") == 0) && ((i + 1) < argc))
+    {
+      runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else if ((strcmp(argv[i], "--seed") == 0) && ((i + 1) < argc))
+    {
+      seed = strtoull(argv[++i], NULL, 0);
+    }
+    else if ((strcmp(argv[i], "--run") == 0) && ((i + 1) < argc))
+    {
+      first = (uint32_t)strtoul(argv[++i], NULL, 0);
+      runs = 1U;
+    }
+    else
+    {
+      fprintf(stderr, "Usage: %s [--runs <n>] [--seed <n>] [--run <index>]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  for (uint32_t i = first; i < (first + runs); i++)
+  {
+    Fault_t fault = FAULT_NONE;
+    const char *failure = RunOne(seed, i, &fault);
+    if (failure != NULL)
+    {
+      fprintf(stderr, "FAIL run %u (fault %s, seed 0x%llx): %s\n", i, s_FaultNames[fault],
+              (unsigned long long)seed, failure);
+      fprintf(stderr, "Replay with: --seed 0x%llx --run %u\n", (unsigned long long)seed, i);
+      return 1;
+    }
+  }
+
+  printf("fault,runs,errors,max_cycles (budget %lu)\n", (unsigned long)FAULT_BUDGET_CYCLES);
+  for (uint32_t fault = 0U; fault < (uint32_t)FAULT_COUNT; fault++)
+  {
+    printf("%s,%u,%u,%llu\n", s_FaultNames[fault], s_Stats[fault].runs, s_Stats[fault].errors,
+           (unsigned long long)s_Stats[fault].maxCycles);
+  }
+  return 0;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file    power_profile.c
+ * @brief   Named power/performance profiles
+ * @author  SMC
+ * @date    September 2025
+ *
+ * See power_profile.h. The clock part goes through SetClockConfig(), which
+ * already does the least work the difference needs (nothing, a divider-only
+ * store, or the full sequence through DEF_CLOCK).
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "rcc_access.h"
+#include "rcc_txn.h"
+#include "rcc_owner.h"
+#include "clock_solver.h"
+#include "power_profile.h"
+
+// Wake-up sources stay clocked in sleep in every profile
+#define WAKE_UP_PERIPHERALS              (CLOCK_PERIPH_SET(CLOCK_PERIPH_GPIOA) | CLOCK_PERIPH_SET(CLOCK_PERIPH_USART1) | \
+                                          CLOCK_PERIPH_SET(CLOCK_PERIPH_TIM2))
+#define ACTIVE_PERIPHERALS               (WAKE_UP_PERIPHERALS | CLOCK_PERIPH_SET(CLOCK_PERIPH_GPIOB) | \
+                                          CLOCK_PERIPH_SET(CLOCK_PERIPH_USART2) | CLOCK_PERIPH_SET(CLOCK_PERIPH_DMA1) | \
+                                          CLOCK_PERIPH_SET(CLOCK_PERIPH_DMA2))
+
+const Power_Profile_Def_t g_PowerProfileDefaults[POWER_PROFILE_DEFAULT_COUNT] =
+{
+  [POWER_PROFILE_BURST] = { "burst", SYS_CLOCK_SPEED_80M,   4U, true, ACTIVE_PERIPHERALS },
+  [POWER_PROFILE_RUN]   = { "run",   SYS_CLOCK_SPEED_40M,   2U, true, ACTIVE_PERIPHERALS },
+  [POWER_PROFILE_IDLE]  = { "idle",  SYS_CLOCK_SPEED_1_25M, 0U, true, WAKE_UP_PERIPHERALS },
+};
+
+static const uint32_t s_SleepOffsets[CLOCK_BUS_COUNT] =
+{
+  RCC_AHB1LPENR_OFFSET, RCC_AHB2LPENR_OFFSET, RCC_APB1LPENR_OFFSET, RCC_APB2LPENR_OFFSET
+};
+
+/**
+ * @brief Profile with its register images built
+ */
+typedef struct
+{
+  Clock_Config_t config;
+  uint32_t sleepMasks[CLOCK_BUS_COUNT];     /*!< RCC_xxxLPENR values, indexed by Clock_Bus_t */
+} Power_Profile_Entry_t;
+
+/**
+ * @brief Built profiles and what is in the RCC
+ */
+typedef struct
+{
+  Power_Profile_Entry_t entries[POWER_PROFILE_MAX_ENTRIES];
+  uint32_t count;
+  uint32_t active;                          /*!< Last applied profile or POWER_PROFILE_NONE  */
+  bool isSleepMaskKnown;                    /*!< sleepMasks holds the RCC_xxxLPENR values     */
+  uint32_t sleepMasks[CLOCK_BUS_COUNT];
+} Power_Profile_State_t;
+
+static Power_Profile_State_t s_Profiles = { .active = POWER_PROFILE_NONE };
+
+/**
+ * @brief  Checks and builds a set of profiles
+ * @note   Replaces any profiles built before. The first profile is the PLL
+ *         anchor: put the fastest one first so the slower ones can be reached
+ *         from it by SYS_DIV.
+ * @param defs Profiles, e.g. g_PowerProfileDefaults
+ * @param count Number of profiles (1 to POWER_PROFILE_MAX_ENTRIES)
+ * @retval CLOCK_OK, or the Clock_Status_t of the first profile that can't be built
+ */
+int32_t PowerProfile_Init(const Power_Profile_Def_t *defs, uint32_t count)
+{
+  if ((defs == NULL) || (count == 0U) || (count > POWER_PROFILE_MAX_ENTRIES))
+  {
+    return CLOCK_ERROR_INVALID_ARG;
+  }
+
+  Power_Profile_State_t built = { .count = count, .active = POWER_PROFILE_NONE };
+  for (uint32_t i = 0U; i < count; i++)
+  {
+    Power_Profile_Entry_t *entry = &built.entries[i];
+    int32_t status = BuildClockConfig(defs[i].sysClockSpeed, defs[i].busClockDivider, defs[i].isHsiClock,
+                                      &entry->config);
+    if (status == CLOCK_OK)
+    {
+      status = ClockGate_GetMasks(defs[i].sleepPeripherals, entry->sleepMasks);
+    }
+    if (status != CLOCK_OK)
+    {
+      return status;
+    }
+    if (i > 0U)
+    {
+      (void)ShareClockConfigPll(&entry->config, &built.entries[0].config);
+    }
+  }
+
+  s_Profiles = built;
+  return CLOCK_OK;
+}
+
+/**
+ * @brief  Writes the RCC_xxxLPENR registers that differ from the profile
+ * @note   Caller holds the RCC token.
+ */
+static void ApplySleepMasks(const uint32_t sleepMasks[CLOCK_BUS_COUNT])
+{
+  bool isChanged = false;
+  Rcc_Txn_t txn;
+  RccTxn_Begin(&txn);
+  for (uint32_t bus = 0U; bus < (uint32_t)CLOCK_BUS_COUNT; bus++)
+  {
+    if (!s_Profiles.isSleepMaskKnown || (s_Profiles.sleepMasks[bus] != sleepMasks[bus]))
+    {
+      RccTxn_Write(&txn, s_SleepOffsets[bus], sleepMasks[bus]);
+      s_Profiles.sleepMasks[bus] = sleepMasks[bus];
+      isChanged = true;
+    }
+  }
+  if (isChanged)
+  {
+    RccTxn_Unlock(&txn);
+    RccTxn_Lock(&txn);
+    RccTxn_Commit(&txn);
+  }
+  s_Profiles.isSleepMaskKnown = true;
+}
+
+/**
+ * @brief  Switches clocks and sleep-mode gating to a profile
+ * @note   Blocking. Takes the RCC token for the whole call, so the clock
+ *         switch and the RCC_xxxLPENR writes are not interleaved with other
+ *         RCC writers. Clock-change notifiers run as for any switch.
+ * @param index Profile index in the table given to PowerProfile_Init()
+ * @retval CLOCK_OK, CLOCK_ERROR_BUSY if the RCC is taken, otherwise the
+ *         negative Clock_Status_t of the clock switch (sleep masks unchanged)
+ */
+int32_t PowerProfile_Apply(uint32_t index)
+{
+  if (index >= s_Profiles.count)
+  {
+    return CLOCK_ERROR_INVALID_ARG;
+  }
+
+  uint32_t ownerId = RccOwner_GetContextId();
+  if (!RccOwner_TryAcquireIdle(ownerId))
+  {
+    return CLOCK_ERROR_BUSY;
+  }
+
+  const Power_Profile_Entry_t *entry = &s_Profiles.entries[index];
+  int32_t status = SetClockConfig(&entry->config);
+  if (status == CLOCK_OK)
+  {
+    ApplySleepMasks(entry->sleepMasks);
+    s_Profiles.active = index;
+  }
+  else if (status != CLOCK_ERROR_BUSY)
+  {
+    s_Profiles.active = POWER_PROFILE_NONE;
+  }
+
+  (void)RccOwner_Release(ownerId);
+  return status;
+}
+
+/**
+ * @brief  Returns the index of the profile last applied, or POWER_PROFILE_NONE
+ * @note   Clock changes made outside PowerProfile_Apply() are not tracked.
+ */
+uint32_t PowerProfile_GetActive(void)
+{
+  return s_Profiles.active;
+}
+
+/**
+ * @brief  Returns the register images a profile switches to
+ * @param index Profile index
+ * @param config Receives the images (possibly on the first profile's PLL setting)
+ * @retval CLOCK_OK, or CLOCK_ERROR_INVALID_ARG
+ */
+int32_t PowerProfile_GetConfig(uint32_t index, Clock_Config_t *config)
+{
+  if ((config == NULL) || (index >= s_Profiles.count))
+  {
+    return CLOCK_ERROR_INVALID_ARG;
+  }
+
+  *config = s_Profiles.entries[index].config;
+  return CLOCK_OK;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file    power_profile.h
+ * @brief   Named power/performance profiles
+ * @author  SMC
+ * @date    September 2025
+ *
+ * A profile combines a system clock speed, a bus divider, a clock source and
+ * the peripherals that keep their clock in sleep mode (RCC_xxxLPENR).
+ * PowerProfile_Apply() switches to a profile with a single call.
+ *
+ * PowerProfile_Init() checks and builds all register images up front. Where a
+ * profile's clocks can also be reached from the first profile's PLL setting
+ * by SYS_DIV alone, that PLL setting is used. Moving between such profiles
+ * is then a single RCC_CR store (divider-only switch) and not a trip through
+ * DEF_CLOCK. The sleep masks are only written when they change.
+ *
+ */
+
+#ifndef POWER_PROFILE__H
+#define POWER_PROFILE__H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "startup.h"
+#include "clock_gate.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POWER_PROFILE_MAX_ENTRIES        8U            /*!< Profiles PowerProfile_Init() accepts */
+#define POWER_PROFILE_NONE               0xFFFFFFFFUL  /*!< No profile applied yet               */
+
+/**
+ * @brief Profile as written by the application
+ */
+typedef struct {
+  const char *name;
+  System_Clock_Speeds_t sysClockSpeed;
+  unsigned int busClockDivider;             // 0/1, 2 or 4, see SetSystemAndBusClockConfig()
+  bool isHsiClock;
+  Clock_Peripheral_Set_t sleepPeripherals;  // Peripherals clocked in sleep mode, the rest are gated
+} Power_Profile_Def_t;
+
+/**
+ * @brief Indices of the default profiles in g_PowerProfileDefaults
+ */
+typedef enum {
+  POWER_PROFILE_BURST = 0,  // 80MHz, bus /4 (160MHz would exceed the 20MHz bus limit)
+  POWER_PROFILE_RUN,        // 40MHz, bus /2, divider-only from burst
+  POWER_PROFILE_IDLE,       // 1.25MHz, only the wake-up peripherals clocked in sleep
+  POWER_PROFILE_DEFAULT_COUNT,
+} Power_Profile_Default_t;
+
+extern const Power_Profile_Def_t g_PowerProfileDefaults[POWER_PROFILE_DEFAULT_COUNT];
+
+int32_t PowerProfile_Init(const Power_Profile_Def_t *defs, uint32_t count);
+int32_t PowerProfile_Apply(uint32_t index);
+uint32_t PowerProfile_GetActive(void);
+int32_t PowerProfile_GetConfig(uint32_t index, Clock_Config_t *config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POWER_PROFILE__H
@@ -0,0 +1,168 @@
+/**
+ * @file    rcc_access.h
+ * @brief   RCC register accessors
+ * @author  SMC
+ * @date    September 2025
+ *
+ * All RCC register traffic from the startup code goes through the accessors in
+ * this file. On target they compile down to single volatile loads and stores.
+ * When built with MOCK_REGISTERS = 1 they are routed into the behavioral RCC
+ * model in rcc_sim.c instead.
+ *
+ * RccReadAt()/RccWriteAt() take the base address of the RCC, so the same code
+ * can drive any number of simulated RCCs. RccRead()/RccWrite() use RCC_BASE.
+ * Built with RCC_TRACE_ENABLE = 1 they also feed the access trace
+ * (rcc_trace.h).
+ *
+ */
+
+#ifndef RCC_ACCESS__H
+#define RCC_ACCESS__H
+
+#include <stdint.h>
+
+// SMC_40CR.h instantiates static mock peripherals when MOCK_REGISTERS == 1.
+// Those are replaced by the simulator, so only the definitions are pulled in
+// here and the header stays safe to use from more than one translation unit.
+#if (MOCK_REGISTERS == 1)
+  #undef MOCK_REGISTERS
+  #include "SMC_40CR.h"
+  #define MOCK_REGISTERS 1
+  #include "rcc_sim.h"
+#else
+  #include "SMC_40CR.h"
+#endif // if (MOCK_REGISTERS == 1)
+#include "rcc_trace.h"
+#include "rcc_regs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief RCC register offsets from RCC_BASE (see RCC_TypeDef in SMC_40CR.h)
+ * @note  The registers the manual documents come from rcc_regs.h.
+ */
+#define RCC_CR_OFFSET                    RCC_REG_CR_OFFSET
+#define RCC_PLLCFGR_OFFSET               RCC_REG_PLLCFGR_OFFSET
+#define RCC_UNL_OFFSET                   RCC_REG_UNL_OFFSET   /*!< 16-bit, write only */
+#define RCC_UNH_OFFSET                   RCC_REG_UNH_OFFSET   /*!< 16-bit, write only */
+#define RCC_LOCK_OFFSET                  RCC_REG_LOCK_OFFSET
+#define RCC_AHB1RSTR_OFFSET              0x10UL
+#define RCC_AHB2RSTR_OFFSET              0x14UL
+#define RCC_APB1RSTR_OFFSET              0x20UL
+#define RCC_APB2RSTR_OFFSET              0x24UL
+#define RCC_AHB1ENR_OFFSET               0x30UL
+#define RCC_AHB2ENR_OFFSET               0x34UL
+#define RCC_APB1ENR_OFFSET               0x40UL
+#define RCC_APB2ENR_OFFSET               0x44UL
+#define RCC_AHB1LPENR_OFFSET             0x50UL
+#define RCC_AHB2LPENR_OFFSET             0x54UL
+#define RCC_APB1LPENR_OFFSET             0x60UL
+#define RCC_APB2LPENR_OFFSET             0x64UL
+#define RCC_BDCR_OFFSET                  0x70UL
+#define RCC_CSR_OFFSET                   0x74UL
+
+/**
+ * @brief Unlock keys, written to RCC_UNL then RCC_UNH (in that order)
+ */
+#define RCC_UNL_KEY                      0x56DDUL
+#define RCC_UNH_KEY                      0xA3B2UL
+
+/**
+ * @brief RCC_CSR reset flags
+ * @note  The manual lists RCC_CSR without its bits. These follow the STM32F4
+ *        layout, like the peripheral bits in clock_gate.h. The flags stay set
+ *        across resets until RMVF is written.
+ */
+#define RCC_CSR_RMVF                     (1UL << 24)   /*!< Write 1 to clear the flags below */
+#define RCC_CSR_BORRSTF                  (1UL << 25)   /*!< Brown-out reset                  */
+#define RCC_CSR_PINRSTF                  (1UL << 26)   /*!< NRST pin reset                   */
+#define RCC_CSR_PORRSTF                  (1UL << 27)   /*!< Power-on reset                   */
+#define RCC_CSR_SFTRSTF                  (1UL << 28)   /*!< Software reset                   */
+#define RCC_CSR_IWDGRSTF                 (1UL << 29)   /*!< Independent watchdog reset       */
+#define RCC_CSR_WWDGRSTF                 (1UL << 30)   /*!< Window watchdog reset            */
+#define RCC_CSR_LPWRRSTF                 (1UL << 31)   /*!< Low-power reset                  */
+#define RCC_CSR_RESET_FLAGS              (RCC_CSR_BORRSTF | RCC_CSR_PINRSTF | RCC_CSR_PORRSTF | RCC_CSR_SFTRSTF | \
+                                          RCC_CSR_IWDGRSTF | RCC_CSR_WWDGRSTF | RCC_CSR_LPWRRSTF)
+
+/**
+ * @brief  Reads a register of the RCC at a given base address
+ * @param rccBase RCC_BASE, or with MOCK_REGISTERS = 1 a simulated RCC
+ *        (RccSimInst_GetBase())
+ * @param offset Register offset from the base (RCC_xxx_OFFSET)
+ * @retval Register value
+ */
+static inline uint32_t RccReadAt(uintptr_t rccBase, uint32_t offset)
+{
+#if (MOCK_REGISTERS == 1)
+  uint32_t value = RccSimInst_Read(RccSimInst_FromBase(rccBase), offset);
+#else
+  uint32_t value = *(volatile uint32_t *)(rccBase + offset);
+#endif
+  RCC_TRACE_ACCESS(rccBase, offset, value, false);
+  return value;
+}
+
+/**
+ * @brief  Writes a register of the RCC at a given base address
+ * @note   RCC_UNL and RCC_UNH are 16-bit registers and are written as such.
+ * @param rccBase RCC_BASE, or with MOCK_REGISTERS = 1 a simulated RCC
+ *        (RccSimInst_GetBase())
+ * @param offset Register offset from the base (RCC_xxx_OFFSET)
+ * @param value Value to write
+ */
+static inline void RccWriteAt(uintptr_t rccBase, uint32_t offset, uint32_t value)
+{
+#if (MOCK_REGISTERS == 1)
+  RccSimInst_Write(RccSimInst_FromBase(rccBase), offset, value);
+#else
+  if ((offset == RCC_UNL_OFFSET) || (offset == RCC_UNH_OFFSET))
+  {
+    *(volatile uint16_t *)(rccBase + offset) = (uint16_t)value;
+  }
+  else
+  {
+    *(volatile uint32_t *)(rccBase + offset) = value;
+  }
+#endif
+  RCC_TRACE_ACCESS(rccBase, offset, value, true);
+}
+
+/**
+ * @brief  Reads an RCC register
+ * @param offset Register offset from RCC_BASE (RCC_xxx_OFFSET)
+ * @retval Register value
+ */
+static inline uint32_t RccRead(uint32_t offset)
+{
+  return RccReadAt(RCC_BASE, offset);
+}
+
+/**
+ * @brief  Writes an RCC register
+ * @note   RCC_UNL and RCC_UNH are 16-bit registers and are written as such.
+ * @param offset Register offset from RCC_BASE (RCC_xxx_OFFSET)
+ * @param value Value to write
+ */
+static inline void RccWrite(uint32_t offset, uint32_t value)
+{
+  RccWriteAt(RCC_BASE, offset, value);
+}
+
+/**
+ * @brief  Read-modify-write of an RCC register
+ * @param offset Register offset from RCC_BASE (RCC_xxx_OFFSET)
+ * @param clearMask Bits to clear
+ * @param setMask Bits to set (applied after clearMask)
+ */
+static inline void RccModify(uint32_t offset, uint32_t clearMask, uint32_t setMask)
+{
+  RccWrite(offset, (RccRead(offset) & ~clearMask) | setMask);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RCC_ACCESS__H
@@ -0,0 +1,167 @@
+/**
+ * @file    rcc_owner.c
+ * @brief   Ownership token for the RCC unlock/lock sequence
+ * @author  SMC
+ * @date    September 2025
+ *
+ * See rcc_owner.h. Only the owner changes the nesting depth, so the depth
+ * itself needs no read-modify-write atomics. The acquire/release ordering on
+ * the owner word makes the owner's RCC and driver state changes visible to the
+ * next owner.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "rcc_owner.h"
+#include "startup.h"
+
+#if (MOCK_REGISTERS == 1)
+
+static atomic_uint_least32_t s_NextThreadId = 1U;
+
+/**
+ * @brief  Gives every host thread its own owner id on first use
+ */
+static uint32_t DefaultContextId(void)
+{
+  static _Thread_local uint32_t threadId = RCC_OWNER_NONE;
+  if (threadId == RCC_OWNER_NONE)
+  {
+    threadId = (uint32_t)atomic_fetch_add(&s_NextThreadId, 1U);
+  }
+  return threadId;
+}
+
+#else
+
+// Cortex-M4 Interrupt Control and State Register (ARMv7-M Architecture Reference Manual, B3.2.4)
+#define SCB_ICSR                         (*(volatile uint32_t *)0xE000ED04UL)
+#define SCB_ICSR_VECTACTIVE              0x1FFUL   /*!< Active exception number, 0 = thread mode */
+
+/**
+ * @brief  Thread mode is owner 1, exception n is owner n + 1
+ */
+static uint32_t DefaultContextId(void)
+{
+  return (SCB_ICSR & SCB_ICSR_VECTACTIVE) + 1U;
+}
+
+#endif // if (MOCK_REGISTERS == 1)
+
+static RccOwner_Context_Source_t s_ContextSource = DefaultContextId;
+static atomic_uint_least32_t s_Owner = RCC_OWNER_NONE;
+static atomic_uint_least32_t s_Depth = 0U;
+
+/**
+ * @brief  Returns the owner id of the calling context
+ */
+uint32_t RccOwner_GetContextId(void)
+{
+  return s_ContextSource();
+}
+
+/**
+ * @brief  Replaces the calling-context id source (NULL restores the default)
+ * @note   Set once at start-up, before any context uses the token.
+ * @param source Function returning a non-zero id, unique per task/interrupt
+ */
+void RccOwner_SetContextSource(RccOwner_Context_Source_t source)
+{
+  s_ContextSource = (source != NULL) ? source : DefaultContextId;
+}
+
+/**
+ * @brief  Takes the token, or takes it once more if ownerId already holds it
+ * @note   Never waits. Safe from interrupts.
+ * @param ownerId Non-zero id of the caller, usually RccOwner_GetContextId()
+ * @retval true if ownerId now holds the token, false if another owner has it
+ */
+bool RccOwner_TryAcquire(uint32_t ownerId)
+{
+  if (ownerId == RCC_OWNER_NONE)
+  {
+    return false;
+  }
+
+  // Only ownerId itself can have stored ownerId, so this read cannot race
+  if ((uint32_t)atomic_load_explicit(&s_Owner, memory_order_relaxed) == ownerId)
+  {
+    atomic_store_explicit(&s_Depth, atomic_load_explicit(&s_Depth, memory_order_relaxed) + 1U,
+                          memory_order_relaxed);
+    return true;
+  }
+
+  uint_least32_t expected = RCC_OWNER_NONE;
+  if (!atomic_compare_exchange_strong_explicit(&s_Owner, &expected, ownerId,
+                                               memory_order_acquire, memory_order_relaxed))
+  {
+    return false;
+  }
+  atomic_store_explicit(&s_Depth, 1U, memory_order_relaxed);
+  return true;
+}
+
+/**
+ * @brief  Takes the token for an unlock/write/lock sequence of the caller's own
+ * @note   Fails while a clock switch runs, even one ownerId itself started:
+ *         it may be between its unlock keys and the lock, and a nested
+ *         sequence would lock the RCC under it or undo its oscillator
+ *         writes. Try again on the next poll.
+ * @param ownerId Non-zero id of the caller, usually RccOwner_GetContextId()
+ * @retval true if ownerId now holds the token and no switch is running
+ */
+bool RccOwner_TryAcquireIdle(uint32_t ownerId)
+{
+  if (!RccOwner_TryAcquire(ownerId))
+  {
+    return false;
+  }
+  if (IsClockSwitchInProgress())
+  {
+    (void)RccOwner_Release(ownerId);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief  Gives back one acquire; the token is free after the last one
+ * @param ownerId Id the token was acquired with
+ * @retval false if ownerId does not hold the token (nothing changed)
+ */
+bool RccOwner_Release(uint32_t ownerId)
+{
+  if ((ownerId == RCC_OWNER_NONE) ||
+      ((uint32_t)atomic_load_explicit(&s_Owner, memory_order_relaxed) != ownerId))
+  {
+    return false;
+  }
+
+  uint32_t depth = (uint32_t)atomic_load_explicit(&s_Depth, memory_order_relaxed) - 1U;
+  atomic_store_explicit(&s_Depth, depth, memory_order_relaxed);
+  if (depth == 0U)
+  {
+    atomic_store_explicit(&s_Owner, RCC_OWNER_NONE, memory_order_release);
+  }
+  return true;
+}
+
+/**
+ * @brief  Returns the id holding the token, or RCC_OWNER_NONE
+ */
+uint32_t RccOwner_GetOwner(void)
+{
+  return (uint32_t)atomic_load_explicit(&s_Owner, memory_order_acquire);
+}
+
+/**
+ * @brief  Returns how many times the owner has acquired the token
+ * @note   Only meaningful when called by the owner.
+ */
+uint32_t RccOwner_GetDepth(void)
+{
+  return (uint32_t)atomic_load_explicit(&s_Depth, memory_order_relaxed);
+}
@@ -0,0 +1,70 @@
+/**
+ * @file    rcc_owner.h
+ * @brief   Ownership token for the RCC unlock/lock sequence
+ * @author  SMC
+ * @date    September 2025
+ *
+ * The RCC is unlocked by writing RCC_UNL then RCC_UNH, and any other write in
+ * between locks it again. A task or interrupt that touches the RCC while a
+ * clock switch has it unlocked breaks the switch. Every RCC writer in this
+ * code therefore holds this token first, for as long as its sequence runs.
+ *
+ * The token is a C11 atomic compare-and-swap (LDREX/STREX on the Cortex-M4),
+ * so no interrupts are disabled while a switch waits thousands of cycles for
+ * the hardware. It is recursive: the owner may take it again, e.g. around a
+ * call into the clock driver, and it is free once every acquire is released.
+ * Nothing ever spins on it. A context that finds it taken gets false and
+ * retries later (the driver returns CLOCK_ERROR_BUSY).
+ *
+ * RCC_IRQHandler() is the one RCC writer that does not take the token. It
+ * only advances the switch in progress, on behalf of the context holding the
+ * token for it, and the driver's step guard lets one context at a time run a
+ * step of that switch. So while a switch holds the token, the RCC is written
+ * by the steps of that switch only, whichever context runs them; everything
+ * else is turned away.
+ *
+ * The nesting means the token alone does not keep the owner from breaking
+ * its own non-blocking switch: the governor, the health monitor and the
+ * fast start all poll from thread mode under one id. Code that writes the
+ * RCC itself (rather than through the driver) therefore takes the token with
+ * RccOwner_TryAcquireIdle(), which also turns it away while a switch runs.
+ *
+ * The owner is the calling context. On target that is the active exception
+ * number (thread mode and each interrupt are separate owners); with
+ * MOCK_REGISTERS = 1 each host thread is an owner. An RTOS port replaces this
+ * with RccOwner_SetContextSource() (e.g. returning the task handle), since all
+ * tasks share thread mode.
+ *
+ */
+
+#ifndef RCC_OWNER__H
+#define RCC_OWNER__H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RCC_OWNER_NONE                   0UL   /*!< Token owner when it is free */
+
+/**
+ * @brief Returns a non-zero id for the calling context
+ */
+typedef uint32_t (*RccOwner_Context_Source_t)(void);
+
+uint32_t RccOwner_GetContextId(void);
+void RccOwner_SetContextSource(RccOwner_Context_Source_t source);
+
+bool RccOwner_TryAcquire(uint32_t ownerId);
+bool RccOwner_TryAcquireIdle(uint32_t ownerId);
+bool RccOwner_Release(uint32_t ownerId);
+uint32_t RccOwner_GetOwner(void);
+uint32_t RccOwner_GetDepth(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RCC_OWNER__H
@@ -0,0 +1,406 @@
+/**
+ * @file    rcc_regs.h
+ * @brief   RCC register fields, reset values, timing limits and typed accessors
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Generated by reggen.c from SMC_40CR_ReferenceManual.md. Do not edit, run
+ *   reggen SMC_40CR_ReferenceManual.md rcc_regs.h
+ * instead. See reggen.c for what is generated.
+ *
+ */
+
+#ifndef RCC_REGS__H
+#define RCC_REGS__H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* RCC_CR -------------------------------------------------------------- */
+#define RCC_REG_CR_OFFSET                        0x00UL
+#define RCC_REG_CR_RESET                         0x80000300UL
+#define RCC_REG_CR_READ_MASK                     0x80000FFFUL
+#define RCC_REG_CR_WRITE_MASK                    0x800007C5UL
+#define RCC_REG_CR_DEF_CLOCK_POS                 31UL           /*!< RW, 1 bit */
+#define RCC_REG_CR_DEF_CLOCK_MSK                 0x80000000UL
+#define RCC_REG_CR_DEF_CLOCK_RESET               1UL
+#define RCC_REG_CR_PLL_RDY_POS                   11UL           /*!< R, 1 bit */
+#define RCC_REG_CR_PLL_RDY_MSK                   0x00000800UL
+#define RCC_REG_CR_PLL_RDY_RESET                 0UL
+#define RCC_REG_CR_PLL_RDY_MAX_CYCLES            350UL          /*!< CPU cycles */
+#define RCC_REG_CR_SYS_DIV_POS                   9UL            /*!< RW, 2 bits */
+#define RCC_REG_CR_SYS_DIV_MSK                   0x00000600UL
+#define RCC_REG_CR_SYS_DIV_RESET                 1UL
+#define RCC_REG_CR_BUS_DIV_POS                   7UL            /*!< RW, 2 bits */
+#define RCC_REG_CR_BUS_DIV_MSK                   0x00000180UL
+#define RCC_REG_CR_BUS_DIV_RESET                 2UL
+#define RCC_REG_CR_PLLON_POS                     6UL            /*!< RW, 1 bit */
+#define RCC_REG_CR_PLLON_MSK                     0x00000040UL
+#define RCC_REG_CR_PLLON_RESET                   0UL
+#define RCC_REG_CR_CLKSEL_POS                    4UL            /*!< R, 2 bits */
+#define RCC_REG_CR_CLKSEL_MSK                    0x00000030UL
+#define RCC_REG_CR_CLKSEL_RESET                  0UL
+#define RCC_REG_CR_CLKSEL_MAX_CYCLES             500UL          /*!< CPU cycles */
+#define RCC_REG_CR_HSERDY_POS                    3UL            /*!< R, 1 bit */
+#define RCC_REG_CR_HSERDY_MSK                    0x00000008UL
+#define RCC_REG_CR_HSERDY_RESET                  0UL
+#define RCC_REG_CR_HSERDY_MAX_CYCLES             4200UL         /*!< CPU cycles */
+#define RCC_REG_CR_HSEON_POS                     2UL            /*!< RW, 1 bit */
+#define RCC_REG_CR_HSEON_MSK                     0x00000004UL
+#define RCC_REG_CR_HSEON_RESET                   0UL
+#define RCC_REG_CR_HSIRDY_POS                    1UL            /*!< R, 1 bit */
+#define RCC_REG_CR_HSIRDY_MSK                    0x00000002UL
+#define RCC_REG_CR_HSIRDY_RESET                  0UL
+#define RCC_REG_CR_HSIRDY_MAX_CYCLES             1400UL         /*!< CPU cycles */
+#define RCC_REG_CR_HSION_POS                     0UL            /*!< RW, 1 bit */
+#define RCC_REG_CR_HSION_MSK                     0x00000001UL
+#define RCC_REG_CR_HSION_RESET                   0UL
+
+/**
+ * @brief RCC_CR value, only changed through the accessors below
+ */
+typedef struct {
+  uint32_t value;
+} Rcc_Cr_t;
+
+static inline Rcc_Cr_t RccCr_Reset(void)
+{
+  Rcc_Cr_t reg = { RCC_REG_CR_RESET };
+  return reg;
+}
+
+static inline Rcc_Cr_t RccCr_Clear(void)
+{
+  Rcc_Cr_t reg = { 0UL };
+  return reg;
+}
+
+static inline Rcc_Cr_t RccCr_FromRead(uint32_t value)
+{
+  Rcc_Cr_t reg = { value };
+  return reg;
+}
+
+static inline uint32_t RccCr_ToWrite(Rcc_Cr_t reg)
+{
+  return reg.value;
+}
+
+static inline bool RccCr_GetDefClock(Rcc_Cr_t reg)
+{
+  return ((reg.value & RCC_REG_CR_DEF_CLOCK_MSK) != 0UL);
+}
+
+static inline Rcc_Cr_t RccCr_SetDefClock(Rcc_Cr_t reg, bool value)
+{
+  reg.value = (reg.value & ~RCC_REG_CR_DEF_CLOCK_MSK) |
+              (((uint32_t)value << RCC_REG_CR_DEF_CLOCK_POS) & RCC_REG_CR_DEF_CLOCK_MSK);
+  return reg;
+}
+
+static inline bool RccCr_GetPllRdy(Rcc_Cr_t reg)
+{
+  return ((reg.value & RCC_REG_CR_PLL_RDY_MSK) != 0UL);
+}
+
+static inline uint32_t RccCr_GetSysDiv(Rcc_Cr_t reg)
+{
+  return (reg.value & RCC_REG_CR_SYS_DIV_MSK) >> RCC_REG_CR_SYS_DIV_POS;
+}
+
+static inline Rcc_Cr_t RccCr_SetSysDiv(Rcc_Cr_t reg, uint32_t value)
+{
+  reg.value = (reg.value & ~RCC_REG_CR_SYS_DIV_MSK) |
+              (((uint32_t)value << RCC_REG_CR_SYS_DIV_POS) & RCC_REG_CR_SYS_DIV_MSK);
+  return reg;
+}
+
+static inline uint32_t RccCr_GetBusDiv(Rcc_Cr_t reg)
+{
+  return (reg.value & RCC_REG_CR_BUS_DIV_MSK) >> RCC_REG_CR_BUS_DIV_POS;
+}
+
+static inline Rcc_Cr_t RccCr_SetBusDiv(Rcc_Cr_t reg, uint32_t value)
+{
+  reg.value = (reg.value & ~RCC_REG_CR_BUS_DIV_MSK) |
+              (((uint32_t)value << RCC_REG_CR_BUS_DIV_POS) & RCC_REG_CR_BUS_DIV_MSK);
+  return reg;
+}
+
+static inline bool RccCr_GetPllon(Rcc_Cr_t reg)
+{
+  return ((reg.value & RCC_REG_CR_PLLON_MSK) != 0UL);
+}
+
+static inline Rcc_Cr_t RccCr_SetPllon(Rcc_Cr_t reg, bool value)
+{
+  reg.value = (reg.value & ~RCC_REG_CR_PLLON_MSK) |
+              (((uint32_t)value << RCC_REG_CR_PLLON_POS) & RCC_REG_CR_PLLON_MSK);
+  return reg;
+}
+
+static inline uint32_t RccCr_GetClksel(Rcc_Cr_t reg)
+{
+  return (reg.value & RCC_REG_CR_CLKSEL_MSK) >> RCC_REG_CR_CLKSEL_POS;
+}
+
+static inline bool RccCr_GetHserdy(Rcc_Cr_t reg)
+{
+  return ((reg.value & RCC_REG_CR_HSERDY_MSK) != 0UL);
+}
+
+static inline bool RccCr_GetHseon(Rcc_Cr_t reg)
+{
+  return ((reg.value & RCC_REG_CR_HSEON_MSK) != 0UL);
+}
+
+static inline Rcc_Cr_t RccCr_SetHseon(Rcc_Cr_t reg, bool value)
+{
+  reg.value = (reg.value & ~RCC_REG_CR_HSEON_MSK) |
+              (((uint32_t)value << RCC_REG_CR_HSEON_POS) & RCC_REG_CR_HSEON_MSK);
+  return reg;
+}
+
+static inline bool RccCr_GetHsirdy(Rcc_Cr_t reg)
+{
+  return ((reg.value & RCC_REG_CR_HSIRDY_MSK) != 0UL);
+}
+
+static inline bool RccCr_GetHsion(Rcc_Cr_t reg)
+{
+  return ((reg.value & RCC_REG_CR_HSION_MSK) != 0UL);
+}
+
+static inline Rcc_Cr_t RccCr_SetHsion(Rcc_Cr_t reg, bool value)
+{
+  reg.value = (reg.value & ~RCC_REG_CR_HSION_MSK) |
+              (((uint32_t)value << RCC_REG_CR_HSION_POS) & RCC_REG_CR_HSION_MSK);
+  return reg;
+}
+
+/* RCC_PLLCFGR -------------------------------------------------------------- */
+#define RCC_REG_PLLCFGR_OFFSET                   0x04UL
+#define RCC_REG_PLLCFGR_RESET                    0x00000000UL
+#define RCC_REG_PLLCFGR_READ_MASK                0x0000003FUL
+#define RCC_REG_PLLCFGR_WRITE_MASK               0x0000003FUL
+#define RCC_REG_PLLCFGR_MUL_POS                  3UL            /*!< RW, 3 bits */
+#define RCC_REG_PLLCFGR_MUL_MSK                  0x00000038UL
+#define RCC_REG_PLLCFGR_MUL_RESET                0UL
+#define RCC_REG_PLLCFGR_DIV_POS                  0UL            /*!< RW, 3 bits */
+#define RCC_REG_PLLCFGR_DIV_MSK                  0x00000007UL
+#define RCC_REG_PLLCFGR_DIV_RESET                0UL
+
+/**
+ * @brief RCC_PLLCFGR value, only changed through the accessors below
+ */
+typedef struct {
+  uint32_t value;
+} Rcc_Pllcfgr_t;
+
+static inline Rcc_Pllcfgr_t RccPllcfgr_Reset(void)
+{
+  Rcc_Pllcfgr_t reg = { RCC_REG_PLLCFGR_RESET };
+  return reg;
+}
+
+static inline Rcc_Pllcfgr_t RccPllcfgr_Clear(void)
+{
+  Rcc_Pllcfgr_t reg = { 0UL };
+  return reg;
+}
+
+static inline Rcc_Pllcfgr_t RccPllcfgr_FromRead(uint32_t value)
+{
+  Rcc_Pllcfgr_t reg = { value };
+  return reg;
+}
+
+static inline uint32_t RccPllcfgr_ToWrite(Rcc_Pllcfgr_t reg)
+{
+  return reg.value;
+}
+
+static inline uint32_t RccPllcfgr_GetMul(Rcc_Pllcfgr_t reg)
+{
+  return (reg.value & RCC_REG_PLLCFGR_MUL_MSK) >> RCC_REG_PLLCFGR_MUL_POS;
+}
+
+static inline Rcc_Pllcfgr_t RccPllcfgr_SetMul(Rcc_Pllcfgr_t reg, uint32_t value)
+{
+  reg.value = (reg.value & ~RCC_REG_PLLCFGR_MUL_MSK) |
+              (((uint32_t)value << RCC_REG_PLLCFGR_MUL_POS) & RCC_REG_PLLCFGR_MUL_MSK);
+  return reg;
+}
+
+static inline uint32_t RccPllcfgr_GetDiv(Rcc_Pllcfgr_t reg)
+{
+  return (reg.value & RCC_REG_PLLCFGR_DIV_MSK) >> RCC_REG_PLLCFGR_DIV_POS;
+}
+
+static inline Rcc_Pllcfgr_t RccPllcfgr_SetDiv(Rcc_Pllcfgr_t reg, uint32_t value)
+{
+  reg.value = (reg.value & ~RCC_REG_PLLCFGR_DIV_MSK) |
+              (((uint32_t)value << RCC_REG_PLLCFGR_DIV_POS) & RCC_REG_PLLCFGR_DIV_MSK);
+  return reg;
+}
+
+/* RCC_UNL -------------------------------------------------------------- */
+#define RCC_REG_UNL_OFFSET                       0x08UL
+#define RCC_REG_UNL_RESET                        0x00000000UL
+#define RCC_REG_UNL_READ_MASK                    0x00000000UL
+#define RCC_REG_UNL_WRITE_MASK                   0x0000FFFFUL
+#define RCC_REG_UNL_UNLOCK_POS                   0UL            /*!< W, 16 bits */
+#define RCC_REG_UNL_UNLOCK_MSK                   0x0000FFFFUL
+#define RCC_REG_UNL_UNLOCK_RESET                 0UL
+
+/**
+ * @brief RCC_UNL value, only changed through the accessors below
+ */
+typedef struct {
+  uint32_t value;
+} Rcc_Unl_t;
+
+static inline Rcc_Unl_t RccUnl_Reset(void)
+{
+  Rcc_Unl_t reg = { RCC_REG_UNL_RESET };
+  return reg;
+}
+
+static inline Rcc_Unl_t RccUnl_Clear(void)
+{
+  Rcc_Unl_t reg = { 0UL };
+  return reg;
+}
+
+static inline uint32_t RccUnl_ToWrite(Rcc_Unl_t reg)
+{
+  return reg.value;
+}
+
+static inline Rcc_Unl_t RccUnl_SetUnlock(Rcc_Unl_t reg, uint32_t value)
+{
+  reg.value = (reg.value & ~RCC_REG_UNL_UNLOCK_MSK) |
+              (((uint32_t)value << RCC_REG_UNL_UNLOCK_POS) & RCC_REG_UNL_UNLOCK_MSK);
+  return reg;
+}
+
+/* RCC_UNH -------------------------------------------------------------- */
+#define RCC_REG_UNH_OFFSET                       0x0AUL
+#define RCC_REG_UNH_RESET                        0x00000000UL
+#define RCC_REG_UNH_READ_MASK                    0x00000000UL
+#define RCC_REG_UNH_WRITE_MASK                   0x0000FFFFUL
+#define RCC_REG_UNH_UNLOCK_POS                   0UL            /*!< W, 16 bits */
+#define RCC_REG_UNH_UNLOCK_MSK                   0x0000FFFFUL
+#define RCC_REG_UNH_UNLOCK_RESET                 0UL
+
+/**
+ * @brief RCC_UNH value, only changed through the accessors below
+ */
+typedef struct {
+  uint32_t value;
+} Rcc_Unh_t;
+
+static inline Rcc_Unh_t RccUnh_Reset(void)
+{
+  Rcc_Unh_t reg = { RCC_REG_UNH_RESET };
+  return reg;
+}
+
+static inline Rcc_Unh_t RccUnh_Clear(void)
+{
+  Rcc_Unh_t reg = { 0UL };
+  return reg;
+}
+
+static inline uint32_t RccUnh_ToWrite(Rcc_Unh_t reg)
+{
+  return reg.value;
+}
+
+static inline Rcc_Unh_t RccUnh_SetUnlock(Rcc_Unh_t reg, uint32_t value)
+{
+  reg.value = (reg.value & ~RCC_REG_UNH_UNLOCK_MSK) |
+              (((uint32_t)value << RCC_REG_UNH_UNLOCK_POS) & RCC_REG_UNH_UNLOCK_MSK);
+  return reg;
+}
+
+/* RCC_LOCK -------------------------------------------------------------- */
+#define RCC_REG_LOCK_OFFSET                      0x0CUL
+#define RCC_REG_LOCK_RESET                       0x00000002UL
+#define RCC_REG_LOCK_READ_MASK                   0x00000002UL
+#define RCC_REG_LOCK_WRITE_MASK                  0x00000001UL
+#define RCC_REG_LOCK_LOCK_STATUS_POS             1UL            /*!< R, 1 bit */
+#define RCC_REG_LOCK_LOCK_STATUS_MSK             0x00000002UL
+#define RCC_REG_LOCK_LOCK_STATUS_RESET           1UL
+#define RCC_REG_LOCK_LOCK_POS                    0UL            /*!< W, 1 bit */
+#define RCC_REG_LOCK_LOCK_MSK                    0x00000001UL
+#define RCC_REG_LOCK_LOCK_RESET                  0UL
+
+/**
+ * @brief RCC_LOCK value, only changed through the accessors below
+ */
+typedef struct {
+  uint32_t value;
+} Rcc_Lock_t;
+
+static inline Rcc_Lock_t RccLock_Reset(void)
+{
+  Rcc_Lock_t reg = { RCC_REG_LOCK_RESET };
+  return reg;
+}
+
+static inline Rcc_Lock_t RccLock_Clear(void)
+{
+  Rcc_Lock_t reg = { 0UL };
+  return reg;
+}
+
+static inline Rcc_Lock_t RccLock_FromRead(uint32_t value)
+{
+  Rcc_Lock_t reg = { value };
+  return reg;
+}
+
+static inline uint32_t RccLock_ToWrite(Rcc_Lock_t reg)
+{
+  return reg.value;
+}
+
+static inline bool RccLock_GetLockStatus(Rcc_Lock_t reg)
+{
+  return ((reg.value & RCC_REG_LOCK_LOCK_STATUS_MSK) != 0UL);
+}
+
+static inline Rcc_Lock_t RccLock_SetLock(Rcc_Lock_t reg, bool value)
+{
+  reg.value = (reg.value & ~RCC_REG_LOCK_LOCK_MSK) |
+              (((uint32_t)value << RCC_REG_LOCK_LOCK_POS) & RCC_REG_LOCK_LOCK_MSK);
+  return reg;
+}
+
+/**
+ * @brief Reset value of one register
+ */
+typedef struct {
+  uint32_t offset;
+  uint32_t value;
+} Rcc_Reg_Reset_t;
+
+#define RCC_REG_COUNT                            5U
+#define RCC_REG_RESET_TABLE                      { \
+  { RCC_REG_CR_OFFSET, RCC_REG_CR_RESET }, \
+  { RCC_REG_PLLCFGR_OFFSET, RCC_REG_PLLCFGR_RESET }, \
+  { RCC_REG_UNL_OFFSET, RCC_REG_UNL_RESET }, \
+  { RCC_REG_UNH_OFFSET, RCC_REG_UNH_RESET }, \
+  { RCC_REG_LOCK_OFFSET, RCC_REG_LOCK_RESET }, \
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RCC_REGS__H
@@ -0,0 +1,795 @@
+/**
+ * @file    rcc_sim.c
+ * @brief   Host-side behavioral model of the SMC_40 RCC
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Models the RCC as described in Section 4 of the SMC_40CR reference manual:
+ * the RCC_UNL/RCC_UNH unlock order and LOCK_STATUS, the PLL and oscillator
+ * ready latencies, the CLKSEL switch time, the side effects of setting
+ * DEF_CLOCK and the fallback to DEF_CLOCK on an invalid configuration.
+ *
+ * Time only moves forward on a register access (RccSim_Timing_t read/write
+ * cost) or on an explicit call to RccSim_Advance() for CPU work done between
+ * accesses.
+ *
+ * Each RccSim_t is an independent RCC with its own registers and cycle
+ * counter. The RccSim_xxx() functions act on the one behind RCC_BASE; further
+ * instances are driven through their base address (RccSimInst_GetBase()), so
+ * separate host threads can each run their own simulated chip.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "rcc_access.h"
+#include "rcc_sim.h"
+
+#define RCC_SIM_NO_EVENT                 UINT64_MAX
+#define RCC_SIM_PLL_INPUT_HZ             40000000UL
+#define RCC_SIM_MAX_BUS_CLOCK_HZ         20000000UL
+
+#define RCC_CR_CLEARED_BY_DEF_CLOCK      (RCC_CR_PLLON | RCC_CR_PLL_RDY | RCC_CR_HSEON | \
+                                          RCC_CR_HSERDY | RCC_CR_HSION | RCC_CR_HSIRDY)
+
+// Instance behind RCC_BASE, used by the RccSim_xxx() functions
+static RccSim_t s_Sim;
+
+// Set while this thread runs an access hook; accesses the hook makes do not
+// call it again
+static _Thread_local bool s_IsInAccessHook;
+
+// Reset values from the manual (rcc_regs.h)
+static const Rcc_Reg_Reset_t s_ResetValues[RCC_REG_COUNT] = RCC_REG_RESET_TABLE;
+
+static const char *const s_PhaseNames[RCC_SIM_PHASE_COUNT] =
+{
+  "other", "unlock", "def_clock", "pll_lock", "osc_ready", "clksel_switch", "relock"
+};
+
+/**
+ * @brief  Decodes a 2-bit SYS_DIV/BUS_DIV field (0b11 behaves like 0b10)
+ */
+static uint32_t DecodeClockDivider(uint32_t field)
+{
+  return (field == 0U) ? 1U : ((field == 1U) ? 2U : 4U);
+}
+
+/**
+ * @brief  Computes the bus clock the CR/PLLCFGR pair would produce on HSI or HSE
+ */
+static uint32_t ComputeBusClockHz(uint32_t cr, uint32_t pllcfgr)
+{
+  uint32_t mul = 1U;
+  switch ((pllcfgr & RCC_PLLCFGR_MUL) >> RCC_PLLCFGR_MUL_Pos)
+  {
+    case 1U: mul = 2U; break;
+    case 2U: mul = 4U; break;
+    default: mul = 1U; break;
+  }
+
+  uint32_t div = 1U;
+  switch ((pllcfgr & RCC_PLLCFGR_DIV) >> RCC_PLLCFGR_DIV_Pos)
+  {
+    case 1U: div = 2U; break;
+    case 2U: div = 4U; break;
+    case 4U: div = 8U; break;
+    default: div = 1U; break;
+  }
+
+  uint32_t sysDiv = DecodeClockDivider((cr & RCC_CR_SYS_DIV) >> RCC_CR_SYS_DIV_Pos);
+  uint32_t busDiv = DecodeClockDivider((cr & RCC_CR_BUS_DIV) >> RCC_CR_BUS_DIV_Pos);
+
+  return (uint32_t)(((uint64_t)RCC_SIM_PLL_INPUT_HZ * mul) / div / sysDiv / busDiv);
+}
+
+static uint32_t *Reg(RccSim_t *sim, uint32_t offset)
+{
+  return &sim->regs[offset / 4UL];
+}
+
+static void ScheduleClkselSwitch(RccSim_t *sim, uint32_t target)
+{
+  if ((*Reg(sim, RCC_CR_OFFSET) & RCC_CR_CLKSEL) == target)
+  {
+    sim->clkselAt = RCC_SIM_NO_EVENT;
+  }
+  else if ((sim->clkselAt != RCC_SIM_NO_EVENT) && (sim->clkselTarget == target))
+  {
+    // Already on its way there
+  }
+  else
+  {
+    sim->clkselTarget = target;
+    sim->clkselAt = sim->cycles + sim->timing.clkselSwitchCycles;
+  }
+}
+
+/**
+ * @brief  DEF_CLOCK going to 1: PLLON, HSERDY, HSEON, HSIRDY and HSION clear
+ *         and CLKSEL moves back to DEF_CLOCK.
+ */
+static void EnterDefClock(RccSim_t *sim)
+{
+  uint32_t *cr = Reg(sim, RCC_CR_OFFSET);
+  *cr = (*cr | RCC_CR_DEF_CLOCK) & ~RCC_CR_CLEARED_BY_DEF_CLOCK;
+  sim->pllReadyAt = RCC_SIM_NO_EVENT;
+  sim->hsiReadyAt = RCC_SIM_NO_EVENT;
+  sim->hseReadyAt = RCC_SIM_NO_EVENT;
+  sim->runSource = 0U;
+  ScheduleClkselSwitch(sim, 0U);
+}
+
+static void FallBackToDefClock(RccSim_t *sim)
+{
+  sim->fallbackCount++;
+  EnterDefClock(sim);
+}
+
+/**
+ * @brief  Checks the configuration needed to run from HSI/HSE
+ * @param cr RCC_CR value
+ * @param source CLKSEL value of the oscillator to run from
+ * @retval true if the PLL, the oscillator and the bus clock are all valid
+ */
+static bool IsRunConfigValid(RccSim_t *sim, uint32_t cr, uint32_t source)
+{
+  uint32_t oscBits = (source == RCC_CR_CLKSEL_0) ? (RCC_CR_HSION | RCC_CR_HSIRDY) :
+                                                   (RCC_CR_HSEON | RCC_CR_HSERDY);
+  if ((cr & oscBits) != oscBits)
+  {
+    return false;
+  }
+
+  if ((cr & (RCC_CR_PLLON | RCC_CR_PLL_RDY)) != (RCC_CR_PLLON | RCC_CR_PLL_RDY))
+  {
+    return false;
+  }
+
+  return (ComputeBusClockHz(cr, *Reg(sim, RCC_PLLCFGR_OFFSET)) <= RCC_SIM_MAX_BUS_CLOCK_HZ);
+}
+
+/**
+ * @brief  Re-validates the configuration while running from HSI/HSE
+ */
+static void CheckRunConfig(RccSim_t *sim)
+{
+  uint32_t cr = *Reg(sim, RCC_CR_OFFSET);
+  if (((cr & RCC_CR_DEF_CLOCK) == 0U) && !IsRunConfigValid(sim, cr, sim->runSource))
+  {
+    FallBackToDefClock(sim);
+  }
+}
+
+/**
+ * @brief  Moves the virtual clock forward and charges the time to the current phase
+ */
+static void Spend(RccSim_t *sim, uint32_t cycles)
+{
+  sim->cycles += cycles;
+  sim->phaseCycles[sim->phase] += cycles;
+}
+
+/**
+ * @brief  Works out which bring-up phase a register write starts, if any
+ */
+static RccSim_Phase_t PhaseForWrite(RccSim_t *sim, uint32_t offset, uint32_t value)
+{
+  if (offset == RCC_UNL_OFFSET)
+  {
+    return RCC_SIM_PHASE_UNLOCK;
+  }
+  if (offset == RCC_LOCK_OFFSET)
+  {
+    return RCC_SIM_PHASE_RELOCK;
+  }
+  if (offset == RCC_PLLCFGR_OFFSET)
+  {
+    return RCC_SIM_PHASE_PLL_LOCK;
+  }
+  if ((offset != RCC_CR_OFFSET) || sim->isLocked)
+  {
+    return sim->phase;
+  }
+
+  uint32_t cr = *Reg(sim, RCC_CR_OFFSET);
+  uint32_t rising = value & ~cr;
+  uint32_t falling = cr & ~value;
+  if ((rising & RCC_CR_DEF_CLOCK) != 0U)
+  {
+    return RCC_SIM_PHASE_DEF_CLOCK;
+  }
+  if ((falling & RCC_CR_DEF_CLOCK) != 0U)
+  {
+    return RCC_SIM_PHASE_CLKSEL_SWITCH;
+  }
+  if ((rising & (RCC_CR_HSION | RCC_CR_HSEON)) != 0U)
+  {
+    return RCC_SIM_PHASE_OSC_READY;
+  }
+  if ((rising & RCC_CR_PLLON) != 0U)
+  {
+    return RCC_SIM_PHASE_PLL_LOCK;
+  }
+  return sim->phase;
+}
+
+/**
+ * @brief  Applies every pending hardware event that is due at the current cycle
+ */
+static void UpdateEvents(RccSim_t *sim)
+{
+  uint32_t *cr = Reg(sim, RCC_CR_OFFSET);
+  if (sim->cycles >= sim->pllReadyAt)
+  {
+    *cr |= RCC_CR_PLL_RDY;
+    sim->pllReadyAt = RCC_SIM_NO_EVENT;
+    sim->isIrqPending = true;
+  }
+  if (sim->cycles >= sim->hsiReadyAt)
+  {
+    *cr |= RCC_CR_HSIRDY;
+    sim->hsiReadyAt = RCC_SIM_NO_EVENT;
+    sim->isIrqPending = true;
+  }
+  if (sim->cycles >= sim->hseReadyAt)
+  {
+    *cr |= RCC_CR_HSERDY;
+    sim->hseReadyAt = RCC_SIM_NO_EVENT;
+    sim->isIrqPending = true;
+  }
+  if (sim->cycles >= sim->clkselAt)
+  {
+    *cr = (*cr & ~RCC_CR_CLKSEL) | sim->clkselTarget;
+    sim->clkselAt = RCC_SIM_NO_EVENT;
+    sim->isIrqPending = true;
+  }
+  if (sim->cycles >= sim->faultAt)
+  {
+    sim->faultAt = RCC_SIM_NO_EVENT;
+    if (sim->fault == RCC_SIM_FAULT_RELOCK)
+    {
+      sim->isLocked = true;
+      sim->isUnlockArmed = false;
+    }
+    else if (sim->fault == RCC_SIM_FAULT_FALLBACK)
+    {
+      FallBackToDefClock(sim);
+      sim->isIrqPending = true;
+    }
+  }
+}
+
+static void StartOrStop(RccSim_t *sim, uint32_t rising, uint32_t falling, uint32_t onBit, uint32_t readyBit,
+                        uint64_t *readyAt, uint32_t latency)
+{
+  if ((rising & onBit) != 0U)
+  {
+    *readyAt = sim->cycles + latency;
+  }
+  else if ((falling & onBit) != 0U)
+  {
+    *Reg(sim, RCC_CR_OFFSET) &= ~readyBit;
+    *readyAt = RCC_SIM_NO_EVENT;
+  }
+}
+
+static void WriteCr(RccSim_t *sim, uint32_t value)
+{
+  uint32_t *cr = Reg(sim, RCC_CR_OFFSET);
+  uint32_t oldCr = *cr;
+  uint32_t newCr = (oldCr & ~RCC_REG_CR_WRITE_MASK) | (value & RCC_REG_CR_WRITE_MASK);
+  uint32_t rising = newCr & ~oldCr;
+  uint32_t falling = oldCr & ~newCr;
+  *cr = newCr;
+
+  if ((rising & RCC_CR_DEF_CLOCK) != 0U)
+  {
+    EnterDefClock(sim);
+    return;
+  }
+
+  StartOrStop(sim, rising, falling, RCC_CR_PLLON, RCC_CR_PLL_RDY, &sim->pllReadyAt, sim->timing.pllReadyCycles);
+  StartOrStop(sim, rising, falling, RCC_CR_HSION, RCC_CR_HSIRDY, &sim->hsiReadyAt, sim->timing.hsiReadyCycles);
+  StartOrStop(sim, rising, falling, RCC_CR_HSEON, RCC_CR_HSERDY, &sim->hseReadyAt, sim->timing.hseReadyCycles);
+
+  if ((falling & RCC_CR_DEF_CLOCK) != 0U)
+  {
+    // Leaving DEF_CLOCK: exactly one oscillator must be enabled to pick from
+    bool isHsiOn = ((newCr & RCC_CR_HSION) != 0U);
+    bool isHseOn = ((newCr & RCC_CR_HSEON) != 0U);
+    uint32_t source = isHsiOn ? RCC_CR_CLKSEL_0 : RCC_CR_CLKSEL_1;
+    if ((isHsiOn == isHseOn) || !IsRunConfigValid(sim, newCr, source))
+    {
+      FallBackToDefClock(sim);
+      return;
+    }
+    sim->runSource = source;
+    ScheduleClkselSwitch(sim, source);
+    return;
+  }
+
+  CheckRunConfig(sim);
+}
+
+static void WritePllcfgr(RccSim_t *sim, uint32_t value)
+{
+  uint32_t *pllcfgr = Reg(sim, RCC_PLLCFGR_OFFSET);
+  uint32_t newValue = value & RCC_REG_PLLCFGR_WRITE_MASK;
+  if (newValue == *pllcfgr)
+  {
+    return;
+  }
+  *pllcfgr = newValue;
+
+  // A new PLL configuration has to lock again before it can be used
+  uint32_t *cr = Reg(sim, RCC_CR_OFFSET);
+  if ((*cr & RCC_CR_PLLON) != 0U)
+  {
+    *cr &= ~RCC_CR_PLL_RDY;
+    sim->pllReadyAt = sim->cycles + sim->timing.pllReadyCycles;
+  }
+  CheckRunConfig(sim);
+}
+
+/**
+ * @brief  Fills in the worst-case timing from the reference manual
+ * @param timing Timing structure to fill in
+ */
+void RccSim_GetDefaultTiming(RccSim_Timing_t *timing)
+{
+  timing->pllReadyCycles = RCC_SIM_PLL_RDY_MAX_CYCLES;
+  timing->hsiReadyCycles = RCC_SIM_HSIRDY_MAX_CYCLES;
+  timing->hseReadyCycles = RCC_SIM_HSERDY_MAX_CYCLES;
+  timing->clkselSwitchCycles = RCC_SIM_CLKSEL_MAX_CYCLES;
+  timing->readCycles = RCC_SIM_ACCESS_CYCLES;
+  timing->writeCycles = RCC_SIM_ACCESS_CYCLES;
+}
+
+/**
+ * @brief  Puts a simulated RCC into its reset state and zeroes its cycle counter
+ * @param sim Simulated RCC
+ * @param timing Timing to simulate, or NULL for the manual's worst case
+ */
+void RccSimInst_Init(RccSim_t *sim, const RccSim_Timing_t *timing)
+{
+  memset(sim, 0, sizeof(*sim));
+  if (timing != NULL)
+  {
+    sim->timing = *timing;
+  }
+  else
+  {
+    RccSim_GetDefaultTiming(&sim->timing);
+  }
+
+  // RCC_UNL/UNH/LOCK are modelled by isLocked, their words are never read
+  for (uint32_t i = 0U; i < RCC_REG_COUNT; i++)
+  {
+    *Reg(sim, s_ResetValues[i].offset) = s_ResetValues[i].value;
+  }
+  *Reg(sim, RCC_CSR_OFFSET) = RCC_CSR_PORRSTF | RCC_CSR_PINRSTF;   // Powered up
+  sim->isLocked = RccLock_GetLockStatus(RccLock_Reset());
+  sim->pllReadyAt = RCC_SIM_NO_EVENT;
+  sim->hsiReadyAt = RCC_SIM_NO_EVENT;
+  sim->hseReadyAt = RCC_SIM_NO_EVENT;
+  sim->clkselAt = RCC_SIM_NO_EVENT;
+  sim->faultAt = RCC_SIM_NO_EVENT;
+  sim->isInitialized = true;
+}
+
+/**
+ * @brief  Simulates a system reset (watchdog, software, NRST pin, ...)
+ * @note   Like RccSimInst_Init() but keeps the timing and the sticky RCC_CSR
+ *         reset flags, then adds resetFlags. Memory outside the simulated
+ *         RCC, such as a retained RAM record, is left alone.
+ * @param sim Simulated RCC
+ * @param resetFlags RCC_CSR_xxxRSTF flags of this reset
+ */
+void RccSimInst_Reset(RccSim_t *sim, uint32_t resetFlags)
+{
+  RccSim_Timing_t timing = sim->timing;
+  uint32_t csr = sim->isInitialized ? *Reg(sim, RCC_CSR_OFFSET) : 0U;
+  RccSimInst_Init(sim, &timing);
+  *Reg(sim, RCC_CSR_OFFSET) = (csr | resetFlags) & RCC_CSR_RESET_FLAGS;
+}
+
+/**
+ * @brief  Restarts an event that was scheduled with an RCC_SIM_NEVER latency
+ */
+static void RepairEvent(RccSim_t *sim, uint64_t *eventAt, uint32_t oldLatency, uint32_t newLatency)
+{
+  if ((*eventAt != RCC_SIM_NO_EVENT) && (oldLatency == RCC_SIM_NEVER) && (newLatency != RCC_SIM_NEVER))
+  {
+    *eventAt = sim->cycles + newLatency;
+  }
+}
+
+/**
+ * @brief  Changes the latencies without resetting the RCC
+ * @note   Applies to events started after the call; events already scheduled
+ *         keep their time, except those pending with an RCC_SIM_NEVER latency,
+ *         which restart now with the new one (the fault has been repaired).
+ * @param sim Simulated RCC
+ * @param timing New timing
+ */
+void RccSimInst_SetTiming(RccSim_t *sim, const RccSim_Timing_t *timing)
+{
+  RepairEvent(sim, &sim->pllReadyAt, sim->timing.pllReadyCycles, timing->pllReadyCycles);
+  RepairEvent(sim, &sim->hsiReadyAt, sim->timing.hsiReadyCycles, timing->hsiReadyCycles);
+  RepairEvent(sim, &sim->hseReadyAt, sim->timing.hseReadyCycles, timing->hseReadyCycles);
+  RepairEvent(sim, &sim->clkselAt, sim->timing.clkselSwitchCycles, timing->clkselSwitchCycles);
+  sim->timing = *timing;
+}
+
+/**
+ * @brief  Schedules a fault (replaces any fault not yet applied)
+ * @param sim Simulated RCC
+ * @param fault Fault to inject, RCC_SIM_FAULT_NONE to cancel
+ * @param atCycle Cycle count at which it happens
+ */
+void RccSimInst_InjectFault(RccSim_t *sim, RccSim_Fault_t fault, uint64_t atCycle)
+{
+  sim->fault = fault;
+  sim->faultAt = (fault == RCC_SIM_FAULT_NONE) ? RCC_SIM_NO_EVENT : atCycle;
+}
+
+/**
+ * @brief  Sets a function called after every register access
+ * @note   The hook may access the RCC itself; those accesses do not call it
+ *         again. It runs on the thread that made the access.
+ *         RccSimInst_Init() removes it.
+ * @param sim Simulated RCC
+ * @param hook Function to call, NULL for none
+ * @param context Passed to the hook
+ */
+void RccSimInst_SetAccessHook(RccSim_t *sim, RccSim_Access_Hook_t hook, void *context)
+{
+  sim->accessHook = hook;
+  sim->accessHookContext = context;
+}
+
+static void RunAccessHook(RccSim_t *sim)
+{
+  if ((sim->accessHook != NULL) && !s_IsInAccessHook)
+  {
+    s_IsInAccessHook = true;
+    sim->accessHook(sim->accessHookContext);
+    s_IsInAccessHook = false;
+  }
+}
+
+/**
+ * @brief  Register read as seen by the CPU. Costs RccSim_Timing_t::readCycles.
+ * @param sim Simulated RCC
+ * @param offset Register offset from the RCC base
+ * @retval Register value
+ */
+uint32_t RccSimInst_Read(RccSim_t *sim, uint32_t offset)
+{
+  if (!sim->isInitialized)
+  {
+    RccSimInst_Init(sim, NULL);
+  }
+
+  sim->readCount++;
+  Spend(sim, sim->timing.readCycles);
+  UpdateEvents(sim);
+  uint32_t value = RccSimInst_Peek(sim, offset);
+  RunAccessHook(sim);
+  return value;
+}
+
+static void WriteRegister(RccSim_t *sim, uint32_t offset, uint32_t value);
+
+/**
+ * @brief  Register write as seen by the CPU. Costs RccSim_Timing_t::writeCycles.
+ * @param sim Simulated RCC
+ * @param offset Register offset from the RCC base
+ * @param value Value written
+ */
+void RccSimInst_Write(RccSim_t *sim, uint32_t offset, uint32_t value)
+{
+  WriteRegister(sim, offset, value);
+  RunAccessHook(sim);
+}
+
+static void WriteRegister(RccSim_t *sim, uint32_t offset, uint32_t value)
+{
+  if (!sim->isInitialized)
+  {
+    RccSimInst_Init(sim, NULL);
+  }
+
+  sim->writeCount++;
+  sim->phase = PhaseForWrite(sim, offset, value);
+  Spend(sim, sim->timing.writeCycles);
+  UpdateEvents(sim);
+
+  switch (offset)
+  {
+    case RCC_UNL_OFFSET:
+      sim->isUnlockArmed = ((value & RCC_UNL_UNLOCK) == RCC_UNL_KEY);
+      if (!sim->isUnlockArmed)
+      {
+        sim->isLocked = true;
+      }
+      return;
+
+    case RCC_UNH_OFFSET:
+      sim->isLocked = !(sim->isUnlockArmed && ((value & RCC_UNH_UNLOCK) == RCC_UNH_KEY));
+      sim->isUnlockArmed = false;
+      return;
+
+    case RCC_LOCK_OFFSET:
+      sim->isUnlockArmed = false;
+      if ((value & RCC_LOCK_LOCK) != 0U)
+      {
+        sim->isLocked = true;
+      }
+      // Relocking is a single write, whatever follows is outside the bring-up
+      sim->phase = RCC_SIM_PHASE_OTHER;
+      return;
+
+    default:
+      break;
+  }
+
+  sim->isUnlockArmed = false;
+  if (sim->isLocked || (offset > RCC_CSR_OFFSET) || ((offset % 4UL) != 0U))
+  {
+    return;
+  }
+
+  if (offset == RCC_CR_OFFSET)
+  {
+    WriteCr(sim, value);
+  }
+  else if (offset == RCC_PLLCFGR_OFFSET)
+  {
+    WritePllcfgr(sim, value);
+  }
+  else if (offset == RCC_CSR_OFFSET)
+  {
+    // The reset flags are read-only, RMVF clears them and reads as 0
+    uint32_t *csr = Reg(sim, RCC_CSR_OFFSET);
+    *csr = (*csr & RCC_CSR_RESET_FLAGS) | (value & ~(RCC_CSR_RESET_FLAGS | RCC_CSR_RMVF));
+    if ((value & RCC_CSR_RMVF) != 0U)
+    {
+      *csr &= ~RCC_CSR_RESET_FLAGS;
+    }
+  }
+  else
+  {
+    *Reg(sim, offset) = value;
+  }
+}
+
+/**
+ * @brief  Returns what a read would return without advancing time
+ * @param sim Simulated RCC
+ * @param offset Register offset from the RCC base
+ * @retval Register value
+ */
+uint32_t RccSimInst_Peek(RccSim_t *sim, uint32_t offset)
+{
+  switch (offset)
+  {
+    case RCC_UNL_OFFSET:
+    case RCC_UNH_OFFSET:
+      return 0U;
+
+    case RCC_LOCK_OFFSET:
+      // LOCK always reads 0, only LOCK_STATUS is visible
+      return sim->isLocked ? RCC_LOCK_LOCK_STATUS : 0U;
+
+    default:
+      break;
+  }
+
+  if ((offset > RCC_CSR_OFFSET) || ((offset % 4UL) != 0U))
+  {
+    return 0U;
+  }
+  return *Reg(sim, offset);
+}
+
+/**
+ * @brief  Accounts for CPU work done between register accesses
+ * @param sim Simulated RCC
+ * @param cycles Number of CPU cycles spent
+ */
+void RccSimInst_Advance(RccSim_t *sim, uint32_t cycles)
+{
+  Spend(sim, cycles);
+  UpdateEvents(sim);
+}
+
+/**
+ * @brief  Returns the virtual cycle counter of a simulated RCC
+ */
+uint64_t RccSimInst_GetCycles(const RccSim_t *sim)
+{
+  return sim->cycles;
+}
+
+/**
+ * @brief  Returns how many times an invalid configuration forced DEF_CLOCK
+ */
+uint32_t RccSimInst_GetFallbackCount(const RccSim_t *sim)
+{
+  return sim->fallbackCount;
+}
+
+/**
+ * @brief  Returns the base address that stands for a simulated RCC
+ * @note   Pass it wherever the code takes an RCC base (ClockDriver_Init(),
+ *         RccReadAt(), ...). It is never dereferenced as a register address.
+ * @param sim Simulated RCC
+ */
+uintptr_t RccSimInst_GetBase(const RccSim_t *sim)
+{
+  return (uintptr_t)sim;
+}
+
+/**
+ * @brief  Returns the simulated RCC behind a base address
+ * @param rccBase RCC_BASE for the instance used by the RccSim_xxx() functions,
+ *        otherwise a value from RccSimInst_GetBase()
+ */
+RccSim_t *RccSimInst_FromBase(uintptr_t rccBase)
+{
+  return (rccBase == RCC_BASE) ? &s_Sim : (RccSim_t *)rccBase;
+}
+
+/**
+ * @brief  Puts the simulated RCC at RCC_BASE into its reset state
+ * @param timing Timing to simulate, or NULL for the manual's worst case
+ */
+void RccSim_Init(const RccSim_Timing_t *timing)
+{
+  RccSimInst_Init(&s_Sim, timing);
+}
+
+/**
+ * @brief  RccSimInst_Reset() on the simulated RCC at RCC_BASE
+ */
+void RccSim_Reset(uint32_t resetFlags)
+{
+  RccSimInst_Reset(&s_Sim, resetFlags);
+}
+
+/**
+ * @brief  RccSimInst_SetTiming() on the simulated RCC at RCC_BASE
+ */
+void RccSim_SetTiming(const RccSim_Timing_t *timing)
+{
+  RccSimInst_SetTiming(&s_Sim, timing);
+}
+
+/**
+ * @brief  RccSimInst_InjectFault() on the simulated RCC at RCC_BASE
+ */
+void RccSim_InjectFault(RccSim_Fault_t fault, uint64_t atCycle)
+{
+  RccSimInst_InjectFault(&s_Sim, fault, atCycle);
+}
+
+void RccSim_SetAccessHook(RccSim_Access_Hook_t hook, void *context)
+{
+  RccSimInst_SetAccessHook(&s_Sim, hook, context);
+}
+
+/**
+ * @brief  RccSimInst_Read() on the simulated RCC at RCC_BASE
+ */
+uint32_t RccSim_Read(uint32_t offset)
+{
+  return RccSimInst_Read(&s_Sim, offset);
+}
+
+/**
+ * @brief  RccSimInst_Write() on the simulated RCC at RCC_BASE
+ */
+void RccSim_Write(uint32_t offset, uint32_t value)
+{
+  RccSimInst_Write(&s_Sim, offset, value);
+}
+
+/**
+ * @brief  RccSimInst_Peek() on the simulated RCC at RCC_BASE
+ */
+uint32_t RccSim_Peek(uint32_t offset)
+{
+  return RccSimInst_Peek(&s_Sim, offset);
+}
+
+/**
+ * @brief  RccSimInst_Advance() on the simulated RCC at RCC_BASE
+ */
+void RccSim_Advance(uint32_t cycles)
+{
+  RccSimInst_Advance(&s_Sim, cycles);
+}
+
+/**
+ * @brief  Returns the virtual cycle counter
+ */
+uint64_t RccSim_GetCycles(void)
+{
+  return s_Sim.cycles;
+}
+
+/**
+ * @brief  Returns how many times an invalid configuration forced DEF_CLOCK
+ */
+uint32_t RccSim_GetFallbackCount(void)
+{
+  return s_Sim.fallbackCount;
+}
+
+/**
+ * @brief  Returns and clears the pending RCC_IRQn
+ * @note   The model raises RCC_IRQn whenever PLL_RDY, HSIRDY or HSERDY gets
+ *         set or CLKSEL changes. Host code calls RCC_IRQHandler() when this
+ *         returns true, as the NVIC would on target.
+ */
+bool RccSim_TakeInterrupt(void)
+{
+  bool isPending = s_Sim.isIrqPending;
+  s_Sim.isIrqPending = false;
+  return isPending;
+}
+
+/**
+ * @brief  Zeroes the register read and write counters
+ */
+void RccSim_ResetAccessCounts(void)
+{
+  s_Sim.readCount = 0U;
+  s_Sim.writeCount = 0U;
+}
+
+/**
+ * @brief  Returns the number of register reads since the last reset
+ */
+uint32_t RccSim_GetReadCount(void)
+{
+  return s_Sim.readCount;
+}
+
+/**
+ * @brief  Returns the number of register writes since the last reset
+ */
+uint32_t RccSim_GetWriteCount(void)
+{
+  return s_Sim.writeCount;
+}
+
+/**
+ * @brief  Zeroes the per-phase cycle counts and returns to RCC_SIM_PHASE_OTHER
+ */
+void RccSim_ResetPhaseCycles(void)
+{
+  memset(s_Sim.phaseCycles, 0, sizeof(s_Sim.phaseCycles));
+  s_Sim.phase = RCC_SIM_PHASE_OTHER;
+}
+
+/**
+ * @brief  Returns the cycles charged to a phase since the last reset
+ * @param phase Phase to query
+ */
+uint64_t RccSim_GetPhaseCycles(RccSim_Phase_t phase)
+{
+  return (phase < RCC_SIM_PHASE_COUNT) ? s_Sim.phaseCycles[phase] : 0U;
+}
+
+/**
+ * @brief  Returns a short lower-case name for a phase (used as a CSV/JSON key)
+ * @param phase Phase to name
+ */
+const char *RccSim_GetPhaseName(RccSim_Phase_t phase)
+{
+  return (phase < RCC_SIM_PHASE_COUNT) ? s_PhaseNames[phase] : "unknown";
+}
@@ -0,0 +1,168 @@
+/**
+ * @file    rcc_sim.h
+ * @brief   Host-side behavioral model of the SMC_40 RCC
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Used in place of the real RCC when building with MOCK_REGISTERS = 1. The
+ * model runs on a virtual CPU cycle counter so that a run of the startup code
+ * reports exactly how many cycles the clock bring-up took.
+ *
+ * Any number of independent RCCs can be simulated at once (RccSim_t). The
+ * RccSim_xxx() functions act on the one that stands in for RCC_BASE.
+ *
+ */
+
+#ifndef RCC_SIM__H
+#define RCC_SIM__H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rcc_regs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Worst-case latencies from the SMC_40CR reference manual, in CPU cycles
+ */
+#define RCC_SIM_PLL_RDY_MAX_CYCLES       RCC_REG_CR_PLL_RDY_MAX_CYCLES
+#define RCC_SIM_HSIRDY_MAX_CYCLES        RCC_REG_CR_HSIRDY_MAX_CYCLES
+#define RCC_SIM_HSERDY_MAX_CYCLES        RCC_REG_CR_HSERDY_MAX_CYCLES
+#define RCC_SIM_CLKSEL_MAX_CYCLES        RCC_REG_CR_CLKSEL_MAX_CYCLES
+
+/**
+ * @brief Cost of a single RCC register access, in CPU cycles
+ */
+#define RCC_SIM_ACCESS_CYCLES            2UL
+
+/**
+ * @brief Latency value for an event that never happens (e.g. a dead crystal)
+ */
+#define RCC_SIM_NEVER                    UINT32_MAX
+
+/**
+ * @brief Timing of the simulated RCC
+ */
+typedef struct
+{
+  uint32_t pllReadyCycles;      /*!< PLLON set to PLL_RDY set                        */
+  uint32_t hsiReadyCycles;      /*!< HSION set to HSIRDY set                         */
+  uint32_t hseReadyCycles;      /*!< HSEON set to HSERDY set                         */
+  uint32_t clkselSwitchCycles;  /*!< DEF_CLOCK written to CLKSEL showing the switch  */
+  uint32_t readCycles;          /*!< Cost of one register read                       */
+  uint32_t writeCycles;         /*!< Cost of one register write                      */
+} RccSim_Timing_t;
+
+/**
+ * @brief Clock bring-up phases the simulator attributes cycles to
+ * @note  A phase starts with the register write that triggers it and lasts
+ *        until the next phase starts, so the phases always add up to the
+ *        total cycle count.
+ */
+typedef enum
+{
+  RCC_SIM_PHASE_OTHER = 0,      /*!< Anything outside of the phases below (validation, return) */
+  RCC_SIM_PHASE_UNLOCK,         /*!< RCC_UNL written                                            */
+  RCC_SIM_PHASE_DEF_CLOCK,      /*!< DEF_CLOCK set to return to the default clock               */
+  RCC_SIM_PHASE_PLL_LOCK,       /*!< RCC_PLLCFGR written or PLLON set                           */
+  RCC_SIM_PHASE_OSC_READY,      /*!< HSION or HSEON set                                         */
+  RCC_SIM_PHASE_CLKSEL_SWITCH,  /*!< DEF_CLOCK cleared                                          */
+  RCC_SIM_PHASE_RELOCK,         /*!< RCC_LOCK written                                           */
+  RCC_SIM_PHASE_COUNT
+} RccSim_Phase_t;
+
+/**
+ * @brief Faults that can be injected at a given cycle
+ */
+typedef enum
+{
+  RCC_SIM_FAULT_NONE = 0,
+  RCC_SIM_FAULT_RELOCK,         /*!< Stray bad RCC_UNL/RCC_UNH write: registers lock again */
+  RCC_SIM_FAULT_FALLBACK,       /*!< Hardware falls back to DEF_CLOCK                      */
+} RccSim_Fault_t;
+
+/**
+ * @brief Called after every register access, e.g. to raise an interrupt in
+ *        the middle of the code doing the access
+ */
+typedef void (*RccSim_Access_Hook_t)(void *context);
+
+#define RCC_SIM_REG_COUNT                30U   /*!< RCC_CR (0x00) to RCC_CSR (0x74), one per word */
+
+/**
+ * @brief One simulated RCC. Fields are private to rcc_sim.c.
+ */
+typedef struct RccSim
+{
+  bool isInitialized;
+  RccSim_Timing_t timing;
+  uint64_t cycles;
+  uint32_t regs[RCC_SIM_REG_COUNT];
+  bool isLocked;
+  bool isUnlockArmed;           /*!< RCC_UNL key written, RCC_UNH key expected next */
+  uint32_t runSource;           /*!< CLKSEL value latched when DEF_CLOCK was cleared */
+  uint64_t pllReadyAt;
+  uint64_t hsiReadyAt;
+  uint64_t hseReadyAt;
+  uint64_t clkselAt;
+  uint32_t clkselTarget;
+  uint32_t fallbackCount;
+  bool isIrqPending;            /*!< RCC_IRQn raised by a ready flag or CLKSEL change */
+  uint32_t readCount;
+  uint32_t writeCount;
+  RccSim_Phase_t phase;
+  uint64_t phaseCycles[RCC_SIM_PHASE_COUNT];
+  RccSim_Fault_t fault;         /*!< Injected fault, applied at faultAt             */
+  uint64_t faultAt;
+  RccSim_Access_Hook_t accessHook;
+  void *accessHookContext;
+} RccSim_t;
+
+void RccSim_GetDefaultTiming(RccSim_Timing_t *timing);
+
+// Any simulated RCC
+void RccSimInst_Init(RccSim_t *sim, const RccSim_Timing_t *timing);
+void RccSimInst_Reset(RccSim_t *sim, uint32_t resetFlags);
+void RccSimInst_SetTiming(RccSim_t *sim, const RccSim_Timing_t *timing);
+void RccSimInst_InjectFault(RccSim_t *sim, RccSim_Fault_t fault, uint64_t atCycle);
+void RccSimInst_SetAccessHook(RccSim_t *sim, RccSim_Access_Hook_t hook, void *context);
+uint32_t RccSimInst_Read(RccSim_t *sim, uint32_t offset);
+void RccSimInst_Write(RccSim_t *sim, uint32_t offset, uint32_t value);
+uint32_t RccSimInst_Peek(RccSim_t *sim, uint32_t offset);
+void RccSimInst_Advance(RccSim_t *sim, uint32_t cycles);
+uint64_t RccSimInst_GetCycles(const RccSim_t *sim);
+uint32_t RccSimInst_GetFallbackCount(const RccSim_t *sim);
+uintptr_t RccSimInst_GetBase(const RccSim_t *sim);
+RccSim_t *RccSimInst_FromBase(uintptr_t rccBase);
+
+// The simulated RCC at RCC_BASE
+void RccSim_Init(const RccSim_Timing_t *timing);
+void RccSim_Reset(uint32_t resetFlags);
+void RccSim_SetTiming(const RccSim_Timing_t *timing);
+void RccSim_InjectFault(RccSim_Fault_t fault, uint64_t atCycle);
+void RccSim_SetAccessHook(RccSim_Access_Hook_t hook, void *context);
+
+uint32_t RccSim_Read(uint32_t offset);
+void RccSim_Write(uint32_t offset, uint32_t value);
+uint32_t RccSim_Peek(uint32_t offset);
+
+void RccSim_Advance(uint32_t cycles);
+uint64_t RccSim_GetCycles(void);
+uint32_t RccSim_GetFallbackCount(void);
+bool RccSim_TakeInterrupt(void);
+
+void RccSim_ResetAccessCounts(void);
+uint32_t RccSim_GetReadCount(void);
+uint32_t RccSim_GetWriteCount(void);
+
+void RccSim_ResetPhaseCycles(void);
+uint64_t RccSim_GetPhaseCycles(RccSim_Phase_t phase);
+const char *RccSim_GetPhaseName(RccSim_Phase_t phase);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RCC_SIM__H
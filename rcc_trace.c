@@ -0,0 +1,185 @@
+/**
+ * @file    rcc_trace.c
+ * @brief   Optional binary trace of the RCC register accesses
+ * @author  SMC
+ * @date    September 2025
+ *
+ * See rcc_trace.h. The header of the buffer is kept up to date with every
+ * record, so the buffer is a complete trace at any moment.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "rcc_trace.h"
+
+#if (RCC_TRACE_ENABLE == 1)
+
+#include "rcc_access.h"
+#include "cycle_counter.h"
+#if (MOCK_REGISTERS == 1)
+  #include <stdio.h>
+#endif // if (MOCK_REGISTERS == 1)
+
+#define RCC_TRACE_BUFFER_SIZE            (RCC_TRACE_HEADER_SIZE + (RCC_TRACE_MAX_RECORDS * RCC_TRACE_RECORD_SIZE))
+
+static uint8_t s_Buffer[RCC_TRACE_BUFFER_SIZE];
+static uint32_t s_NumRecords = 0U;
+static uint32_t s_NumDropped = 0U;
+static bool s_IsRecording = false;
+static bool s_IsLastRead = false;        /*!< Last access recorded is a read    */
+static uint32_t s_LastOffset = 0U;
+static uint32_t s_LastValue = 0U;
+static uint8_t *s_Repeat = NULL;         /*!< Repeat record of the last read    */
+
+/**
+ * @brief  Stores a little-endian field
+ */
+static void PutLe(uint8_t *bytes, uint32_t value, uint32_t size)
+{
+  for (uint32_t i = 0U; i < size; i++)
+  {
+    bytes[i] = (uint8_t)(value >> (8U * i));
+  }
+}
+
+/**
+ * @brief  Appends a record
+ * @retval The record, NULL when the buffer is full
+ */
+static uint8_t *AddRecord(uint32_t value, uint32_t offset, uint8_t flags)
+{
+  if (s_NumRecords >= RCC_TRACE_MAX_RECORDS)
+  {
+    s_NumDropped++;
+    return NULL;
+  }
+
+  uint8_t *record = &s_Buffer[RCC_TRACE_HEADER_SIZE + (s_NumRecords * RCC_TRACE_RECORD_SIZE)];
+  PutLe(&record[0], CycleCounter_Now(), 4U);
+  PutLe(&record[4], value, 4U);
+  record[8] = (uint8_t)offset;
+  record[9] = flags;
+  s_NumRecords++;
+  return record;
+}
+
+static void UpdateHeader(void)
+{
+  PutLe(&s_Buffer[0], RCC_TRACE_MAGIC, 4U);
+  PutLe(&s_Buffer[4], RCC_TRACE_VERSION, 2U);
+  PutLe(&s_Buffer[6], RCC_TRACE_RECORD_SIZE, 2U);
+  PutLe(&s_Buffer[8], s_NumRecords, 4U);
+  PutLe(&s_Buffer[12], s_NumDropped, 4U);
+}
+
+/**
+ * @brief  Empties the buffer and starts recording
+ */
+void RccTrace_Start(void)
+{
+  s_NumRecords = 0U;
+  s_NumDropped = 0U;
+  s_IsLastRead = false;
+  s_Repeat = NULL;
+  UpdateHeader();
+  CycleCounter_Enable();
+  s_IsRecording = true;
+}
+
+/**
+ * @brief  Stops recording; the buffer keeps the trace
+ */
+void RccTrace_Stop(void)
+{
+  s_IsRecording = false;
+}
+
+/**
+ * @brief  Records one access (called by the accessors in rcc_access.h)
+ * @note   Only RCC_CR, RCC_PLLCFGR, RCC_UNL/RCC_UNH and RCC_LOCK of the RCC
+ *         at RCC_BASE are recorded.
+ * @param rccBase Base address of the RCC accessed
+ * @param offset Register offset from rccBase
+ * @param value Value read or written
+ * @param isWrite true for a write
+ */
+void RccTrace_Access(uintptr_t rccBase, uint32_t offset, uint32_t value, bool isWrite)
+{
+  if (!s_IsRecording || (rccBase != RCC_BASE) || (offset > RCC_LOCK_OFFSET))
+  {
+    return;
+  }
+
+  bool isRepeat = !isWrite && s_IsLastRead && (offset == s_LastOffset) && (value == s_LastValue);
+  if (isRepeat && (s_Repeat != NULL))
+  {
+    PutLe(&s_Repeat[0], CycleCounter_Now(), 4U);
+    PutLe(&s_Repeat[4], RccTrace_GetLe(&s_Repeat[4], 4U) + 1U, 4U);
+  }
+  else if (isRepeat)
+  {
+    s_Repeat = AddRecord(1U, offset, RCC_TRACE_FLAG_REPEAT);
+    s_IsLastRead = (s_Repeat != NULL);
+  }
+  else
+  {
+    // Once a record is dropped, later reads must not be folded into older ones
+    bool isAdded = (AddRecord(value, offset, isWrite ? RCC_TRACE_FLAG_WRITE : 0U) != NULL);
+    s_IsLastRead = !isWrite && isAdded;
+    s_LastOffset = offset;
+    s_LastValue = value;
+    s_Repeat = NULL;
+  }
+  UpdateHeader();
+}
+
+/**
+ * @brief  Returns the trace, header and records
+ * @param size Filled in with the number of valid bytes
+ */
+const uint8_t *RccTrace_GetBuffer(uint32_t *size)
+{
+  *size = RCC_TRACE_HEADER_SIZE + (s_NumRecords * RCC_TRACE_RECORD_SIZE);
+  return s_Buffer;
+}
+
+/**
+ * @brief  Returns the number of records in the buffer
+ */
+uint32_t RccTrace_GetRecordCount(void)
+{
+  return s_NumRecords;
+}
+
+/**
+ * @brief  Returns the number of accesses lost to a full buffer
+ */
+uint32_t RccTrace_GetDroppedCount(void)
+{
+  return s_NumDropped;
+}
+
+#if (MOCK_REGISTERS == 1)
+/**
+ * @brief  Writes the trace to a file for trace_analyze
+ * @param path File to create
+ * @retval true if the whole trace was written
+ */
+bool RccTrace_SaveFile(const char *path)
+{
+  FILE *file = fopen(path, "wb");
+  if (file == NULL)
+  {
+    return false;
+  }
+
+  uint32_t size = 0U;
+  const uint8_t *buffer = RccTrace_GetBuffer(&size);
+  bool isWritten = (fwrite(buffer, 1U, size, file) == size);
+  return (fclose(file) == 0) && isWritten;
+}
+#endif // if (MOCK_REGISTERS == 1)
+
+#endif // if (RCC_TRACE_ENABLE == 1)
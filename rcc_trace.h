@@ -0,0 +1,126 @@
+/**
+ * @file    rcc_trace.h
+ * @brief   Optional binary trace of the RCC register accesses
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Build with RCC_TRACE_ENABLE = 1 to record every access the accessors in
+ * rcc_access.h make to RCC_CR, RCC_PLLCFGR, RCC_UNL/RCC_UNH and RCC_LOCK of
+ * the RCC at RCC_BASE: register, value, read or write and the CPU cycle count
+ * right after the access. Recording costs no RCC access, so the simulator's
+ * cycle counts are the same with and without it.
+ *
+ * The trace is kept in a RAM buffer that already has the file layout below,
+ * so on target it can be dumped as is (debugger, UART, ...). With
+ * MOCK_REGISTERS = 1 RccTrace_SaveFile() writes it to a file. trace_analyze.c
+ * reads either.
+ *
+ * Layout, all fields little-endian:
+ *   header, RCC_TRACE_HEADER_SIZE bytes:
+ *     uint32_t magic         RCC_TRACE_MAGIC ("RCCT")
+ *     uint16_t version       RCC_TRACE_VERSION
+ *     uint16_t recordSize    RCC_TRACE_RECORD_SIZE
+ *     uint32_t recordCount   Records that follow
+ *     uint32_t droppedCount  Accesses not recorded because the buffer was full
+ *   recordCount records, RCC_TRACE_RECORD_SIZE bytes each:
+ *     uint32_t cycles        Cycle count right after the access
+ *     uint32_t value         Value read or written
+ *     uint8_t  offset        Register offset from RCC_BASE
+ *     uint8_t  flags         RCC_TRACE_FLAG_xxx
+ *
+ * Polling loops read the same value many times, so a read that repeats the
+ * previous record is not stored again: a RCC_TRACE_FLAG_REPEAT record follows
+ * instead, whose value is the number of repeats and whose cycles are those
+ * after the last one. Later repeats update that record in place.
+ *
+ * The buffer keeps the first records of a run (the start of a bring-up is
+ * what matters) and counts the rest as dropped. Recording is not reentrant;
+ * trace one context at a time.
+ *
+ * With RCC_TRACE_ENABLE = 0 (default) the hook expands to nothing and no code
+ * or data is generated.
+ *
+ */
+
+#ifndef RCC_TRACE__H
+#define RCC_TRACE__H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef RCC_TRACE_ENABLE
+  #define RCC_TRACE_ENABLE               0
+#endif
+
+#ifndef RCC_TRACE_MAX_RECORDS
+  #define RCC_TRACE_MAX_RECORDS          256U    /*!< Records the RAM buffer holds */
+#endif
+
+#define RCC_TRACE_MAGIC                  0x54434352UL   /*!< "RCCT" read as little-endian */
+#define RCC_TRACE_VERSION                1U
+#define RCC_TRACE_HEADER_SIZE            16U
+#define RCC_TRACE_RECORD_SIZE            10U
+#define RCC_TRACE_FLAG_WRITE             0x01U          /*!< Write, otherwise read             */
+#define RCC_TRACE_FLAG_REPEAT            0x02U          /*!< Previous read repeated value times */
+
+/**
+ * @brief One access, as decoded from a trace
+ */
+typedef struct
+{
+  uint32_t cycles;
+  uint32_t value;
+  uint8_t offset;
+  uint8_t flags;
+} RccTrace_Record_t;
+
+/**
+ * @brief  Reads a little-endian field of a trace
+ */
+static inline uint32_t RccTrace_GetLe(const uint8_t *bytes, uint32_t size)
+{
+  uint32_t value = 0U;
+  for (uint32_t i = size; i > 0U; i--)
+  {
+    value = (value << 8U) | bytes[i - 1U];
+  }
+  return value;
+}
+
+/**
+ * @brief  Decodes one RCC_TRACE_RECORD_SIZE byte record
+ */
+static inline void RccTrace_DecodeRecord(const uint8_t *bytes, RccTrace_Record_t *record)
+{
+  record->cycles = RccTrace_GetLe(&bytes[0], 4U);
+  record->value = RccTrace_GetLe(&bytes[4], 4U);
+  record->offset = bytes[8];
+  record->flags = bytes[9];
+}
+
+#if (RCC_TRACE_ENABLE == 1)
+
+void RccTrace_Start(void);
+void RccTrace_Stop(void);
+void RccTrace_Access(uintptr_t rccBase, uint32_t offset, uint32_t value, bool isWrite);
+const uint8_t *RccTrace_GetBuffer(uint32_t *size);
+uint32_t RccTrace_GetRecordCount(void);
+uint32_t RccTrace_GetDroppedCount(void);
+#if (MOCK_REGISTERS == 1)
+bool RccTrace_SaveFile(const char *path);
+#endif // if (MOCK_REGISTERS == 1)
+
+  #define RCC_TRACE_ACCESS(rccBase, offset, value, isWrite)   RccTrace_Access((rccBase), (offset), (value), (isWrite))
+#else
+  #define RCC_TRACE_ACCESS(rccBase, offset, value, isWrite)   ((void)0)
+#endif // if (RCC_TRACE_ENABLE == 1)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RCC_TRACE__H
@@ -0,0 +1,201 @@
+/**
+ * @file    rcc_txn.c
+ * @brief   Batched (shadow register) RCC writes
+ * @author  SMC
+ * @date    September 2025
+ *
+ * See rcc_txn.h. Commit order follows Section 4 of the reference manual:
+ * unlock keys, RCC_PLLCFGR before RCC_CR (PLL configured before PLLON),
+ * peripheral resets before clock enables, and RCC_LOCK last.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "rcc_access.h"
+#include "rcc_txn.h"
+
+#define REG_INDEX(offset)                ((offset) / 4UL)
+#define REG_BIT(offset)                  (1UL << REG_INDEX(offset))
+
+static const uint32_t s_CommitOrder[] =
+{
+  RCC_PLLCFGR_OFFSET,
+  RCC_CR_OFFSET,
+  RCC_AHB1RSTR_OFFSET,
+  RCC_AHB2RSTR_OFFSET,
+  RCC_APB1RSTR_OFFSET,
+  RCC_APB2RSTR_OFFSET,
+  RCC_AHB1ENR_OFFSET,
+  RCC_AHB2ENR_OFFSET,
+  RCC_APB1ENR_OFFSET,
+  RCC_APB2ENR_OFFSET,
+  RCC_AHB1LPENR_OFFSET,
+  RCC_AHB2LPENR_OFFSET,
+  RCC_APB1LPENR_OFFSET,
+  RCC_APB2LPENR_OFFSET,
+  RCC_BDCR_OFFSET,
+  RCC_CSR_OFFSET,
+};
+
+/**
+ * @brief  Checks that an offset names a register a transaction can stage
+ * @note   Only the registers RccTxn_Commit() stores, so reserved offsets are
+ *         turned away here rather than dropped on commit. RCC_UNL, RCC_UNH
+ *         and RCC_LOCK are only written through RccTxn_Unlock() and
+ *         RccTxn_Lock().
+ */
+static bool IsStageable(uint32_t offset)
+{
+  for (uint32_t i = 0U; i < (sizeof(s_CommitOrder) / sizeof(s_CommitOrder[0])); i++)
+  {
+    if (s_CommitOrder[i] == offset)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief  Starts an empty transaction
+ * @param txn Transaction to initialize
+ */
+void RccTxn_Begin(Rcc_Txn_t *txn)
+{
+  RccTxn_BeginAt(txn, RCC_BASE);
+}
+
+/**
+ * @brief  Starts an empty transaction on the RCC at a given base address
+ * @param txn Transaction to initialize
+ * @param rccBase RCC_BASE or a simulated RCC (RccSimInst_GetBase())
+ */
+void RccTxn_BeginAt(Rcc_Txn_t *txn, uintptr_t rccBase)
+{
+  memset(txn, 0, sizeof(*txn));
+  txn->rccBase = rccBase;
+}
+
+/**
+ * @brief  Seeds a shadow with a value the caller has just read
+ * @note   Saves the read RccTxn_Read()/RccTxn_Modify() would otherwise do.
+ * @param txn Transaction
+ * @param offset Register offset from RCC_BASE
+ * @param value Current register value
+ */
+void RccTxn_SetShadow(Rcc_Txn_t *txn, uint32_t offset, uint32_t value)
+{
+  if (IsStageable(offset))
+  {
+    txn->shadow[REG_INDEX(offset)] = value;
+    txn->loadedMask |= REG_BIT(offset);
+  }
+}
+
+/**
+ * @brief  Returns the staged value of a register, reading it on first use
+ * @param txn Transaction
+ * @param offset Register offset from RCC_BASE
+ * @retval Shadow value
+ */
+uint32_t RccTxn_Read(Rcc_Txn_t *txn, uint32_t offset)
+{
+  if (!IsStageable(offset))
+  {
+    return 0U;
+  }
+
+  if ((txn->loadedMask & REG_BIT(offset)) == 0U)
+  {
+    txn->shadow[REG_INDEX(offset)] = RccReadAt(txn->rccBase, offset);
+    txn->loadedMask |= REG_BIT(offset);
+    txn->reads++;
+  }
+  return txn->shadow[REG_INDEX(offset)];
+}
+
+/**
+ * @brief  Stages a full register value (no read needed)
+ * @param txn Transaction
+ * @param offset Register offset from RCC_BASE
+ * @param value Value to store on commit
+ */
+void RccTxn_Write(Rcc_Txn_t *txn, uint32_t offset, uint32_t value)
+{
+  if (IsStageable(offset))
+  {
+    txn->shadow[REG_INDEX(offset)] = value;
+    txn->loadedMask |= REG_BIT(offset);
+    txn->dirtyMask |= REG_BIT(offset);
+  }
+}
+
+/**
+ * @brief  Stages a read-modify-write of a register
+ * @param txn Transaction
+ * @param offset Register offset from RCC_BASE
+ * @param clearMask Bits to clear
+ * @param setMask Bits to set (applied after clearMask)
+ */
+void RccTxn_Modify(Rcc_Txn_t *txn, uint32_t offset, uint32_t clearMask, uint32_t setMask)
+{
+  if (IsStageable(offset))
+  {
+    RccTxn_Write(txn, offset, (RccTxn_Read(txn, offset) & ~clearMask) | setMask);
+  }
+}
+
+/**
+ * @brief  Writes the unlock keys at the start of the commit
+ */
+void RccTxn_Unlock(Rcc_Txn_t *txn)
+{
+  txn->isUnlockRequested = true;
+}
+
+/**
+ * @brief  Re-locks the RCC at the end of the commit
+ */
+void RccTxn_Lock(Rcc_Txn_t *txn)
+{
+  txn->isLockRequested = true;
+}
+
+/**
+ * @brief  Stores every staged register once, in manual order
+ * @note   Shadows are dropped afterwards because RCC_CR holds hardware
+ *         driven flags; the next RccTxn_Read() reads the register again.
+ * @param txn Transaction
+ */
+void RccTxn_Commit(Rcc_Txn_t *txn)
+{
+  if (txn->isUnlockRequested)
+  {
+    RccWriteAt(txn->rccBase, RCC_UNL_OFFSET, RccUnl_ToWrite(RccUnl_SetUnlock(RccUnl_Clear(), RCC_UNL_KEY)));
+    RccWriteAt(txn->rccBase, RCC_UNH_OFFSET, RccUnh_ToWrite(RccUnh_SetUnlock(RccUnh_Clear(), RCC_UNH_KEY)));
+    txn->writes += 2U;
+  }
+
+  for (uint32_t i = 0U; i < (sizeof(s_CommitOrder) / sizeof(s_CommitOrder[0])); i++)
+  {
+    uint32_t offset = s_CommitOrder[i];
+    if ((txn->dirtyMask & REG_BIT(offset)) != 0U)
+    {
+      RccWriteAt(txn->rccBase, offset, txn->shadow[REG_INDEX(offset)]);
+      txn->writes++;
+    }
+  }
+
+  if (txn->isLockRequested)
+  {
+    RccWriteAt(txn->rccBase, RCC_LOCK_OFFSET, RccLock_ToWrite(RccLock_SetLock(RccLock_Clear(), true)));
+    txn->writes++;
+  }
+
+  txn->loadedMask = 0U;
+  txn->dirtyMask = 0U;
+  txn->isUnlockRequested = false;
+  txn->isLockRequested = false;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file    rcc_txn.h
+ * @brief   Batched (shadow register) RCC writes
+ * @author  SMC
+ * @date    September 2025
+ *
+ * A transaction keeps a shadow copy of each RCC register it touches. Changes
+ * are staged in the shadows and RccTxn_Commit() then writes every changed
+ * register with a single store, in the order the reference manual requires.
+ * Each register is read at most once per transaction.
+ *
+ */
+
+#ifndef RCC_TXN__H
+#define RCC_TXN__H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RCC_TXN_NUM_REGS                 30U   /*!< RCC_CR (0x00) to RCC_CSR (0x74), one per word */
+
+/**
+ * @brief RCC transaction. Lives on the caller's stack.
+ */
+typedef struct
+{
+  uintptr_t rccBase;        /*!< RCC the transaction reads and writes                   */
+  uint32_t shadow[RCC_TXN_NUM_REGS];
+  uint32_t loadedMask;      /*!< Shadows holding the register value (bit = offset / 4)  */
+  uint32_t dirtyMask;       /*!< Shadows to store on commit                             */
+  bool isUnlockRequested;   /*!< Write the RCC_UNL/RCC_UNH keys before anything else    */
+  bool isLockRequested;     /*!< Write RCC_LOCK after everything else                   */
+  uint32_t reads;           /*!< Volatile reads done by this transaction                */
+  uint32_t writes;          /*!< Volatile writes done by this transaction               */
+} Rcc_Txn_t;
+
+void RccTxn_Begin(Rcc_Txn_t *txn);
+void RccTxn_BeginAt(Rcc_Txn_t *txn, uintptr_t rccBase);
+void RccTxn_SetShadow(Rcc_Txn_t *txn, uint32_t offset, uint32_t value);
+uint32_t RccTxn_Read(Rcc_Txn_t *txn, uint32_t offset);
+void RccTxn_Write(Rcc_Txn_t *txn, uint32_t offset, uint32_t value);
+void RccTxn_Modify(Rcc_Txn_t *txn, uint32_t offset, uint32_t clearMask, uint32_t setMask);
+void RccTxn_Unlock(Rcc_Txn_t *txn);
+void RccTxn_Lock(Rcc_Txn_t *txn);
+void RccTxn_Commit(Rcc_Txn_t *txn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RCC_TXN__H
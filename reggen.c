@@ -0,0 +1,601 @@
+/**
+ * @file    reggen.c
+ * @brief   Host generator of rcc_regs.h from the reference manual's register tables
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Reads the "### Registers" tables of SMC_40CR_ReferenceManual.md (register
+ * name and address, then one row per field: name, bits, R/W, reset value,
+ * description) and writes a header with, for every register:
+ *   - its offset from the first register, reset value and R/W masks;
+ *   - _POS/_MSK/_RESET for every field (RESERVED rows are left out);
+ *   - a value type Rcc_Xxx_t and inline accessors on it. Fields the manual
+ *     marks R only get a getter, fields marked W only get a setter, so a
+ *     read of LOCK or a write of CLKSEL does not compile. FromRead() exists
+ *     only for registers with a readable field, ToWrite() only for those
+ *     with a writable one;
+ *   - the "Max time taken ... is N CPU cycles" limits of the descriptions as
+ *     RCC_REG_<REG>_<FIELD>_MAX_CYCLES.
+ * RCC_REG_RESET_TABLE lists the reset value of every register for the
+ * simulator.
+ *
+ * The tables are checked on the way: fields must not overlap, must fit in 32
+ * bits, and reset values must fit in their field.
+ *
+ * Usage: reggen <manual> [<header>]
+ *   Writes to stdout without <header>. rcc_regs.h in the tree is the output
+ *   for SMC_40CR_ReferenceManual.md and has to be regenerated when the
+ *   manual changes.
+ *
+ * Host tool, builds without the rest of the tree, e.g.
+ *   clang reggen.c -o reggen
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define REGGEN_MAX_REGS                  16U
+#define REGGEN_MAX_FIELDS                32U
+#define REGGEN_MAX_CELLS                 8U
+#define REGGEN_NAME_SIZE                 32U
+#define REGGEN_MACRO_SIZE                (sizeof("RCC_REG__") + (2U * REGGEN_NAME_SIZE) + sizeof("_MAX_CYCLES"))
+#define REGGEN_LINE_SIZE                 1024U
+
+/**
+ * @brief One field row of a register table
+ */
+typedef struct
+{
+  char name[REGGEN_NAME_SIZE];      /*!< e.g. "SYS_DIV"                     */
+  char camel[REGGEN_NAME_SIZE];     /*!< e.g. "SysDiv"                      */
+  uint32_t lsb;
+  uint32_t width;
+  bool isReadable;
+  bool isWritable;
+  uint32_t resetValue;
+  uint32_t maxCycles;               /*!< Timing limit, 0 if none            */
+} Reggen_Field_t;
+
+/**
+ * @brief One register table
+ */
+typedef struct
+{
+  char name[REGGEN_NAME_SIZE];      /*!< Without "RCC_", e.g. "PLLCFGR"     */
+  char camel[REGGEN_NAME_SIZE];     /*!< e.g. "Pllcfgr"                     */
+  uint64_t address;
+  uint32_t numFields;
+  Reggen_Field_t fields[REGGEN_MAX_FIELDS];
+} Reggen_Reg_t;
+
+/**
+ * @brief  Copies a table cell without markdown escapes and surrounding blanks
+ */
+static void CopyCell(char *dest, size_t size, const char *cell)
+{
+  while (isspace((unsigned char)*cell))
+  {
+    cell++;
+  }
+
+  size_t length = 0U;
+  for (; (*cell != '\0') && (length + 1U < size); cell++)
+  {
+    if ((*cell != '\\') && (*cell != '*'))
+    {
+      dest[length++] = *cell;
+    }
+  }
+  while ((length > 0U) && isspace((unsigned char)dest[length - 1U]))
+  {
+    length--;
+  }
+  dest[length] = '\0';
+}
+
+/**
+ * @brief  Splits a table row at '|' (the closing '|' is optional)
+ * @retval Number of cells, 0 if the line is not a table row
+ */
+static uint32_t SplitRow(char *line, char *cells[REGGEN_MAX_CELLS])
+{
+  if (line[0] != '|')
+  {
+    return 0U;
+  }
+
+  uint32_t count = 0U;
+  char *cell = line + 1;
+  while ((count < REGGEN_MAX_CELLS) && (*cell != '\0') && (*cell != '\n') && (*cell != '\r'))
+  {
+    char *end = strchr(cell, '|');
+    if (end != NULL)
+    {
+      *end = '\0';
+    }
+    cells[count++] = cell;
+    if (end == NULL)
+    {
+      break;
+    }
+    cell = end + 1;
+  }
+  return count;
+}
+
+/**
+ * @brief  "SYS_DIV" -> "SysDiv"
+ */
+static void ToCamel(char *dest, const char *name)
+{
+  bool isUpper = true;
+  for (; *name != '\0'; name++)
+  {
+    if (*name == '_')
+    {
+      isUpper = true;
+      continue;
+    }
+    *dest++ = isUpper ? (char)toupper((unsigned char)*name) : (char)tolower((unsigned char)*name);
+    isUpper = false;
+  }
+  *dest = '\0';
+}
+
+/**
+ * @brief  Parses "31" or "12-30" (either order)
+ */
+static bool ParseBits(const char *text, uint32_t *lsb, uint32_t *width)
+{
+  char *end = NULL;
+  unsigned long first = strtoul(text, &end, 10);
+  if (end == text)
+  {
+    return false;
+  }
+  unsigned long last = first;
+  if (*end == '-')
+  {
+    const char *second = end + 1;
+    last = strtoul(second, &end, 10);
+    if (end == second)
+    {
+      return false;
+    }
+  }
+  if ((*end != '\0') || (first > 31UL) || (last > 31UL))
+  {
+    return false;
+  }
+
+  *lsb = (uint32_t)((first < last) ? first : last);
+  *width = (uint32_t)(((first < last) ? last - first : first - last) + 1UL);
+  return true;
+}
+
+/**
+ * @brief  Parses "RW", "R" or "W"
+ */
+static bool ParseAccess(const char *text, bool *isReadable, bool *isWritable)
+{
+  *isReadable = (strcmp(text, "RW") == 0) || (strcmp(text, "R") == 0);
+  *isWritable = (strcmp(text, "RW") == 0) || (strcmp(text, "W") == 0);
+  return *isReadable || *isWritable;
+}
+
+/**
+ * @brief  Parses a reset value: "All 0", "All 1", binary digits for a field
+ *         wider than one bit ("01"), "0x..." or decimal
+ */
+static bool ParseReset(const char *text, uint32_t width, uint32_t *value)
+{
+  uint32_t fieldMask = (width >= 32U) ? UINT32_MAX : ((1UL << width) - 1UL);
+  if (strcmp(text, "All 0") == 0)
+  {
+    *value = 0U;
+    return true;
+  }
+  if (strcmp(text, "All 1") == 0)
+  {
+    *value = fieldMask;
+    return true;
+  }
+
+  bool isBinary = (width > 1U) && (text[0] != '\0') && (strspn(text, "01") == strlen(text));
+  char *end = NULL;
+  unsigned long parsed = strtoul(text, &end, isBinary ? 2 : 0);
+  if ((end == text) || (*end != '\0') || (parsed > fieldMask))
+  {
+    return false;
+  }
+  *value = (uint32_t)parsed;
+  return true;
+}
+
+/**
+ * @brief  Finds "Max time taken ... is N CPU cycles" in a description
+ * @retval N, 0 if there is no such limit
+ */
+static uint32_t ParseMaxCycles(const char *description)
+{
+  const char *text = strstr(description, "Max time taken");
+  const char *is = (text != NULL) ? strstr(text, " is ") : NULL;
+  if (is == NULL)
+  {
+    return 0U;
+  }
+
+  char *end = NULL;
+  unsigned long cycles = strtoul(is + 4, &end, 10);
+  return ((end != is + 4) && (strncmp(end, " CPU cycles", 11U) == 0)) ? (uint32_t)cycles : 0U;
+}
+
+/**
+ * @brief  Starts a register from its title row, "| RCC_CR | Address: 0x... |"
+ */
+static bool ParseTitle(char *cells[], uint32_t numCells, Reggen_Reg_t *reg)
+{
+  char name[REGGEN_NAME_SIZE];
+  char address[REGGEN_NAME_SIZE];
+  if (numCells < 2U)
+  {
+    return false;
+  }
+  CopyCell(name, sizeof(name), cells[0]);
+  CopyCell(address, sizeof(address), cells[1]);
+  if ((strncmp(name, "RCC_", 4U) != 0) || (strncmp(address, "Address:", 8U) != 0))
+  {
+    return false;
+  }
+
+  char *end = NULL;
+  memset(reg, 0, sizeof(*reg));
+  reg->address = strtoull(address + 8, &end, 16);
+  snprintf(reg->name, sizeof(reg->name), "%s", name + 4);
+  ToCamel(reg->camel, reg->name);
+  return (end != address + 8) && (*end == '\0');
+}
+
+/**
+ * @brief  Adds a field row, RESERVED rows only take part in the overlap check
+ * @retval 1 if added or reserved, 0 if the row is not a field row, -1 on error
+ */
+static int32_t ParseField(char *cells[], uint32_t numCells, Reggen_Reg_t *reg, uint32_t *usedBits,
+                          const char *path, uint32_t lineNumber)
+{
+  char name[REGGEN_NAME_SIZE];
+  char bits[REGGEN_NAME_SIZE];
+  char access[REGGEN_NAME_SIZE];
+  char reset[REGGEN_NAME_SIZE];
+  if (numCells < 5U)
+  {
+    return 0;
+  }
+  CopyCell(name, sizeof(name), cells[0]);
+  CopyCell(bits, sizeof(bits), cells[1]);
+  CopyCell(access, sizeof(access), cells[2]);
+  CopyCell(reset, sizeof(reset), cells[3]);
+
+  Reggen_Field_t field;
+  memset(&field, 0, sizeof(field));
+  if (!ParseBits(bits, &field.lsb, &field.width) || !ParseAccess(access, &field.isReadable, &field.isWritable))
+  {
+    return 0;   // Header or note row
+  }
+
+  uint32_t mask = ((field.width >= 32U) ? UINT32_MAX : ((1UL << field.width) - 1UL)) << field.lsb;
+  if ((field.lsb + field.width > 32U) || ((*usedBits & mask) != 0U))
+  {
+    fprintf(stderr, "%s:%u: RCC_%s %s overlaps another field\n", path, lineNumber, reg->name, name);
+    return -1;
+  }
+  *usedBits |= mask;
+  if (strcmp(name, "RESERVED") == 0)
+  {
+    return 1;
+  }
+
+  if (!ParseReset(reset, field.width, &field.resetValue))
+  {
+    fprintf(stderr, "%s:%u: RCC_%s %s reset value \"%s\" does not fit %u bits\n", path, lineNumber, reg->name,
+            name, reset, field.width);
+    return -1;
+  }
+  if (reg->numFields >= REGGEN_MAX_FIELDS)
+  {
+    fprintf(stderr, "%s:%u: RCC_%s has too many fields\n", path, lineNumber, reg->name);
+    return -1;
+  }
+
+  snprintf(field.name, sizeof(field.name), "%s", name);
+  ToCamel(field.camel, field.name);
+  field.maxCycles = ParseMaxCycles(cells[4]);
+  reg->fields[reg->numFields++] = field;
+  return 1;
+}
+
+/**
+ * @brief  Reads every register table of the manual
+ * @retval Number of registers, 0 on error
+ */
+static uint32_t LoadManual(const char *path, Reggen_Reg_t *regs)
+{
+  FILE *file = fopen(path, "r");
+  if (file == NULL)
+  {
+    fprintf(stderr, "Cannot open %s\n", path);
+    return 0U;
+  }
+
+  char line[REGGEN_LINE_SIZE];
+  uint32_t numRegs = 0U;
+  uint32_t lineNumber = 0U;
+  uint32_t usedBits = 0U;
+  Reggen_Reg_t *current = NULL;
+  bool isValid = true;
+  while (isValid && (fgets(line, sizeof(line), file) != NULL))
+  {
+    lineNumber++;
+    char *cells[REGGEN_MAX_CELLS];
+    uint32_t numCells = SplitRow(line, cells);
+    if (numCells == 0U)
+    {
+      current = NULL;   // A table ends at the first line that is not a row
+      continue;
+    }
+
+    if ((current == NULL) && (numRegs < REGGEN_MAX_REGS) && ParseTitle(cells, numCells, &regs[numRegs]))
+    {
+      current = &regs[numRegs++];
+      usedBits = 0U;
+    }
+    else if (current != NULL)
+    {
+      isValid = (ParseField(cells, numCells, current, &usedBits, path, lineNumber) >= 0);
+    }
+  }
+  (void)fclose(file);
+
+  for (uint32_t i = 0U; isValid && (i < numRegs); i++)
+  {
+    if ((regs[i].numFields == 0U) || (regs[i].address < regs[0].address))
+    {
+      fprintf(stderr, "%s: RCC_%s has no fields or lies below RCC_%s\n", path, regs[i].name, regs[0].name);
+      isValid = false;
+    }
+  }
+  if (isValid && (numRegs == 0U))
+  {
+    fprintf(stderr, "%s: no register tables found\n", path);
+  }
+  return isValid ? numRegs : 0U;
+}
+
+static uint32_t FieldMask(const Reggen_Field_t *field)
+{
+  return ((field->width >= 32U) ? UINT32_MAX : ((1UL << field->width) - 1UL)) << field->lsb;
+}
+
+/**
+ * @brief  Masks and values of a register, combined over its fields
+ */
+static void GetRegMasks(const Reggen_Reg_t *reg, uint32_t *resetValue, uint32_t *readMask, uint32_t *writeMask)
+{
+  *resetValue = 0U;
+  *readMask = 0U;
+  *writeMask = 0U;
+  for (uint32_t i = 0U; i < reg->numFields; i++)
+  {
+    const Reggen_Field_t *field = &reg->fields[i];
+    *resetValue |= field->resetValue << field->lsb;
+    *readMask |= field->isReadable ? FieldMask(field) : 0U;
+    *writeMask |= field->isWritable ? FieldMask(field) : 0U;
+  }
+}
+
+static void WriteDefine(FILE *out, const char *name, const char *value, const char *comment)
+{
+  if (comment != NULL)
+  {
+    fprintf(out, "#define %-40s %-14s /*!< %s */\n", name, value, comment);
+  }
+  else
+  {
+    fprintf(out, "#define %-40s %s\n", name, value);
+  }
+}
+
+/**
+ * @brief  Builds RCC_REG_<reg>[_<field>]_<suffix>
+ * @note   Register and field names are cut to REGGEN_NAME_SIZE when parsed,
+ *         so this always fits; should it not, the generator stops rather than
+ *         write a wrong name.
+ * @param name REGGEN_MACRO_SIZE characters
+ * @param field NULL for a register macro
+ */
+static void MakeName(char *name, const char *reg, const char *field, const char *suffix)
+{
+  int length = snprintf(name, REGGEN_MACRO_SIZE, "RCC_REG_%s%s%s_%s", reg, (field != NULL) ? "_" : "",
+                        (field != NULL) ? field : "", suffix);
+  if ((length < 0) || ((size_t)length >= REGGEN_MACRO_SIZE))
+  {
+    fprintf(stderr, "Macro name for RCC_%s %s does not fit %u characters\n", reg, (field != NULL) ? field : "",
+            (unsigned int)REGGEN_MACRO_SIZE);
+    exit(1);
+  }
+}
+
+static void WriteHexDefine(FILE *out, const char *reg, const char *field, const char *suffix, uint32_t value,
+                           const char *comment)
+{
+  char name[REGGEN_MACRO_SIZE];
+  char text[32];
+  MakeName(name, reg, field, suffix);
+  snprintf(text, sizeof(text), "0x%08lXUL", (unsigned long)value);
+  WriteDefine(out, name, text, comment);
+}
+
+/**
+ * @brief  Field accessors of one register
+ */
+static void WriteAccessors(FILE *out, const Reggen_Reg_t *reg, uint32_t readMask, uint32_t writeMask)
+{
+  const char *type = reg->camel;
+  fprintf(out, "/**\n * @brief RCC_%s value, only changed through the accessors below\n */\n", reg->name);
+  fprintf(out, "typedef struct {\n  uint32_t value;\n} Rcc_%s_t;\n\n", type);
+
+  fprintf(out, "static inline Rcc_%s_t Rcc%s_Reset(void)\n{\n", type, type);
+  fprintf(out, "  Rcc_%s_t reg = { RCC_REG_%s_RESET };\n  return reg;\n}\n\n", type, reg->name);
+  fprintf(out, "static inline Rcc_%s_t Rcc%s_Clear(void)\n{\n", type, type);
+  fprintf(out, "  Rcc_%s_t reg = { 0UL };\n  return reg;\n}\n\n", type);
+  if (readMask != 0U)
+  {
+    fprintf(out, "static inline Rcc_%s_t Rcc%s_FromRead(uint32_t value)\n{\n", type, type);
+    fprintf(out, "  Rcc_%s_t reg = { value };\n  return reg;\n}\n\n", type);
+  }
+  if (writeMask != 0U)
+  {
+    fprintf(out, "static inline uint32_t Rcc%s_ToWrite(Rcc_%s_t reg)\n{\n  return reg.value;\n}\n\n", type, type);
+  }
+
+  for (uint32_t i = 0U; i < reg->numFields; i++)
+  {
+    const Reggen_Field_t *field = &reg->fields[i];
+    const char *valueType = (field->width == 1U) ? "bool" : "uint32_t";
+    if (field->isReadable)
+    {
+      fprintf(out, "static inline %s Rcc%s_Get%s(Rcc_%s_t reg)\n{\n", valueType, type, field->camel, type);
+      if (field->width == 1U)
+      {
+        fprintf(out, "  return ((reg.value & RCC_REG_%s_%s_MSK) != 0UL);\n}\n\n", reg->name, field->name);
+      }
+      else
+      {
+        fprintf(out, "  return (reg.value & RCC_REG_%s_%s_MSK) >> RCC_REG_%s_%s_POS;\n}\n\n", reg->name, field->name,
+                reg->name, field->name);
+      }
+    }
+    if (field->isWritable)
+    {
+      fprintf(out, "static inline Rcc_%s_t Rcc%s_Set%s(Rcc_%s_t reg, %s value)\n{\n", type, type, field->camel, type,
+              valueType);
+      fprintf(out, "  reg.value = (reg.value & ~RCC_REG_%s_%s_MSK) |\n", reg->name, field->name);
+      fprintf(out, "              (((uint32_t)value << RCC_REG_%s_%s_POS) & RCC_REG_%s_%s_MSK);\n  return reg;\n}\n\n",
+              reg->name, field->name, reg->name, field->name);
+    }
+  }
+}
+
+static void WriteHeader(FILE *out, const char *manualPath, const Reggen_Reg_t *regs, uint32_t numRegs)
+{
+  fprintf(out,
+          "/**\n"
+          " * @file    rcc_regs.h\n"
+          " * @brief   RCC register fields, reset values, timing limits and typed accessors\n"
+          " * @author  SMC\n"
+          " * @date    September 2025\n"
+          " *\n"
+          " * Generated by reggen.c from %s. Do not edit, run\n"
+          " *   reggen %s rcc_regs.h\n"
+          " * instead. See reggen.c for what is generated.\n"
+          " *\n"
+          " */\n\n"
+          "#ifndef RCC_REGS__H\n#define RCC_REGS__H\n\n"
+          "#include <stdint.h>\n#include <stdbool.h>\n\n"
+          "#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n",
+          manualPath, manualPath);
+
+  for (uint32_t r = 0U; r < numRegs; r++)
+  {
+    const Reggen_Reg_t *reg = &regs[r];
+    uint32_t resetValue;
+    uint32_t readMask;
+    uint32_t writeMask;
+    GetRegMasks(reg, &resetValue, &readMask, &writeMask);
+
+    char name[REGGEN_MACRO_SIZE];
+    char text[32];
+    fprintf(out, "/* RCC_%s -------------------------------------------------------------- */\n", reg->name);
+    MakeName(name, reg->name, NULL, "OFFSET");
+    snprintf(text, sizeof(text), "0x%02lXUL", (unsigned long)(reg->address - regs[0].address));
+    WriteDefine(out, name, text, NULL);
+    WriteHexDefine(out, reg->name, NULL, "RESET", resetValue, NULL);
+    WriteHexDefine(out, reg->name, NULL, "READ_MASK", readMask, NULL);
+    WriteHexDefine(out, reg->name, NULL, "WRITE_MASK", writeMask, NULL);
+    for (uint32_t i = 0U; i < reg->numFields; i++)
+    {
+      const Reggen_Field_t *field = &reg->fields[i];
+      const char *access = field->isReadable ? (field->isWritable ? "RW" : "R") : "W";
+      char comment[48];
+      MakeName(name, reg->name, field->name, "POS");
+      snprintf(text, sizeof(text), "%uUL", field->lsb);
+      snprintf(comment, sizeof(comment), "%s, %u bit%s", access, field->width, (field->width == 1U) ? "" : "s");
+      WriteDefine(out, name, text, comment);
+      WriteHexDefine(out, reg->name, field->name, "MSK", FieldMask(field), NULL);
+      MakeName(name, reg->name, field->name, "RESET");
+      snprintf(text, sizeof(text), "%uUL", field->resetValue);
+      WriteDefine(out, name, text, NULL);
+      if (field->maxCycles != 0U)
+      {
+        MakeName(name, reg->name, field->name, "MAX_CYCLES");
+        snprintf(text, sizeof(text), "%uUL", field->maxCycles);
+        WriteDefine(out, name, text, "CPU cycles");
+      }
+    }
+    fprintf(out, "\n");
+    WriteAccessors(out, reg, readMask, writeMask);
+  }
+
+  fprintf(out,
+          "/**\n"
+          " * @brief Reset value of one register\n"
+          " */\n"
+          "typedef struct {\n"
+          "  uint32_t offset;\n"
+          "  uint32_t value;\n"
+          "} Rcc_Reg_Reset_t;\n\n");
+  fprintf(out, "#define RCC_REG_COUNT                            %uU\n", numRegs);
+  fprintf(out, "#define RCC_REG_RESET_TABLE                      {");
+  for (uint32_t r = 0U; r < numRegs; r++)
+  {
+    fprintf(out, " \\\n  { RCC_REG_%s_OFFSET, RCC_REG_%s_RESET },", regs[r].name, regs[r].name);
+  }
+  fprintf(out, " \\\n}\n\n#ifdef __cplusplus\n}\n#endif\n\n#endif // RCC_REGS__H\n");
+}
+
+int32_t main(int argc, char **argv)
+{
+  if ((argc < 2) || (argc > 3))
+  {
+    fprintf(stderr, "Usage: %s <manual> [<header>]\n", argv[0]);
+    return 2;
+  }
+
+  static Reggen_Reg_t regs[REGGEN_MAX_REGS];
+  uint32_t numRegs = LoadManual(argv[1], regs);
+  if (numRegs == 0U)
+  {
+    return 1;
+  }
+
+  FILE *out = (argc == 3) ? fopen(argv[2], "w") : stdout;
+  if (out == NULL)
+  {
+    fprintf(stderr, "Cannot create %s\n", argv[2]);
+    return 2;
+  }
+
+  // Only the file name goes into the header, so the output does not depend
+  // on where the tool was run from
+  const char *manualName = strrchr(argv[1], '/');
+  WriteHeader(out, (manualName != NULL) ? manualName + 1 : argv[1], regs, numRegs);
+  if (out != stdout)
+  {
+    (void)fclose(out);
+  }
+  return 0;
+}
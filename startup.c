@@ -11,219 +11,1216 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "SMC_40CR.h"
+#include <stddef.h>
+#include "rcc_access.h"
+#include "rcc_txn.h"
+#include "rcc_owner.h"
+#include "clock_notify.h"
+#include "cycle_counter.h"
+#include "clock_profile.h"
 #include "startup.h"
 
-#define CLKSEL_SWITCH_MAX_TIME_IN_CYCLES     500UL
-#define HSIRDY_MAX_TIME_IN_CYCLES            1400UL
-#define HSERDY_MAX_TIME_IN_CYCLES            4200UL
-#define RCC_CR_HSION                         (1UL << RCC_CR_HSION_Pos)  
+#define FALLBACK_SLACK_CYCLES                64UL    // Register accesses around the waits
 
-uint32_t g_PllReadyTimeoutCycles = 350;
+uint32_t g_PllReadyTimeoutCycles = RCC_REG_CR_PLL_RDY_MAX_CYCLES;
+
+// SMC_40CR.h is written by hand; stop the build if it disagrees with the
+// manual (rcc_regs.h)
+_Static_assert((RCC_CR_DEF_CLOCK == RCC_REG_CR_DEF_CLOCK_MSK) && (RCC_CR_PLL_RDY == RCC_REG_CR_PLL_RDY_MSK) &&
+               (RCC_CR_SYS_DIV == RCC_REG_CR_SYS_DIV_MSK) && (RCC_CR_BUS_DIV == RCC_REG_CR_BUS_DIV_MSK) &&
+               (RCC_CR_PLLON == RCC_REG_CR_PLLON_MSK) && (RCC_CR_CLKSEL == RCC_REG_CR_CLKSEL_MSK) &&
+               (RCC_CR_HSERDY == RCC_REG_CR_HSERDY_MSK) && (RCC_CR_HSEON == RCC_REG_CR_HSEON_MSK) &&
+               (RCC_CR_HSIRDY == RCC_REG_CR_HSIRDY_MSK) && (RCC_CR_HSION == RCC_REG_CR_HSION_MSK),
+               "RCC_CR bits in SMC_40CR.h differ from the manual");
+_Static_assert((RCC_PLLCFGR_MUL == RCC_REG_PLLCFGR_MUL_MSK) && (RCC_PLLCFGR_DIV == RCC_REG_PLLCFGR_DIV_MSK),
+               "RCC_PLLCFGR bits in SMC_40CR.h differ from the manual");
+_Static_assert((RCC_UNL_UNLOCK == RCC_REG_UNL_UNLOCK_MSK) && (RCC_UNH_UNLOCK == RCC_REG_UNH_UNLOCK_MSK) &&
+               (RCC_LOCK_LOCK == RCC_REG_LOCK_LOCK_MSK) && (RCC_LOCK_LOCK_STATUS == RCC_REG_LOCK_LOCK_STATUS_MSK),
+               "RCC_UNL/UNH/LOCK bits in SMC_40CR.h differ from the manual");
+
+// Clock frequencies currently in effect. The RCC comes out of reset on DEF_CLOCK.
+uint32_t g_SystemClockHz = CLOCK_DEF_CLOCK_HZ;
+uint32_t g_BusClockHz = CLOCK_DEF_CLOCK_HZ;
+
+// Driver of the RCC at RCC_BASE, used by the functions without a driver argument
+static Clock_Driver_t s_Driver = { .rccBase = RCC_BASE, .lastStatus = CLOCK_ERROR_NOT_STARTED };
+
+// End of a switch, reported once the step guard is released
+typedef struct {
+  bool isPending;
+  int32_t status;
+  Clock_Switch_Callback_t callback;
+  void *context;
+  uint32_t ownerId;
+  bool isNotified;
+  Clock_Notify_Info_t notifyInfo;
+} Switch_Report_t;
+
+// Only the RCC at RCC_BASE feeds the profiler, which reads CycleCounter_Now()
+#define DRIVER_PROFILE_START(driver)          do { if (IsSystemRcc(driver)) { CLOCK_PROFILE_START(); } } while (0)
+#define DRIVER_PROFILE_MARK(driver, phase)    do { if (IsSystemRcc(driver)) { CLOCK_PROFILE_MARK(phase); } } while (0)
 
 /**
- * @brief  Configures the system and bus clock config based on what is provided
- * @note   This function assumes a 40MHz starting clock. (Note: This is required 
- *         for HSE, and for HSI the internal clock is always 40MHz starting out).
+ * @brief  Decodes a 2-bit SYS_DIV/BUS_DIV field (0b11 divides by 4 like 0b10)
+ */
+static uint32_t DecodeClockDivider(uint32_t field)
+{
+  return (field == 0U) ? 1U : ((field == 1U) ? 2U : 4U);
+}
+
+/**
+ * @brief  Validates the inputs and builds the register images for them
  * @param sysClockSpeed Desired system clock speed enum
- * @param busClockDivider Desired bus clock divider
- * @param isHsiClock If true, then desired to use the internal HSI clock. If false, then use external HSE clock.
- * @retval 0 if success, -1 if timeout or error
+ * @param busClockDivider Desired bus clock divider (0 or 1 = no division, 2 or 4)
+ * @param isHsiClock If true use the internal HSI clock, otherwise the external HSE clock
+ * @param config Filled in with the register images
+ * @retval CLOCK_OK, CLOCK_ERROR_INVALID_ARG for an unknown speed or divider, or
+ *         CLOCK_ERROR_BUS_LIMIT if the bus clock would be above 20MHz
  */
-int32_t SetSystemAndBusClockConfig(System_Clock_Speeds_t sysClockSpeed, unsigned int BusClockDivider, bool isHsiClock)
+int32_t BuildClockConfig(System_Clock_Speeds_t sysClockSpeed, unsigned int busClockDivider,
+                         bool isHsiClock, Clock_Config_t *config)
 {
   // Validate the system clock speed
-  if ((sysClockSpeed > SYS_CLOCK_SPEED_MAX_ENUM_VAL) || (sysClockSpeed == SYS_CLOCK_SPEED_UNDEFINED))
+  if ((config == NULL) || (sysClockSpeed > SYS_CLOCK_SPEED_MAX_ENUM_VAL) ||
+      (sysClockSpeed == SYS_CLOCK_SPEED_UNDEFINED))
   {
-    return -1;
+    return CLOCK_ERROR_INVALID_ARG;
   }
 
-  // Validate the bus clock divider
-  unsigned int busClockRegVal = 0;
-  switch (BusClockDivider) {
-    case 0:
-      busClockRegVal = 0;
+  // BUS_DIV code
+  uint32_t busDiv = 0U;
+  switch (busClockDivider)
+  {
+    case 0: // No division
+    case 1:
+      busDiv = 0U;
       break;
 
     case 2: // Divide by 2
-      busClockRegVal = RCC_CR_BUS_DIV_0; // Set bits 7-8 to 0b01
+      busDiv = 1U;  // 0b01
       break;
-    
+
     case 4: // Divide by 4
-      busClockRegVal = RCC_CR_BUS_DIV_1; // Set bits 7-8 to 0b10
+      busDiv = 2U;  // 0b10
+      break;
+
+    default:
+      return CLOCK_ERROR_INVALID_ARG;
+  }
+
+  // PLL MUL/DIV and SYS_DIV codes for the desired clock speed. The PLL input
+  // is always 40MHz (HSI, or an HSE crystal which is required to be 40MHz).
+  uint32_t pllMul = 0U;
+  uint32_t pllDiv = 0U;
+  uint32_t sysDiv = 0U;
+  switch (sysClockSpeed)
+  {
+    case SYS_CLOCK_SPEED_160M:
+      pllMul = 2U;  // Multiply by 4 (0b010)
+      break;
+
+    case SYS_CLOCK_SPEED_80M:
+      pllMul = 1U;  // Multiply by 2 (0b001)
+      break;
+
+    case SYS_CLOCK_SPEED_40M:
+      break;        // Multiply and divide by 1
+
+    case SYS_CLOCK_SPEED_20M:
+      pllDiv = 1U;  // Divide by 2 (0b001)
       break;
 
-    default: // Invalid value, just set busClockRegVal to 0
-      busClockRegVal = 0;
+    case SYS_CLOCK_SPEED_10M:
+      pllDiv = 2U;  // Divide by 4 (0b010)
       break;
+
+    case SYS_CLOCK_SPEED_5M:
+      pllDiv = 4U;  // Divide by 8 (0b100)
+      break;
+
+    case SYS_CLOCK_SPEED_2_5M:
+      pllDiv = 4U;  // Divide by 8 and SYS_DIV of 2 (0b01)
+      sysDiv = 1U;
+      break;
+
+    case SYS_CLOCK_SPEED_1_25M:
+      pllDiv = 4U;  // Divide by 8 and SYS_DIV of 4 (0b10)
+      sysDiv = 2U;
+      break;
+
+    case SYS_CLOCK_SPEED_UNDEFINED:
+    default:
+      return CLOCK_ERROR_INVALID_ARG;
   }
 
-  // If everything is valid up to this point, unlock the RCC registers
-  RCC_UNL = 0x56DD;
-  RCC_UNH = 0xA3B2;
+  config->pllcfgr = RccPllcfgr_ToWrite(RccPllcfgr_SetDiv(RccPllcfgr_SetMul(RccPllcfgr_Clear(), pllMul), pllDiv));
+  config->crDividers = RccCr_ToWrite(RccCr_SetBusDiv(RccCr_SetSysDiv(RccCr_Clear(), sysDiv), busDiv));
+  config->isHsiClock = isHsiClock;
 
-  // If the current clock is not the default clock, then we need to switch it
-  // before proceeding
-  volatile uint32_t rccCrReg = RCC_CR;
-  if ((rccCrReg & RCC_CR_CLKSEL) != 0)
+  // The manual requires the bus clock to be 20MHz or less. Reject the request
+  // here rather than letting the RCC fall back to DEF_CLOCK.
+  if (GetClockConfigBusClockHz(config) > CLOCK_MAX_BUS_CLOCK_HZ)
   {
-    // Clock is not default clock. Fix it and wait for CLKSEL to show 0b00 indicating DEF_CLOCK is selected
-    RCC_CR |= RCC_CR_DEF_CLOCK;
-    while (1)
-    {
-      rccCrReg = RCC->CR;
-      if ((rccCrReg & RCC_CR_CLKSEL) == 0)
-      {
-        // Exit the loop 
-        break;
-      }
-    }
+    return CLOCK_ERROR_BUS_LIMIT;
   }
+  return CLOCK_OK;
+}
 
-  // Ensure the LOCK_STATUS bit shows unlocked
-  uint32_t RccLockReg = RCC_LOCK;
-  if ((RccLockReg & RCC_LOCK_LOCK_STATUS) != 0U) 
+/**
+ * @brief  Returns the system clock a configuration produces
+ * @note   PLL MUL and DIV codes not listed in the manual multiply or divide by 1.
+ * @param config Register images
+ * @retval System clock in Hz (40MHz * MUL / DIV / SYS_DIV)
+ */
+uint32_t GetClockConfigSysClockHz(const Clock_Config_t *config)
+{
+  uint32_t mul = 1U;
+  switch ((config->pllcfgr & RCC_PLLCFGR_MUL) >> RCC_PLLCFGR_MUL_Pos)
   {
-    return -1;
+    case 1U: mul = 2U; break;
+    case 2U: mul = 4U; break;
+    default: mul = 1U; break;
   }
 
-  // Configure PLL and SYS Clock divider for the desired clock speed
-  // Start out by setting the SYS_DIV and BUS_DIV to 0. Also zero out the PLL register
-  RCC->CR = (RCC->CR & ~RCC_CR_BUS_DIV);
-  RCC->CR = (RCC->CR & ~RCC_CR_SYS_DIV);
-  RCC_PLLCFGR = 0;
-  switch (sysClockSpeed) 
+  uint32_t div = 1U;
+  switch ((config->pllcfgr & RCC_PLLCFGR_DIV) >> RCC_PLLCFGR_DIV_Pos)
   {
-    case SYS_CLOCK_SPEED_160M:
-      // Set a PLL Multiplication factor of 4 to get 160M (0b010 for MUL bits)
-      RCC_PLLCFGR = (RCC_PLLCFGR & ~RCC_PLLCFGR_MUL) | RCC_PLLCFGR_MUL_1;
-      break;
+    case 1U: div = 2U; break;
+    case 2U: div = 4U; break;
+    case 4U: div = 8U; break;
+    default: div = 1U; break;
+  }
 
-    case SYS_CLOCK_SPEED_80M: 
-      // Set a PLL Multiplication factor of 2 to get 80M (0b001)
-      RCC_PLLCFGR = (RCC_PLLCFGR & ~RCC_PLLCFGR_MUL) | RCC_PLLCFGR_MUL_0;
-      break;
+  uint32_t sysDiv = DecodeClockDivider((config->crDividers & RCC_CR_SYS_DIV) >> RCC_CR_SYS_DIV_Pos);
+  return (CLOCK_PLL_INPUT_HZ * mul) / div / sysDiv;
+}
 
-    case SYS_CLOCK_SPEED_40M: 
-      // Set a PLL Multiplication factor of 1. Nothing to do!
-      break;
+/**
+ * @brief  Returns the bus clock a configuration produces
+ * @param config Register images
+ * @retval Bus clock in Hz (system clock / BUS_DIV)
+ */
+uint32_t GetClockConfigBusClockHz(const Clock_Config_t *config)
+{
+  uint32_t busDiv = DecodeClockDivider((config->crDividers & RCC_CR_BUS_DIV) >> RCC_CR_BUS_DIV_Pos);
+  return GetClockConfigSysClockHz(config) / busDiv;
+}
 
-        case SYS_CLOCK_SPEED_20M:
-          // Set a PLL Division factor of 2 (0b001)
-          RCC_PLLCFGR = (RCC_PLLCFGR & ~RCC_PLLCFGR_DIV) | RCC_PLLCFGR_DIV_0;
-          break;
+/**
+ * @brief  RCC_CR enable bit of the oscillator a configuration runs from
+ */
+static uint32_t OscOnBit(const Clock_Config_t *config)
+{
+  return config->isHsiClock ? RCC_CR_HSION : RCC_CR_HSEON;
+}
 
-      case SYS_CLOCK_SPEED_10M: 
-        // Set a PLL Division factor of 4 (0b010)
-        RCC_PLLCFGR = (RCC_PLLCFGR & ~RCC_PLLCFGR_DIV) | RCC_PLLCFGR_DIV_1;
-        break;
+/**
+ * @brief  RCC_CR ready flag of the oscillator a configuration runs from
+ */
+static uint32_t OscReadyBit(const Clock_Config_t *config)
+{
+  return config->isHsiClock ? RCC_CR_HSIRDY : RCC_CR_HSERDY;
+}
 
-    case SYS_CLOCK_SPEED_5M: 
-      // Set a PLL Division factor of 8 (0b100)
-      RCC_PLLCFGR = (RCC_PLLCFGR & ~RCC_PLLCFGR_DIV) | RCC_PLLCFGR_DIV_2;
-      break;
+/**
+ * @brief  RCC_CR enable bit of the oscillator a configuration does not use
+ */
+static uint32_t OtherOscOnBit(const Clock_Config_t *config)
+{
+  return config->isHsiClock ? RCC_CR_HSEON : RCC_CR_HSION;
+}
 
-    case SYS_CLOCK_SPEED_2_5M:      
-      // Set a PLL Division factor of 8 and SYS_DIV value of 2 (0b01)
-      RCC_PLLCFGR = (RCC_PLLCFGR & ~RCC_PLLCFGR_DIV) | RCC_PLLCFGR_DIV_2;
-      RCC_CR |= RCC_CR_SYS_DIV_0;
-      break;
+/**
+ * @brief  Max start-up time of the oscillator a configuration runs from
+ */
+static uint32_t OscReadyTimeout(const Clock_Config_t *config)
+{
+  return config->isHsiClock ? HSIRDY_MAX_TIME_IN_CYCLES : HSERDY_MAX_TIME_IN_CYCLES;
+}
 
-      case SYS_CLOCK_SPEED_1_25M:  
-        // Set a PLL Division factor of 8 and SYS_DIV value of 4 (0b10)
-        RCC_PLLCFGR = (RCC_PLLCFGR & ~RCC_PLLCFGR_DIV) | RCC_PLLCFGR_DIV_2;
-        RCC_CR |= RCC_CR_SYS_DIV_1;
-        break;
+/**
+ * @brief  CLKSEL value once the configuration is active (0b01 = HSI, 0b10 = HSE)
+ */
+static uint32_t ClkselValue(const Clock_Config_t *config)
+{
+  return config->isHsiClock ? RCC_CR_CLKSEL_0 : RCC_CR_CLKSEL_1;
+}
 
-    case SYS_CLOCK_SPEED_UNDEFINED:   
-    default:
-      // Should never have got here since we already checked this. 
-      // Should probably error out here
-      break;
+/**
+ * @brief  Checks whether RCC_CR shows the system running from the PLL on the
+ *         oscillator the configuration asks for
+ */
+static bool IsRunningFromSource(uint32_t rccCrReg, const Clock_Config_t *config)
+{
+  uint32_t required = ClkselValue(config) | OscReadyBit(config) | RCC_CR_PLL_RDY;
+  uint32_t mask = RCC_CR_DEF_CLOCK | RCC_CR_CLKSEL | OscReadyBit(config) | RCC_CR_PLL_RDY;
+  return ((rccCrReg & mask) == required);
+}
+
+/**
+ * @brief  True for a driver of the RCC at RCC_BASE, the one other code shares
+ */
+static bool IsSystemRcc(const Clock_Driver_t *driver)
+{
+  return (driver->rccBase == RCC_BASE);
+}
+
+/**
+ * @brief  Reads LOCK_STATUS, 1 while the RCC registers are locked
+ */
+static bool IsRccLocked(const Clock_Driver_t *driver)
+{
+  return RccLock_GetLockStatus(RccLock_FromRead(RccReadAt(driver->rccBase, RCC_LOCK_OFFSET)));
+}
+
+/**
+ * @brief  Locks the RCC registers again with a single store
+ */
+static void RelockRcc(const Clock_Driver_t *driver)
+{
+  RccWriteAt(driver->rccBase, RCC_LOCK_OFFSET, RccLock_ToWrite(RccLock_SetLock(RccLock_Clear(), true)));
+}
+
+/**
+ * @brief  Changes SYS_DIV/BUS_DIV while staying on the current HSI/HSE source
+ * @note   The PLL and the oscillator keep running, so this is one unlock, one
+ *         store and one read-back instead of a full switch.
+ * @retval CLOCK_OK on success, otherwise a negative Clock_Status_t
+ */
+static int32_t ApplyDividersOnly(Clock_Driver_t *driver, uint32_t rccCrReg, const Clock_Config_t *config)
+{
+  Rcc_Txn_t txn;
+  RccTxn_BeginAt(&txn, driver->rccBase);
+  RccTxn_Unlock(&txn);
+  RccTxn_SetShadow(&txn, RCC_CR_OFFSET, rccCrReg);
+  RccTxn_Modify(&txn, RCC_CR_OFFSET, RCC_CR_SYS_DIV | RCC_CR_BUS_DIV, config->crDividers);
+  RccTxn_Commit(&txn);
+
+  // An invalid configuration makes the RCC fall back to DEF_CLOCK
+  rccCrReg = RccReadAt(driver->rccBase, RCC_CR_OFFSET);
+  if (!IsRunningFromSource(rccCrReg, config))
+  {
+    return CLOCK_ERROR_FALLBACK;
+  }
+  if ((rccCrReg & (RCC_CR_SYS_DIV | RCC_CR_BUS_DIV)) != config->crDividers)
+  {
+    return CLOCK_ERROR_LOCKED;
   }
 
-  // Turn on the PLL and wait for it to be ready. Max time to be ready
-  // is in CPU cycles so if we adhere to this value in a loop we'll be
-  // sure to have waited that long.
-  RCC_CR |= RCC_CR_PLLON;
-  bool isPllReady = false;
-                                  uint32_t timeoutCycles = 0U;
-  do
+  RelockRcc(driver);
+  return CLOCK_OK;
+}
+
+static void EnterState(Clock_Driver_t *driver, Clock_Switch_State_t state)
+{
+  driver->state = state;
+}
+
+/**
+ * @brief  Checks the ready flag of the current wait state once
+ * @param step Wait whose cycles are recorded once it ends
+ * @param rccCrReg Filled in with the RCC_CR value read
+ * @retval CYCLE_WAIT_DONE, CYCLE_WAIT_PENDING or CYCLE_WAIT_TIMEOUT
+ */
+static Cycle_Wait_Result_t PollWait(Clock_Driver_t *driver, Clock_Wait_Step_t step, uint32_t *rccCrReg)
+{
+  Cycle_Wait_Result_t result = CycleWait_Poll(&driver->wait, rccCrReg);
+  if (result != CYCLE_WAIT_PENDING)
+  {
+    driver->waitCycles[step] = driver->wait.elapsedCycles;
+  }
+  return result;
+}
+
+static void SetClockCache(Clock_Driver_t *driver, uint32_t sysClockHz, uint32_t busClockHz)
+{
+  if (IsSystemRcc(driver))
+  {
+    g_SystemClockHz = sysClockHz;
+    g_BusClockHz = busClockHz;
+  }
+  else
   {
-    rccCrReg = RCC_CR;
-    isPllReady = ((rccCrReg & RCC_CR_PLL_RDY) != 0);
-    timeoutCycles++;
-  } while (!isPllReady && (timeoutCycles < g_PllReadyTimeoutCycles));
+    driver->sysClockHz = sysClockHz;
+    driver->busClockHz = busClockHz;
+  }
+}
 
-  // Set the BUS_DIV value so the bus clock is correct. 
-  RCC_CR |= busClockRegVal;
+/**
+ * @brief  Timeout of the first oscillator wait
+ * @note   Without a budget this is the manual's limit. With one, the preferred
+ *         oscillator only gets the part of the budget that still leaves time
+ *         for the CLKSEL switch once the other oscillator has taken over.
+ */
+static uint32_t GetOscWaitTimeout(const Clock_Driver_t *driver, const Clock_Config_t *config)
+{
+  uint32_t timeout = OscReadyTimeout(config);
+  if (driver->budgetCycles != 0U)
+  {
+    uint32_t used = driver->oscStartCycles - driver->budgetStartCycles;
+    uint32_t reserve = used + CLKSEL_SWITCH_MAX_TIME_IN_CYCLES + FALLBACK_SLACK_CYCLES;
+    uint32_t share = (driver->budgetCycles > reserve) ? (driver->budgetCycles - reserve) : 0U;
+    timeout = (share < timeout) ? share : timeout;
+  }
+  return timeout;
+}
 
-  // Check if using internal or external clock
-  bool isClkReady = false;
-  if (isHsiClock)
+/**
+ * @brief  Tells the registered drivers the clocks are about to change
+ * @note   Called once per switch, before the first register write that can
+ *         change the system or bus clock. The registered drivers use the
+ *         RCC at RCC_BASE, so switches of other RCCs are not reported.
+ */
+static void NotifyPreChange(Clock_Driver_t *driver)
+{
+  if (!IsSystemRcc(driver))
   {
-    // Internal clock!
-    // Set HSION to 1 and wait for HSIRDY to be 1
-    // Then set DEF_CLOCK to 0 and wait for CLKSEL to be HSI
-    RCC_CR |= RCC_CR_HSEON;
-    timeoutCycles = 0U;
-    do
-    {
-      rccCrReg = RCC_CR;
-      isClkReady = ((rccCrReg & RCC_CR_HSIRDY) != 0);
-      timeoutCycles++;
-    } while (!isClkReady && (timeoutCycles < HSIRDY_MAX_TIME_IN_CYCLES));
+    return;
+  }
+
+  driver->notifyInfo.oldSysClockHz = g_SystemClockHz;
+  driver->notifyInfo.oldBusClockHz = g_BusClockHz;
+  driver->notifyInfo.newSysClockHz = GetClockConfigSysClockHz(&driver->config);
+  driver->notifyInfo.newBusClockHz = GetClockConfigBusClockHz(&driver->config);
+  driver->notifyInfo.status = CLOCK_IN_PROGRESS;
+  driver->isNotified = true;
+  ClockNotify_PreChange(&driver->notifyInfo);
+}
+
+/**
+ * @brief  Ends the switch in progress
+ * @note   On success the cached frequencies come from the requested
+ *         configuration; after a failure the RCC may be anywhere (e.g. fallen
+ *         back to DEF_CLOCK) so they are read back from the registers.
+ *         The notifiers, the callback and the token release are left in the
+ *         report for ReportSwitch(), once the step guard is released.
+ */
+static int32_t FinishClockSwitch(Clock_Driver_t *driver, Switch_Report_t *report, int32_t status)
+{
+  if (status == CLOCK_OK)
+  {
+    SetClockCache(driver, GetClockConfigSysClockHz(&driver->config), GetClockConfigBusClockHz(&driver->config));
+    driver->goodConfig = driver->config;
+    driver->hasGoodConfig = true;
   }
   else
   {
-    // External clock!
-    // Set HSEON to 1 and wait for HSERDY to be 1
-    RCC_CR |= RCC_CR_HSEON;
-    timeoutCycles = 0U;
-    do
-    {
-      rccCrReg = RCC_CR;
-      isClkReady = ((rccCrReg & RCC_CR_HSERDY) != 0);
-      timeoutCycles++;
-    } while (!isClkReady && (timeoutCycles < HSERDY_MAX_TIME_IN_CYCLES));
+    // Never leave the RCC unlocked after a failed switch
+    RelockRcc(driver);
+    ClockDriver_Update(driver);
   }
 
-  // If neither hsi nor hse is ready then exit out!
-  if (!isClkReady)
+  *report = (Switch_Report_t){ .isPending = true,
+                               .status = status,
+                               .callback = driver->callback,
+                               .context = driver->callbackContext,
+                               .ownerId = driver->ownerId,
+                               .isNotified = driver->isNotified,
+                               .notifyInfo = driver->notifyInfo };
+  report->notifyInfo.newSysClockHz = g_SystemClockHz;
+  report->notifyInfo.newBusClockHz = g_BusClockHz;
+  report->notifyInfo.status = status;
+
+  driver->isNotified = false;
+  driver->callback = NULL;
+  driver->callbackContext = NULL;
+  driver->lastStatus = status;
+  EnterState(driver, CLOCK_STATE_IDLE);
+  return status;
+}
+
+/**
+ * @brief  Tells the notifiers and the callback how the switch ended
+ */
+static void ReportSwitch(const Clock_Driver_t *driver, const Switch_Report_t *report)
+{
+  if (report->isNotified)
   {
-    return -1;
+    ClockNotify_PostChange(&report->notifyInfo);
+  }
+  if (report->callback != NULL)
+  {
+    report->callback(report->status, report->context);
   }
 
-  // Finally, set DEF_CLOCK to 0 and wait for CLKSEL to be HSE or HSI
-  uint8_t clockselTimeout = 0U;
-  RCC_CR = (RCC_CR & ~RCC_CR_DEF_CLOCK);
-  do
+  // Held through the callbacks so they can reconfigure without losing the RCC
+  if (IsSystemRcc(driver))
+  {
+    (void)RccOwner_Release(report->ownerId);
+  }
+}
+
+/**
+ * @brief  Claims the right to run a step of the driver's switch
+ * @note   Polls come from thread mode and from RCC_IRQHandler(), which can
+ *         preempt a thread in the middle of a step. Only one of them runs
+ *         steps at a time; the others return CLOCK_IN_PROGRESS and poll again.
+ */
+static bool TryEnterStep(Clock_Driver_t *driver)
+{
+  return (__atomic_exchange_n(&driver->stepGuard, 1U, __ATOMIC_ACQUIRE) == 0U);
+}
+
+static void LeaveStep(Clock_Driver_t *driver)
+{
+  __atomic_store_n(&driver->stepGuard, 0U, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief  Records a switch request
+ * @param budgetCycles Total cycle budget with fallback to the other
+ *        oscillator, or 0 for a plain switch
+ */
+static int32_t StartSwitch(Clock_Driver_t *driver, const Clock_Config_t *config, Clock_Switch_Callback_t callback,
+                           void *context, uint32_t budgetCycles)
+{
+  if ((driver == NULL) || (config == NULL))
+  {
+    return CLOCK_ERROR_INVALID_ARG;
+  }
+
+  // Held until the switch ends, by whichever context finishes it
+  uint32_t ownerId = RCC_OWNER_NONE;
+  if (IsSystemRcc(driver))
   {
-    rccCrReg = RCC_CR;
-    isClkReady = ((rccCrReg & RCC_CR_CLKSEL) != 0);
-    clockselTimeout++;
-  } while (!isClkReady && (clockselTimeout < CLKSEL_SWITCH_MAX_TIME_IN_CYCLES));
-  
-  // Verify
-  if (isHsiClock)
+    ownerId = RccOwner_GetContextId();
+    if (!RccOwner_TryAcquire(ownerId))
+    {
+      return CLOCK_ERROR_BUSY;
+    }
+  }
+  // The guard keeps an interrupt from polling a half-recorded request
+  bool isIdle = TryEnterStep(driver);
+  if (isIdle && (driver->state != CLOCK_STATE_IDLE))
   {
-    // The clksel value should be 0b01 for HSI
-    if ((rccCrReg & RCC_CR_CLKSEL) != RCC_CR_CLKSEL_0)
+    LeaveStep(driver);
+    isIdle = false;
+  }
+  if (!isIdle)
+  {
+    if (IsSystemRcc(driver))
     {
-      return -1;
+      (void)RccOwner_Release(ownerId);
     }
+    return CLOCK_ERROR_BUSY;
   }
-  else
+
+  CycleCounter_Enable();
+  driver->ownerId = ownerId;
+  driver->budgetCycles = budgetCycles;
+  driver->budgetStartCycles = CycleCounter_NowAt(driver->rccBase);
+  driver->isFallbackUsed = false;
+  for (uint32_t step = 0U; step < (uint32_t)CLOCK_WAIT_COUNT; step++)
+  {
+    driver->waitCycles[step] = 0U;
+  }
+
+  driver->config = *config;
+  driver->callback = callback;
+  driver->callbackContext = context;
+  driver->lastStatus = CLOCK_IN_PROGRESS;
+  EnterState(driver, CLOCK_STATE_CHECK_CURRENT);
+  LeaveStep(driver);
+  return CLOCK_OK;
+}
+
+/**
+ * @brief  Sets up a driver for the RCC at a given base address
+ * @note   The RCC is assumed to be out of reset, i.e. on DEF_CLOCK; call
+ *         ClockDriver_Update() if it may not be. Polls of one driver from
+ *         several contexts take turns (see ClockDriver_PollSwitch()), and
+ *         drivers of different RCCs are fully independent.
+ * @param driver Driver to set up
+ * @param rccBase RCC_BASE (or 0 for it), or with MOCK_REGISTERS = 1 a
+ *        simulated RCC (RccSimInst_GetBase())
+ */
+void ClockDriver_Init(Clock_Driver_t *driver, uintptr_t rccBase)
+{
+  *driver = (Clock_Driver_t){ .rccBase = (rccBase != 0U) ? rccBase : RCC_BASE,
+                              .lastStatus = CLOCK_ERROR_NOT_STARTED,
+                              .sysClockHz = CLOCK_DEF_CLOCK_HZ,
+                              .busClockHz = CLOCK_DEF_CLOCK_HZ };
+}
+
+/**
+ * @brief  Returns the driver used by the functions without a driver argument
+ */
+Clock_Driver_t *ClockDriver_GetDefault(void)
+{
+  return &s_Driver;
+}
+
+/**
+ * @brief  Starts a non-blocking clock switch
+ * @note   Only validates the request and records it, no register is touched
+ *         until ClockDriver_PollSwitch() runs. If the request is already
+ *         active nothing is written; if only SYS_DIV/BUS_DIV differ they are
+ *         changed in place. Otherwise the steps are the same as
+ *         SetSystemAndBusClockConfig(): unlock, return to DEF_CLOCK,
+ *         PLL configuration, PLLON and oscillator enable, SYS_DIV/BUS_DIV,
+ *         CLKSEL switch and lock. Each poll does as many steps as the hardware
+ *         allows and returns instead of waiting on a ready flag.
+ *         On RCC_BASE, drivers registered with ClockNotify_Register() are
+ *         called before the first write that changes the clocks and again
+ *         when the switch ends, and the calling context takes the RCC token
+ *         (rcc_owner.h). The switch keeps it until it ends, so nothing but
+ *         the steps of this switch, run by the pollers or RCC_IRQHandler(),
+ *         writes the RCC in between; CLOCK_ERROR_BUSY if someone else holds it.
+ * @param driver Driver of the RCC to switch
+ * @param config Register images from BuildClockConfig() or SolveClockConfig()
+ * @param callback Called once with the final status when the switch ends (may be NULL)
+ * @param context Passed back to the callback
+ * @retval CLOCK_OK if the switch was started, otherwise a negative Clock_Status_t
+ */
+int32_t ClockDriver_StartSwitch(Clock_Driver_t *driver, const Clock_Config_t *config,
+                                Clock_Switch_Callback_t callback, void *context)
+{
+  return StartSwitch(driver, config, callback, context, 0U);
+}
+
+/**
+ * @brief  Runs the steps of the switch the hardware allows, with the step guard held
+ * @param report Filled in if the switch ends
+ */
+static int32_t AdvanceSwitch(Clock_Driver_t *driver, Switch_Report_t *report)
+{
+  const Clock_Config_t *config = &driver->config;
+  uint32_t rccCrReg = 0U;
+
+  while (1)
+  {
+    switch (driver->state)
+    {
+      case CLOCK_STATE_IDLE:
+        return driver->lastStatus;
+
+      case CLOCK_STATE_CHECK_CURRENT:
+        // Only do the work the difference between the running configuration
+        // and the request needs. Anything other than a SYS_DIV/BUS_DIV change
+        // on the same source and PLL setting goes through DEF_CLOCK.
+        rccCrReg = RccReadAt(driver->rccBase, RCC_CR_OFFSET);
+        if (IsRunningFromSource(rccCrReg, config) &&
+            (RccReadAt(driver->rccBase, RCC_PLLCFGR_OFFSET) == config->pllcfgr))
+        {
+          if ((rccCrReg & (RCC_CR_SYS_DIV | RCC_CR_BUS_DIV)) == config->crDividers)
+          {
+            return FinishClockSwitch(driver, report, CLOCK_OK);   // Already active, stays locked
+          }
+          NotifyPreChange(driver);
+          return FinishClockSwitch(driver, report, ApplyDividersOnly(driver, rccCrReg, config));
+        }
+        NotifyPreChange(driver);
+        DRIVER_PROFILE_START(driver);
+        EnterState(driver, CLOCK_STATE_UNLOCK);
+        break;
+
+      case CLOCK_STATE_UNLOCK:
+      {
+        // If the current clock is not the default clock, then we need to switch
+        // back to it before proceeding. Setting DEF_CLOCK also turns off the PLL
+        // and both oscillators. RCC_CR was read by CLOCK_STATE_CHECK_CURRENT.
+        bool isOnDefClock = ((rccCrReg & RCC_CR_CLKSEL) == 0U);
+        Rcc_Txn_t txn;
+        RccTxn_BeginAt(&txn, driver->rccBase);
+        RccTxn_Unlock(&txn);
+        if (!isOnDefClock)
+        {
+          RccTxn_Write(&txn, RCC_CR_OFFSET, rccCrReg | RCC_CR_DEF_CLOCK);
+        }
+        RccTxn_Commit(&txn);
+        DRIVER_PROFILE_MARK(driver, CLOCK_PHASE_UNLOCK);
+
+        if (!isOnDefClock)
+        {
+          CycleWait_StartAt(&driver->wait, driver->rccBase, RCC_CR_OFFSET, RCC_CR_CLKSEL, 0U,
+                          CycleCounter_NowAt(driver->rccBase), CLKSEL_SWITCH_MAX_TIME_IN_CYCLES);
+          EnterState(driver, CLOCK_STATE_WAIT_DEF_CLOCK);
+          return CLOCK_IN_PROGRESS;
+        }
+        EnterState(driver, CLOCK_STATE_CONFIGURE_PLL);
+        break;
+      }
+
+      case CLOCK_STATE_WAIT_DEF_CLOCK:
+      {
+        Cycle_Wait_Result_t result = PollWait(driver, CLOCK_WAIT_DEF_CLOCK, &rccCrReg);
+        if (result == CYCLE_WAIT_PENDING)
+        {
+          return CLOCK_IN_PROGRESS;
+        }
+        if (result == CYCLE_WAIT_TIMEOUT)
+        {
+          // The DEF_CLOCK write is ignored if the RCC was locked again in between
+          bool isLocked = IsRccLocked(driver);
+          return FinishClockSwitch(driver, report, isLocked ? CLOCK_ERROR_LOCKED : CLOCK_ERROR_CLKSEL_TIMEOUT);
+        }
+        DRIVER_PROFILE_MARK(driver, CLOCK_PHASE_DEF_CLOCK);
+        SetClockCache(driver, CLOCK_DEF_CLOCK_HZ, CLOCK_DEF_CLOCK_HZ);
+        EnterState(driver, CLOCK_STATE_CONFIGURE_PLL);
+        break;
+      }
+
+      case CLOCK_STATE_CONFIGURE_PLL:
+      {
+        // Ensure the LOCK_STATUS bit shows unlocked
+        if (IsRccLocked(driver))
+        {
+          return FinishClockSwitch(driver, report, CLOCK_ERROR_LOCKED);
+        }
+
+        // Load the PLL configuration, then turn on the PLL and the oscillator
+        // together so that their start-up times overlap. Only one oscillator may be
+        // on when DEF_CLOCK is cleared, so drop any left on by an earlier attempt.
+        // With a budget the other oscillator starts too, as the fallback.
+        // The transaction stores RCC_PLLCFGR before RCC_CR.
+        uint32_t oscOnBits = OscOnBit(config) | ((driver->budgetCycles != 0U) ? OtherOscOnBit(config) : 0U);
+        Rcc_Txn_t txn;
+        RccTxn_BeginAt(&txn, driver->rccBase);
+        RccTxn_Write(&txn, RCC_PLLCFGR_OFFSET, config->pllcfgr);
+        RccTxn_SetShadow(&txn, RCC_CR_OFFSET, rccCrReg);
+        RccTxn_Modify(&txn, RCC_CR_OFFSET, RCC_CR_HSION | RCC_CR_HSEON, RCC_CR_PLLON | oscOnBits);
+        RccTxn_Commit(&txn);
+
+        // Both start-up times count from this store
+        driver->oscStartCycles = CycleCounter_NowAt(driver->rccBase);
+        CycleWait_StartAt(&driver->wait, driver->rccBase, RCC_CR_OFFSET, RCC_CR_PLL_RDY, RCC_CR_PLL_RDY,
+                        driver->oscStartCycles, g_PllReadyTimeoutCycles);
+        EnterState(driver, CLOCK_STATE_WAIT_PLL);
+        break;
+      }
+
+      case CLOCK_STATE_WAIT_PLL:
+      {
+        Cycle_Wait_Result_t result = PollWait(driver, CLOCK_WAIT_PLL_READY, &rccCrReg);
+        if (result != CYCLE_WAIT_DONE)
+        {
+          return (result == CYCLE_WAIT_TIMEOUT) ? FinishClockSwitch(driver, report, CLOCK_ERROR_PLL_TIMEOUT) : CLOCK_IN_PROGRESS;
+        }
+        DRIVER_PROFILE_MARK(driver, CLOCK_PHASE_PLL_LOCK);
+
+        // Set the SYS_DIV and BUS_DIV values so the system and bus clocks are correct
+        rccCrReg = (rccCrReg & ~(RCC_CR_SYS_DIV | RCC_CR_BUS_DIV)) | config->crDividers;
+        RccWriteAt(driver->rccBase, RCC_CR_OFFSET, rccCrReg);
+
+        // The oscillator was turned on together with the PLL
+        CycleWait_StartAt(&driver->wait, driver->rccBase, RCC_CR_OFFSET, OscReadyBit(config), OscReadyBit(config),
+                        driver->oscStartCycles, GetOscWaitTimeout(driver, config));
+        EnterState(driver, CLOCK_STATE_WAIT_OSC);
+        break;
+      }
+
+      case CLOCK_STATE_WAIT_OSC:
+      {
+        Cycle_Wait_Result_t result = PollWait(driver, CLOCK_WAIT_OSC_READY, &rccCrReg);
+        if ((result == CYCLE_WAIT_TIMEOUT) && (driver->budgetCycles != 0U) && !driver->isFallbackUsed)
+        {
+          // Preferred oscillator too slow: use the other one, which has been
+          // starting up since the same store, with the same PLL and dividers
+          driver->isFallbackUsed = true;
+          driver->config.isHsiClock = !driver->config.isHsiClock;
+          CycleWait_StartAt(&driver->wait, driver->rccBase, RCC_CR_OFFSET, OscReadyBit(config), OscReadyBit(config),
+                          driver->oscStartCycles, OscReadyTimeout(config));
+          break;
+        }
+        if (result != CYCLE_WAIT_DONE)
+        {
+          return (result == CYCLE_WAIT_TIMEOUT) ? FinishClockSwitch(driver, report, CLOCK_ERROR_OSC_TIMEOUT) : CLOCK_IN_PROGRESS;
+        }
+        DRIVER_PROFILE_MARK(driver, CLOCK_PHASE_OSC_READY);
+
+        // Set DEF_CLOCK to 0 so that CLKSEL switches to HSE or HSI. The same
+        // store turns off the oscillator not used (only started with a budget).
+        RccWriteAt(driver->rccBase, RCC_CR_OFFSET, rccCrReg & ~(RCC_CR_DEF_CLOCK | OtherOscOnBit(config)));
+        CycleWait_StartAt(&driver->wait, driver->rccBase, RCC_CR_OFFSET, RCC_CR_DEF_CLOCK | RCC_CR_CLKSEL, ClkselValue(config),
+                        CycleCounter_NowAt(driver->rccBase), CLKSEL_SWITCH_MAX_TIME_IN_CYCLES);
+        EnterState(driver, CLOCK_STATE_WAIT_CLKSEL);
+        break;
+      }
+
+      case CLOCK_STATE_WAIT_CLKSEL:
+      {
+        Cycle_Wait_Result_t result = PollWait(driver, CLOCK_WAIT_CLKSEL, &rccCrReg);
+        if ((result != CYCLE_WAIT_DONE) && ((rccCrReg & RCC_CR_DEF_CLOCK) != 0U))
+        {
+          // CLKSEL may still show HSI/HSE for a moment after a fallback
+          return FinishClockSwitch(driver, report, CLOCK_ERROR_FALLBACK);
+        }
+        if (result != CYCLE_WAIT_DONE)
+        {
+          return (result == CYCLE_WAIT_TIMEOUT) ? FinishClockSwitch(driver, report, CLOCK_ERROR_CLKSEL_TIMEOUT) : CLOCK_IN_PROGRESS;
+        }
+        DRIVER_PROFILE_MARK(driver, CLOCK_PHASE_CLKSEL);
+
+        // Success!! Re-lock the RCC registers
+        RelockRcc(driver);
+        DRIVER_PROFILE_MARK(driver, CLOCK_PHASE_RELOCK);
+        return FinishClockSwitch(driver, report, CLOCK_OK);
+      }
+
+      default:
+        return FinishClockSwitch(driver, report, CLOCK_ERROR_INVALID_ARG);
+    }
+  }
+}
+
+/**
+ * @brief  Advances the clock switch started by ClockDriver_StartSwitch()
+ * @note   Cheap enough to call from an idle loop, a SysTick handler or an RTOS
+ *         task. Never waits on the hardware. Safe to call from an interrupt
+ *         that preempts another poll: it returns CLOCK_IN_PROGRESS without
+ *         touching the RCC and the preempted poll carries on.
+ * @param driver Driver of the RCC being switched
+ * @retval CLOCK_IN_PROGRESS while the switch is running, otherwise the final
+ *         status of the last switch (CLOCK_OK or a negative Clock_Status_t)
+ */
+int32_t ClockDriver_PollSwitch(Clock_Driver_t *driver)
+{
+  if (!TryEnterStep(driver))
+  {
+    return CLOCK_IN_PROGRESS;
+  }
+
+  Switch_Report_t report = { .isPending = false };
+  int32_t status = AdvanceSwitch(driver, &report);
+  LeaveStep(driver);
+
+  if (report.isPending)
+  {
+    ReportSwitch(driver, &report);
+  }
+  return status;
+}
+
+/**
+ * @brief  Returns true while a clock switch of the driver is running
+ */
+bool ClockDriver_IsSwitchInProgress(const Clock_Driver_t *driver)
+{
+  return (driver->state != CLOCK_STATE_IDLE);
+}
+
+/**
+ * @brief  Split-phase start, see BeginSystemAndBusClockConfig()
+ * @param driver Driver of the RCC to switch
+ * @param config Register images to switch to
+ * @retval CLOCK_OK on success, otherwise a negative Clock_Status_t
+ */
+int32_t ClockDriver_Begin(Clock_Driver_t *driver, const Clock_Config_t *config)
+{
+  int32_t status = ClockDriver_StartSwitch(driver, config, NULL, NULL);
+  if (status != CLOCK_OK)
+  {
+    return status;
+  }
+
+  // Run until the PLL and the oscillator have been turned on
+  while (driver->state < CLOCK_STATE_WAIT_PLL)
   {
-    // The clksel value should be 0b10 for HSE
-    if ((rccCrReg & RCC_CR_CLKSEL) != RCC_CR_CLKSEL_1)
+    status = ClockDriver_PollSwitch(driver);
+    if (status != CLOCK_IN_PROGRESS)
     {
-      return -1;
+      return status;
     }
   }
+  return CLOCK_OK;
+}
+
+/**
+ * @brief  Finishes a switch, see CompleteSystemAndBusClockConfig()
+ * @param driver Driver of the RCC being switched
+ * @retval CLOCK_OK on success, otherwise a negative Clock_Status_t
+ */
+int32_t ClockDriver_Complete(Clock_Driver_t *driver)
+{
+  // Begin may already have finished the switch (e.g. nothing to change), in
+  // which case its result is returned. Before any Begin this is NOT_STARTED.
+  int32_t status = CLOCK_IN_PROGRESS;
+  do
+  {
+    status = ClockDriver_PollSwitch(driver);
+  } while (status == CLOCK_IN_PROGRESS);
 
-  // Success!! Re-lock the RCC registers
-  RCC_LOCK |= RCC_LOCK_LOCK;
+  return status;
+}
 
-  return 0;
+/**
+ * @brief  Blocking switch to prebuilt register images
+ * @param driver Driver of the RCC to switch
+ * @param config Register images from BuildClockConfig() or SolveClockConfig()
+ * @retval CLOCK_OK (0) on success, otherwise a negative Clock_Status_t
+ */
+int32_t ClockDriver_SetClockConfig(Clock_Driver_t *driver, const Clock_Config_t *config)
+{
+  int32_t status = ClockDriver_StartSwitch(driver, config, NULL, NULL);
+  if (status != CLOCK_OK)
+  {
+    return status;
+  }
+
+  return ClockDriver_Complete(driver);
+}
+
+/**
+ * @brief  Blocking switch within a cycle budget, falling back to the other oscillator
+ * @note   Both oscillators are started together with the PLL. If the
+ *         preferred one is not ready within its share of the budget (what is
+ *         left after reserving the CLKSEL switch), the system runs from the
+ *         other one with the same PLL, SYS_DIV and BUS_DIV settings. The
+ *         unused oscillator is turned off when DEF_CLOCK is cleared.
+ * @param driver Driver of the RCC to switch
+ * @param config Register images; config->isHsiClock is the preferred source
+ * @param budgetCycles Total cycles allowed, at least GetClockFallbackMinBudget()
+ * @param isHsiClockUsed Filled in with the source actually used (may be NULL)
+ * @retval CLOCK_OK (0) on success, CLOCK_ERROR_INVALID_ARG for a budget that
+ *         cannot be guaranteed, otherwise a negative Clock_Status_t
+ */
+int32_t ClockDriver_SetClockConfigWithFallback(Clock_Driver_t *driver, const Clock_Config_t *config,
+                                               uint32_t budgetCycles, bool *isHsiClockUsed)
+{
+  if ((config == NULL) || (budgetCycles < GetClockFallbackMinBudget(config->isHsiClock)))
+  {
+    return CLOCK_ERROR_INVALID_ARG;
+  }
+
+  int32_t status = StartSwitch(driver, config, NULL, NULL, budgetCycles);
+  if (status != CLOCK_OK)
+  {
+    return status;
+  }
+
+  status = ClockDriver_Complete(driver);
+  if (isHsiClockUsed != NULL)
+  {
+    *isHsiClockUsed = driver->config.isHsiClock;
+  }
+  return status;
+}
+
+/**
+ * @brief  Re-derives the cached clock frequencies from RCC_CR and RCC_PLLCFGR
+ * @note   Only needed if the RCC was changed outside this driver (e.g. by a
+ *         bootloader); every switch path here keeps the cache up to date.
+ *         DEF_CLOCK is fixed at 8MHz regardless of the PLL and dividers. With
+ *         the DEF_CLOCK bit set CLKSEL may still show HSI/HSE for up to 500
+ *         cycles, but the RCC is already on its way back, so that also counts
+ *         as DEF_CLOCK.
+ * @param driver Driver of the RCC to read
+ */
+void ClockDriver_Update(Clock_Driver_t *driver)
+{
+  uint32_t rccCrReg = RccReadAt(driver->rccBase, RCC_CR_OFFSET);
+  if (((rccCrReg & RCC_CR_CLKSEL) == 0U) || ((rccCrReg & RCC_CR_DEF_CLOCK) != 0U))
+  {
+    SetClockCache(driver, CLOCK_DEF_CLOCK_HZ, CLOCK_DEF_CLOCK_HZ);
+    return;
+  }
+
+  Clock_Config_t config =
+  {
+    .pllcfgr = RccReadAt(driver->rccBase, RCC_PLLCFGR_OFFSET),
+    .crDividers = rccCrReg & (RCC_CR_SYS_DIV | RCC_CR_BUS_DIV),
+    .isHsiClock = ((rccCrReg & RCC_CR_CLKSEL) == RCC_CR_CLKSEL_0),
+  };
+  SetClockCache(driver, GetClockConfigSysClockHz(&config), GetClockConfigBusClockHz(&config));
+}
+
+/**
+ * @brief  Returns the configuration of the last switch requested
+ * @note   After a fallback switch it holds the oscillator actually used. The
+ *         switch may have failed, see the status it returned.
+ * @param driver Driver to read
+ * @param config Filled in with the register images
+ * @retval false if no switch was requested yet
+ */
+bool ClockDriver_GetConfig(const Clock_Driver_t *driver, Clock_Config_t *config)
+{
+  if ((config == NULL) || (driver->lastStatus == CLOCK_ERROR_NOT_STARTED))
+  {
+    return false;
+  }
+  *config = driver->config;
+  return true;
+}
+
+/**
+ * @brief  Returns the configuration of the last switch that succeeded
+ * @note   Unlike ClockDriver_GetConfig() a failed switch does not change it.
+ * @param driver Driver to read
+ * @param config Filled in with the register images
+ * @retval false if no switch has succeeded yet
+ */
+bool ClockDriver_GetGoodConfig(const Clock_Driver_t *driver, Clock_Config_t *config)
+{
+  if ((config == NULL) || !driver->hasGoodConfig)
+  {
+    return false;
+  }
+  *config = driver->goodConfig;
+  return true;
+}
+
+/**
+ * @brief  Returns the status of the last switch without advancing it
+ * @retval CLOCK_IN_PROGRESS while a switch runs, CLOCK_ERROR_NOT_STARTED
+ *         before the first, otherwise the status the last one ended with
+ */
+int32_t ClockDriver_GetLastStatus(const Clock_Driver_t *driver)
+{
+  return driver->lastStatus;
+}
+
+/**
+ * @brief  Returns the system clock of the driver's RCC in Hz (cached)
+ */
+uint32_t ClockDriver_GetSystemClockHz(const Clock_Driver_t *driver)
+{
+  return IsSystemRcc(driver) ? g_SystemClockHz : driver->sysClockHz;
+}
+
+/**
+ * @brief  Returns the bus clock of the driver's RCC in Hz (cached)
+ */
+uint32_t ClockDriver_GetBusClockHz(const Clock_Driver_t *driver)
+{
+  return IsSystemRcc(driver) ? g_BusClockHz : driver->busClockHz;
+}
+
+/**
+ * @brief  Returns how long one wait of the driver's last clock switch took
+ * @param driver Driver to query
+ * @param step Wait to query
+ * @retval CPU cycles from the write that started the hardware event to the
+ *         read that saw it (or to the timeout), 0 if the wait did not run
+ */
+uint32_t ClockDriver_GetWaitCycles(const Clock_Driver_t *driver, Clock_Wait_Step_t step)
+{
+  return (step < CLOCK_WAIT_COUNT) ? driver->waitCycles[step] : 0U;
+}
+
+/**
+ * @brief  Starts a non-blocking clock switch
+ * @note   ClockDriver_StartSwitch() on the RCC at RCC_BASE. Advanced by
+ *         PollClockSwitch() or RCC_IRQHandler().
+ * @param sysClockSpeed Desired system clock speed enum
+ * @param busClockDivider Desired bus clock divider
+ * @param isHsiClock If true, then desired to use the internal HSI clock. If false, then use external HSE clock.
+ * @param callback Called once with the final status when the switch ends (may be NULL)
+ * @param context Passed back to the callback
+ * @retval CLOCK_OK if the switch was started, otherwise a negative Clock_Status_t
+ */
+int32_t StartClockSwitch(System_Clock_Speeds_t sysClockSpeed, unsigned int busClockDivider, bool isHsiClock,
+                         Clock_Switch_Callback_t callback, void *context)
+{
+  Clock_Config_t config;
+  int32_t status = BuildClockConfig(sysClockSpeed, busClockDivider, isHsiClock, &config);
+  if (status != CLOCK_OK)
+  {
+    return status;
+  }
+
+  return StartClockSwitchConfig(&config, callback, context);
+}
+
+/**
+ * @brief  Starts a non-blocking clock switch to prebuilt register images
+ * @note   Same as StartClockSwitch() for a configuration from
+ *         BuildClockConfig() or SolveClockConfig().
+ * @param config Register images to switch to
+ * @param callback Called once with the final status when the switch ends (may be NULL)
+ * @param context Passed back to the callback
+ * @retval CLOCK_OK if the switch was started, otherwise a negative Clock_Status_t
+ */
+int32_t StartClockSwitchConfig(const Clock_Config_t *config, Clock_Switch_Callback_t callback, void *context)
+{
+  return ClockDriver_StartSwitch(&s_Driver, config, callback, context);
+}
+
+/**
+ * @brief  Advances the clock switch started by StartClockSwitch()
+ * @note   Cheap enough to call from an idle loop, a SysTick handler or an RTOS
+ *         task. Never waits on the hardware.
+ * @retval CLOCK_IN_PROGRESS while the switch is running, otherwise the final
+ *         status of the last switch (CLOCK_OK or a negative Clock_Status_t)
+ */
+int32_t PollClockSwitch(void)
+{
+  return ClockDriver_PollSwitch(&s_Driver);
+}
+
+/**
+ * @brief  Returns true while a clock switch is running
+ */
+bool IsClockSwitchInProgress(void)
+{
+  return ClockDriver_IsSwitchInProgress(&s_Driver);
+}
+
+/**
+ * @brief  RCC global interrupt handler (RCC_IRQn)
+ * @note   Advances the clock switch in progress when the RCC signals a change
+ *         of its ready flags. Switches also advance without it through
+ *         PollClockSwitch(); if the interrupt arrives in the middle of such a
+ *         poll it leaves the step to the preempted poll.
+ */
+void RCC_IRQHandler(void)
+{
+  (void)PollClockSwitch();
+}
+
+/**
+ * @brief  Starts a clock configuration without waiting for the hardware
+ * @note   Unlocks the RCC, returns to DEF_CLOCK if needed, loads the PLL
+ *         configuration and turns on the PLL and the selected oscillator.
+ *         The PLL lock and the oscillator start-up (up to 350 and 4200 CPU
+ *         cycles) then run in the background while the caller does other
+ *         work, e.g. copying .data and zeroing .bss in the reset handler.
+ *         CompleteSystemAndBusClockConfig() must be called to finish.
+ * @param sysClockSpeed Desired system clock speed enum
+ * @param busClockDivider Desired bus clock divider
+ * @param isHsiClock If true, then desired to use the internal HSI clock. If false, then use external HSE clock.
+ * @retval CLOCK_OK on success, otherwise a negative Clock_Status_t
+ */
+int32_t BeginSystemAndBusClockConfig(System_Clock_Speeds_t sysClockSpeed, unsigned int busClockDivider, bool isHsiClock)
+{
+  Clock_Config_t config;
+  int32_t status = BuildClockConfig(sysClockSpeed, busClockDivider, isHsiClock, &config);
+  if (status != CLOCK_OK)
+  {
+    return status;
+  }
+
+  return ClockDriver_Begin(&s_Driver, &config);
+}
+
+/**
+ * @brief  Finishes a clock configuration started by BeginSystemAndBusClockConfig()
+ * @note   Waits for PLL_RDY, sets SYS_DIV/BUS_DIV, waits for the oscillator,
+ *         switches CLKSEL away from DEF_CLOCK and re-locks the RCC. Any wait
+ *         that already elapsed while the caller was busy costs a single read.
+ * @retval CLOCK_OK on success, otherwise a negative Clock_Status_t
+ */
+int32_t CompleteSystemAndBusClockConfig(void)
+{
+  return ClockDriver_Complete(&s_Driver);
+}
+
+/**
+ * @brief  Configures the system and bus clock config based on what is provided
+ * @note   This function assumes a 40MHz starting clock. (Note: This is required
+ *         for HSE, and for HSI the internal clock is always 40MHz starting out).
+ *         Only the minimum transition is done: nothing if the configuration is
+ *         already active, an in-place SYS_DIV/BUS_DIV write if only those
+ *         differ, and the full sequence through DEF_CLOCK otherwise.
+ *         Blocking equivalent of BeginSystemAndBusClockConfig() followed by
+ *         CompleteSystemAndBusClockConfig().
+ * @param sysClockSpeed Desired system clock speed enum
+ * @param busClockDivider Desired bus clock divider
+ * @param isHsiClock If true, then desired to use the internal HSI clock. If false, then use external HSE clock.
+ * @retval CLOCK_OK (0) on success, otherwise a negative Clock_Status_t
+ */
+int32_t SetSystemAndBusClockConfig(System_Clock_Speeds_t sysClockSpeed, unsigned int busClockDivider, bool isHsiClock)
+{
+  Clock_Config_t config;
+  int32_t status = BuildClockConfig(sysClockSpeed, busClockDivider, isHsiClock, &config);
+  if (status != CLOCK_OK)
+  {
+    return status;
+  }
+
+  return ClockDriver_SetClockConfig(&s_Driver, &config);
+}
+
+/**
+ * @brief  Blocking switch to prebuilt register images
+ * @param config Register images from BuildClockConfig() or SolveClockConfig()
+ * @retval CLOCK_OK (0) on success, otherwise a negative Clock_Status_t
+ */
+int32_t SetClockConfig(const Clock_Config_t *config)
+{
+  return ClockDriver_SetClockConfig(&s_Driver, config);
+}
+
+/**
+ * @brief  Re-derives the cached clock frequencies of the RCC at RCC_BASE
+ * @note   See ClockDriver_Update().
+ */
+void SystemClockUpdate(void)
+{
+  ClockDriver_Update(&s_Driver);
+}
+
+/**
+ * @brief  Returns the system clock in Hz (cached, no register access)
+ */
+uint32_t GetSystemClockHz(void)
+{
+  return g_SystemClockHz;
+}
+
+/**
+ * @brief  Returns the bus clock in Hz (cached, no register access)
+ */
+uint32_t GetBusClockHz(void)
+{
+  return g_BusClockHz;
+}
+
+/**
+ * @brief  Returns how long one wait of the last clock switch took
+ * @param step Wait to query
+ * @retval CPU cycles from the write that started the hardware event to the
+ *         read that saw it (or to the timeout), 0 if the wait did not run
+ */
+uint32_t GetClockWaitCycles(Clock_Wait_Step_t step)
+{
+  return ClockDriver_GetWaitCycles(&s_Driver, step);
+}
+
+/**
+ * @brief  Blocking switch within a cycle budget on the RCC at RCC_BASE
+ * @note   See ClockDriver_SetClockConfigWithFallback().
+ * @param config Register images; config->isHsiClock is the preferred source
+ * @param budgetCycles Total cycles allowed, at least GetClockFallbackMinBudget()
+ * @param isHsiClockUsed Filled in with the source actually used (may be NULL)
+ * @retval CLOCK_OK (0) on success, otherwise a negative Clock_Status_t
+ */
+int32_t SetClockConfigWithFallback(const Clock_Config_t *config, uint32_t budgetCycles, bool *isHsiClockUsed)
+{
+  return ClockDriver_SetClockConfigWithFallback(&s_Driver, config, budgetCycles, isHsiClockUsed);
+}
+
+/**
+ * @brief  Speed enum version of SetClockConfigWithFallback()
+ * @param sysClockSpeed Desired system clock speed enum
+ * @param busClockDivider Desired bus clock divider
+ * @param isHsiPreferred If true try HSI first, otherwise HSE first
+ * @param budgetCycles Total cycles allowed, at least GetClockFallbackMinBudget()
+ * @param isHsiClockUsed Filled in with the source actually used (may be NULL)
+ * @retval CLOCK_OK (0) on success, otherwise a negative Clock_Status_t
+ */
+int32_t SetSystemAndBusClockConfigWithFallback(System_Clock_Speeds_t sysClockSpeed, unsigned int busClockDivider,
+                                               bool isHsiPreferred, uint32_t budgetCycles, bool *isHsiClockUsed)
+{
+  Clock_Config_t config;
+  int32_t status = BuildClockConfig(sysClockSpeed, busClockDivider, isHsiPreferred, &config);
+  if (status != CLOCK_OK)
+  {
+    return status;
+  }
+
+  return SetClockConfigWithFallback(&config, budgetCycles, isHsiClockUsed);
+}
+
+/**
+ * @brief  Smallest budget SetClockConfigWithFallback() can always meet
+ * @note   Return to DEF_CLOCK, start-up of the fallback oscillator, CLKSEL
+ *         switch and the register accesses in between.
+ * @param isHsiPreferred Preferred source (the fallback is the other one)
+ * @retval Budget in CPU cycles
+ */
+uint32_t GetClockFallbackMinBudget(bool isHsiPreferred)
+{
+  uint32_t fallbackOscCycles = isHsiPreferred ? HSERDY_MAX_TIME_IN_CYCLES : HSIRDY_MAX_TIME_IN_CYCLES;
+  return CLKSEL_SWITCH_MAX_TIME_IN_CYCLES + fallbackOscCycles + CLKSEL_SWITCH_MAX_TIME_IN_CYCLES +
+         FALLBACK_SLACK_CYCLES;
 }
@@ -7,6 +7,14 @@
  * This file contains function definitions and enums to configure the RCC (Reset and Clock Control)
  * register to achieve a given system and bus clock.
  *
+ * The driver state lives in a Clock_Driver_t, one per RCC. The functions
+ * without a driver argument use the built-in driver of the RCC at RCC_BASE.
+ * The ClockDriver_xxx() functions take the driver explicitly, which lets a
+ * host build with MOCK_REGISTERS = 1 run any number of independent simulated
+ * chips (rcc_sim.h), e.g. one per thread. Only drivers of RCC_BASE take the
+ * RCC token (rcc_owner.h), call the clock notifiers, feed the profiler and
+ * update g_SystemClockHz/g_BusClockHz; a simulated RCC has no other users.
+ *
  */
 
 #ifndef STARTUP__H
@@ -14,6 +22,13 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "cycle_counter.h"
+#include "clock_notify.h"
+#include "rcc_regs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 typedef enum {
   SYS_CLOCK_SPEED_UNDEFINED = 0,
@@ -28,9 +43,171 @@ typedef enum {
   SYS_CLOCK_SPEED_MAX_ENUM_VAL = SYS_CLOCK_SPEED_1_25M
 } System_Clock_Speeds_t;
 
-int32_t SetSystemAndBusClockConfig(System_Clock_Speeds_t sysClkSped, unsigned int BusClockDivider, bool isHsiClock);
+/**
+ * @brief Return codes of the clock configuration functions
+ */
+typedef enum {
+  CLOCK_IN_PROGRESS =           1, // Non-blocking switch still running
+  CLOCK_OK =                    0,
+  CLOCK_ERROR_INVALID_ARG =    -1, // Unknown clock speed or bad argument
+  CLOCK_ERROR_LOCKED =         -2, // RCC registers did not unlock
+  CLOCK_ERROR_PLL_TIMEOUT =    -3, // PLL_RDY not set in time
+  CLOCK_ERROR_OSC_TIMEOUT =    -4, // HSIRDY/HSERDY not set in time
+  CLOCK_ERROR_CLKSEL_TIMEOUT = -5, // CLKSEL did not switch (e.g. fell back to DEF_CLOCK)
+  CLOCK_ERROR_NOT_STARTED =    -6, // Complete called without a successful Begin
+  CLOCK_ERROR_BUSY =           -7, // Another clock switch is running, or another context holds the RCC (rcc_owner.h)
+  CLOCK_ERROR_FALLBACK =       -8, // RCC fell back to DEF_CLOCK after a register write
+  CLOCK_ERROR_UNREACHABLE =    -9, // No MUL/DIV/SYS_DIV combination gives the requested system clock
+  CLOCK_ERROR_BUS_LIMIT =     -10, // Bus clock would be above 20MHz (or the requested maximum)
+  CLOCK_ERROR_REGISTRY_FULL = -11, // No free entry in a fixed-size table (e.g. clock notifiers)
+} Clock_Status_t;
+
+#define CLOCK_PLL_INPUT_HZ          40000000UL  // HSI, or the required 40MHz HSE crystal
+#define CLOCK_MAX_BUS_CLOCK_HZ      20000000UL  // The bus clock MUST be 20MHz or less
+#define CLOCK_DEF_CLOCK_HZ           8000000UL  // DEF_CLOCK, system and bus clock alike
+
+// Worst-case times from the reference manual, in CPU cycles
+#define CLKSEL_SWITCH_MAX_TIME_IN_CYCLES     RCC_REG_CR_CLKSEL_MAX_CYCLES
+#define HSIRDY_MAX_TIME_IN_CYCLES            RCC_REG_CR_HSIRDY_MAX_CYCLES
+#define HSERDY_MAX_TIME_IN_CYCLES            RCC_REG_CR_HSERDY_MAX_CYCLES
+
+/**
+ * @brief Register images of one clock configuration
+ */
+typedef struct {
+  uint32_t pllcfgr;         // RCC_PLLCFGR MUL and DIV bits
+  uint32_t crDividers;      // RCC_CR SYS_DIV and BUS_DIV bits
+  bool isHsiClock;          // Run from HSI if true, otherwise from HSE
+} Clock_Config_t;
+
+/**
+ * @brief Hardware waits of a clock switch, see GetClockWaitCycles()
+ */
+typedef enum {
+  CLOCK_WAIT_DEF_CLOCK = 0, // DEF_CLOCK set to CLKSEL back on DEF_CLOCK, limit 500
+  CLOCK_WAIT_PLL_READY,     // PLLON to PLL_RDY, limit g_PllReadyTimeoutCycles (350)
+  CLOCK_WAIT_OSC_READY,     // HSION/HSEON to HSIRDY/HSERDY, limit 1400/4200
+  CLOCK_WAIT_CLKSEL,        // DEF_CLOCK cleared to CLKSEL switched, limit 500
+  CLOCK_WAIT_COUNT
+} Clock_Wait_Step_t;
+
+/**
+ * @brief Called when a non-blocking clock switch ends
+ * @param status CLOCK_OK or a negative Clock_Status_t
+ * @param context Context passed to StartClockSwitch()
+ */
+typedef void (*Clock_Switch_Callback_t)(int32_t status, void *context);
+
+/**
+ * @brief Steps of a clock switch. Every switch (blocking, split-phase or
+ *        interrupt driven) runs through this state machine.
+ */
+typedef enum {
+  CLOCK_STATE_IDLE = 0,
+  CLOCK_STATE_CHECK_CURRENT,      // Diff the running config against the request
+  CLOCK_STATE_UNLOCK,             // Unlock, set DEF_CLOCK if not on it already
+  CLOCK_STATE_WAIT_DEF_CLOCK,     // Wait for CLKSEL to show DEF_CLOCK
+  CLOCK_STATE_CONFIGURE_PLL,      // Load RCC_PLLCFGR, set PLLON and HSION/HSEON
+  CLOCK_STATE_WAIT_PLL,           // Wait for PLL_RDY, then set SYS_DIV/BUS_DIV
+  CLOCK_STATE_WAIT_OSC,           // Wait for HSIRDY/HSERDY, then clear DEF_CLOCK
+  CLOCK_STATE_WAIT_CLKSEL,        // Wait for CLKSEL, then lock
+} Clock_Switch_State_t;
+
+/**
+ * @brief Clock driver of one RCC. Set up with ClockDriver_Init(), fields are
+ *        private to startup.c.
+ */
+typedef struct {
+  uintptr_t rccBase;              // RCC driven, RCC_BASE on target
+  Clock_Switch_State_t state;
+  Clock_Config_t config;
+  Clock_Config_t goodConfig;      // Last configuration a switch reached, if hasGoodConfig
+  bool hasGoodConfig;
+  Cycle_Wait_t wait;              // Ready flag the current wait state checks
+  uint32_t oscStartCycles;        // Cycle count when HSION/HSEON was written
+  uint32_t budgetCycles;          // Total budget of a fallback switch, 0 = none
+  uint32_t budgetStartCycles;     // Cycle count when the fallback switch started
+  bool isFallbackUsed;            // Switched to the other oscillator
+  uint32_t waitCycles[CLOCK_WAIT_COUNT]; // Cycles each wait took in the last switch
+  int32_t lastStatus;             // Result of the last finished switch
+  Clock_Switch_Callback_t callback;
+  void *callbackContext;
+  uint32_t ownerId;               // Context holding the RCC token for the switch
+  bool isNotified;                // Pre-change notifiers ran for this switch
+  Clock_Notify_Info_t notifyInfo;
+  uint32_t sysClockHz;            // Clock cache of an RCC other than RCC_BASE
+  uint32_t busClockHz;
+  uint32_t stepGuard;             // Non-zero while a context runs a step of the switch
+} Clock_Driver_t;
+
+int32_t SetSystemAndBusClockConfig(System_Clock_Speeds_t sysClockSpeed, unsigned int busClockDivider, bool isHsiClock);
+
+// Register images for a speed enum, and the clocks a set of images produces
+int32_t BuildClockConfig(System_Clock_Speeds_t sysClockSpeed, unsigned int busClockDivider,
+                         bool isHsiClock, Clock_Config_t *config);
+uint32_t GetClockConfigSysClockHz(const Clock_Config_t *config);
+uint32_t GetClockConfigBusClockHz(const Clock_Config_t *config);
+int32_t SetClockConfig(const Clock_Config_t *config);
+
+// Bring-up within a total cycle budget: if the preferred oscillator is not
+// ready within its share, the other one is used with the same PLL and
+// dividers. isHsiClockUsed reports the source the system runs from.
+int32_t SetSystemAndBusClockConfigWithFallback(System_Clock_Speeds_t sysClockSpeed, unsigned int busClockDivider,
+                                               bool isHsiPreferred, uint32_t budgetCycles, bool *isHsiClockUsed);
+int32_t SetClockConfigWithFallback(const Clock_Config_t *config, uint32_t budgetCycles, bool *isHsiClockUsed);
+uint32_t GetClockFallbackMinBudget(bool isHsiPreferred);
+
+// Split-phase version of SetSystemAndBusClockConfig(): Begin starts the PLL and
+// oscillator, Complete waits for them and switches CLKSEL. Other start-up work
+// can be done in between while the hardware settles.
+int32_t BeginSystemAndBusClockConfig(System_Clock_Speeds_t sysClockSpeed, unsigned int busClockDivider, bool isHsiClock);
+int32_t CompleteSystemAndBusClockConfig(void);
+
+// Non-blocking clock switch for runtime clock changes. Advanced by
+// RCC_IRQHandler() or PollClockSwitch(); the callback fires when it ends.
+int32_t StartClockSwitch(System_Clock_Speeds_t sysClockSpeed, unsigned int busClockDivider, bool isHsiClock,
+                         Clock_Switch_Callback_t callback, void *context);
+int32_t StartClockSwitchConfig(const Clock_Config_t *config, Clock_Switch_Callback_t callback, void *context);
+int32_t PollClockSwitch(void);
+bool IsClockSwitchInProgress(void);
+void RCC_IRQHandler(void);
+
+// Frequencies currently in effect, kept up to date by every clock switch so
+// drivers can read them without decoding RCC registers (like CMSIS
+// SystemCoreClock). Treat as read-only.
+uint32_t GetSystemClockHz(void);
+uint32_t GetBusClockHz(void);
+void SystemClockUpdate(void);
+
+// CPU cycles each ready-flag wait of the last switch took
+uint32_t GetClockWaitCycles(Clock_Wait_Step_t step);
+
+// Same operations on an explicit driver. rccBase 0 means RCC_BASE.
+void ClockDriver_Init(Clock_Driver_t *driver, uintptr_t rccBase);
+Clock_Driver_t *ClockDriver_GetDefault(void);
+int32_t ClockDriver_StartSwitch(Clock_Driver_t *driver, const Clock_Config_t *config,
+                                Clock_Switch_Callback_t callback, void *context);
+int32_t ClockDriver_PollSwitch(Clock_Driver_t *driver);
+bool ClockDriver_IsSwitchInProgress(const Clock_Driver_t *driver);
+int32_t ClockDriver_Begin(Clock_Driver_t *driver, const Clock_Config_t *config);
+int32_t ClockDriver_Complete(Clock_Driver_t *driver);
+int32_t ClockDriver_SetClockConfig(Clock_Driver_t *driver, const Clock_Config_t *config);
+int32_t ClockDriver_SetClockConfigWithFallback(Clock_Driver_t *driver, const Clock_Config_t *config,
+                                               uint32_t budgetCycles, bool *isHsiClockUsed);
+void ClockDriver_Update(Clock_Driver_t *driver);
+bool ClockDriver_GetConfig(const Clock_Driver_t *driver, Clock_Config_t *config);
+bool ClockDriver_GetGoodConfig(const Clock_Driver_t *driver, Clock_Config_t *config);
+int32_t ClockDriver_GetLastStatus(const Clock_Driver_t *driver);
+uint32_t ClockDriver_GetSystemClockHz(const Clock_Driver_t *driver);
+uint32_t ClockDriver_GetBusClockHz(const Clock_Driver_t *driver);
+uint32_t ClockDriver_GetWaitCycles(const Clock_Driver_t *driver, Clock_Wait_Step_t step);
 
-extern uint32_t g_PllReadyTimeoutCycles;
+extern uint32_t g_PllReadyTimeoutCycles;   // CPU cycles
+extern uint32_t g_SystemClockHz;
+extern uint32_t g_BusClockHz;
 
+#ifdef __cplusplus
+}
+#endif
 
 #endif // STARTUP__H
\ No newline at end of file
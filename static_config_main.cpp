@@ -0,0 +1,99 @@
+/**
+ * @file    static_config_main.cpp
+ * @brief   Checks clock_config.hpp against the run-time configuration builder
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Every legal speed/divider/source combination built at compile time must give
+ * the same register images and frequencies as BuildClockConfig(), and one of
+ * them is applied to the simulated RCC. Also checks that the C headers can be
+ * used from C++.
+ *
+ * Build with MOCK_REGISTERS = 1, the C files compiled as C, e.g.
+ *   clang -c -DMOCK_REGISTERS=1 startup.c clock_notify.c clock_profile.c cycle_counter.c rcc_owner.c rcc_txn.c rcc_sim.c
+ *   clang++ -std=c++11 -DMOCK_REGISTERS=1 static_config_main.cpp *.o -o static_config.out
+ *
+ * Building with -DCLOCK_CONFIG_SHOW_ERRORS=1 instantiates illegal
+ * configurations and must fail with the static_assert messages.
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include "clock_config.hpp"
+#include "rcc_access.h"
+
+static uint32_t s_Failures = 0U;
+
+/**
+ * @brief  Compares one compile-time configuration with BuildClockConfig()
+ */
+template <System_Clock_Speeds_t SysClockSpeed, unsigned int BusClockDivider, bool IsHsiClock>
+static void Check()
+{
+  typedef StaticClockConfig<SysClockSpeed, BusClockDivider, IsHsiClock> Static;
+  constexpr Clock_Config_t staticConfig = Static::Get();
+
+  Clock_Config_t config;
+  int32_t status = BuildClockConfig(SysClockSpeed, BusClockDivider, IsHsiClock, &config);
+  if ((status != CLOCK_OK) || (config.pllcfgr != staticConfig.pllcfgr) ||
+      (config.crDividers != staticConfig.crDividers) || (config.isHsiClock != staticConfig.isHsiClock) ||
+      (GetClockConfigSysClockHz(&config) != Static::sysClockHz) ||
+      (GetClockConfigBusClockHz(&config) != Static::busClockHz))
+  {
+    printf("MISMATCH speed %d bus_div %u %s: status %d\n", static_cast<int>(SysClockSpeed), BusClockDivider,
+           IsHsiClock ? "HSI" : "HSE", status);
+    s_Failures++;
+  }
+}
+
+template <System_Clock_Speeds_t SysClockSpeed, unsigned int BusClockDivider>
+static void CheckSources()
+{
+  Check<SysClockSpeed, BusClockDivider, true>();
+  Check<SysClockSpeed, BusClockDivider, false>();
+}
+
+int main()
+{
+  // Only the legal combinations compile; see CLOCK_CONFIG_SHOW_ERRORS below
+  CheckSources<SYS_CLOCK_SPEED_80M, 4>();
+  CheckSources<SYS_CLOCK_SPEED_40M, 2>();
+  CheckSources<SYS_CLOCK_SPEED_40M, 4>();
+  CheckSources<SYS_CLOCK_SPEED_20M, 0>();
+  CheckSources<SYS_CLOCK_SPEED_20M, 2>();
+  CheckSources<SYS_CLOCK_SPEED_20M, 4>();
+  CheckSources<SYS_CLOCK_SPEED_10M, 0>();
+  CheckSources<SYS_CLOCK_SPEED_10M, 1>();
+  CheckSources<SYS_CLOCK_SPEED_5M, 2>();
+  CheckSources<SYS_CLOCK_SPEED_2_5M, 4>();
+  CheckSources<SYS_CLOCK_SPEED_1_25M, 0>();
+
+  // Images usable where a constant is required
+  typedef StaticClockConfig<SYS_CLOCK_SPEED_80M, 4, true> BootClock;
+  static_assert(BootClock::pllcfgr == RCC_PLLCFGR_MUL_0, "80MHz is the 40MHz input multiplied by 2");
+  static_assert(BootClock::busClockHz == 20000000UL, "80MHz / 4 is the 20MHz bus limit");
+
+  RccSim_Init(NULL);
+  int32_t status = BootClock::Apply();
+  uint32_t cr = RccSim_Peek(RCC_CR_OFFSET);
+  bool isApplied = (status == CLOCK_OK) && (RccSim_Peek(RCC_PLLCFGR_OFFSET) == BootClock::pllcfgr) &&
+                   ((cr & ~(RCC_CR_HSIRDY | RCC_CR_HSERDY | RCC_CR_PLL_RDY)) == BootClock::cr) &&
+                   (GetSystemClockHz() == BootClock::sysClockHz);
+  printf("Applied %lu Hz / %lu Hz: %d, RCC_CR 0x%08lx, RCC_PLLCFGR 0x%02lx\n",
+         static_cast<unsigned long>(BootClock::sysClockHz), static_cast<unsigned long>(BootClock::busClockHz),
+         status, static_cast<unsigned long>(cr), static_cast<unsigned long>(BootClock::pllcfgr));
+  if (!isApplied)
+  {
+    s_Failures++;
+  }
+
+#if (CLOCK_CONFIG_SHOW_ERRORS == 1)
+  (void)StaticClockConfig<SYS_CLOCK_SPEED_160M, 4, true>::Get();      // Bus clock 40MHz
+  (void)StaticClockConfig<SYS_CLOCK_SPEED_20M, 3, true>::Get();       // No divide by 3
+  (void)StaticClockConfig<SYS_CLOCK_SPEED_UNDEFINED, 0, true>::Get(); // No such speed
+  (void)StaticClockConfigCodes<3U, 0U, 0U, 2U, true>::Get();          // Unlisted MUL code
+#endif // if (CLOCK_CONFIG_SHOW_ERRORS == 1)
+
+  printf("%lu failures\n", static_cast<unsigned long>(s_Failures));
+  return (s_Failures == 0U) ? 0 : 1;
+}
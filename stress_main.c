@@ -0,0 +1,480 @@
+/**
+ * @file    stress_main.c
+ * @brief   Multi-threaded stress test of the RCC ownership token
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Host threads stand in for RTOS tasks and interrupts and all hammer one
+ * simulated RCC at the same time. Each thread repeatedly does one of:
+ *   - a blocking clock switch through SetClockConfig()
+ *   - the same, nested inside its own hold of the token, then checks the RCC
+ *     runs the requested configuration before anyone else can change it
+ *   - a non-blocking switch, polled with yields in between, then completed
+ *   - an "interrupt" that enables a peripheral clock with its own
+ *     unlock/modify/lock transaction
+ *   - a clock notifier registered and unregistered again, as a driver that
+ *     comes up late would
+ * One more thread stands in for the RCC interrupt and calls RCC_IRQHandler()
+ * all the time, so switches are also advanced (and finished) from another
+ * context than the one that started them, without the token. Every register
+ * access yields, so the interrupt also lands in the middle of the steps of
+ * the other threads, even on a single core.
+ *
+ * Properties checked:
+ *   - at most one thread is ever inside a held token
+ *   - every switch either succeeds or returns CLOCK_ERROR_BUSY; a broken
+ *     unlock sequence would show up as CLOCK_ERROR_LOCKED or a timeout
+ *   - a switch done under a held token leaves exactly that configuration,
+ *     locked, with matching cached frequencies, even with the interrupt
+ *     stepping it
+ *   - every peripheral clock write made under the token lands
+ *   - every post-change walk calls two fixed notifiers once each and in
+ *     order, whatever the registrations around them do
+ *   - the token is free and no switch is running at the end
+ *
+ * Usage: stress.out [--threads <n>] [--iterations <n>] [--seed <n>]
+ *
+ * Build with MOCK_REGISTERS = 1, e.g.
+ *   clang -DMOCK_REGISTERS=1 startup.c clock_solver.c clock_notify.c clock_profile.c clock_fast_start.c clock_gate.c clock_governor.c clock_health.c clock_restart.c cycle_counter.c power_profile.c rcc_owner.c rcc_txn.c rcc_trace.c rcc_sim.c usart_baud.c stress_main.c -o stress.out -lpthread
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include "rcc_access.h"
+#include "rcc_txn.h"
+#include "rcc_owner.h"
+#include "startup.h"
+#include "clock_notify.h"
+
+#define STRESS_DEFAULT_THREADS           4U
+#define STRESS_DEFAULT_ITERATIONS        5000U
+#define STRESS_DEFAULT_SEED              0x5EED5EEDUL
+#define STRESS_MAX_THREADS               16U
+
+typedef enum
+{
+  STRESS_ACTION_SWITCH = 0,
+  STRESS_ACTION_NESTED_SWITCH,
+  STRESS_ACTION_SPLIT_SWITCH,
+  STRESS_ACTION_PERIPHERAL,
+  STRESS_ACTION_NOTIFIER,
+  STRESS_ACTION_COUNT
+} Stress_Action_t;
+
+static const char *const s_ActionNames[STRESS_ACTION_COUNT] =
+{
+  "switch", "nested_switch", "split_switch", "peripheral", "notifier"
+};
+
+/**
+ * @brief Per-thread state and results
+ */
+typedef struct
+{
+  pthread_t thread;
+  uint32_t index;
+  uint64_t rng;
+  uint32_t iterations;
+  uint32_t done[STRESS_ACTION_COUNT];       /*!< Actions that got the RCC          */
+  uint32_t busy[STRESS_ACTION_COUNT];       /*!< Actions turned away (token taken) */
+  uint32_t errors;
+} Stress_Thread_t;
+
+static Stress_Thread_t s_Threads[STRESS_MAX_THREADS];
+static atomic_uint s_Inside;                /*!< Threads inside a held token, must stay <= 1 */
+static atomic_uint s_Violations;
+static atomic_bool s_IsStopping;            /*!< Ends the interrupt thread                   */
+static atomic_uint s_NotifyStep;            /*!< 1 between the two fixed post-change notifiers */
+static atomic_uint s_NotifyViolations;
+static uint32_t s_IrqCount;                 /*!< RCC_IRQHandler() calls, interrupt thread only */
+
+/**
+ * @brief  xorshift64* generator, one state per thread
+ */
+static uint32_t Random(Stress_Thread_t *self)
+{
+  self->rng ^= self->rng >> 12;
+  self->rng ^= self->rng << 25;
+  self->rng ^= self->rng >> 27;
+  return (uint32_t)((self->rng * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+/**
+ * @brief  Picks a random configuration that passes BuildClockConfig()
+ */
+static void RandomConfig(Stress_Thread_t *self, Clock_Config_t *config)
+{
+  static const unsigned int busClockDividers[] = { 0U, 2U, 4U };
+  System_Clock_Speeds_t speed;
+  unsigned int busClockDivider;
+  bool isHsiClock;
+  do
+  {
+    speed = (System_Clock_Speeds_t)(1U + (Random(self) % (uint32_t)SYS_CLOCK_SPEED_MAX_ENUM_VAL));
+    busClockDivider = busClockDividers[Random(self) % 3U];
+    isHsiClock = ((Random(self) & 1U) == 0U);
+  } while (BuildClockConfig(speed, busClockDivider, isHsiClock, config) != CLOCK_OK);
+}
+
+static void Fail(Stress_Thread_t *self, const char *what, int32_t status)
+{
+  self->errors++;
+  if (self->errors <= 5U)
+  {
+    fprintf(stderr, "FAIL thread %u: %s (status %d)\n", self->index, what, status);
+  }
+}
+
+/**
+ * @brief  Takes the token for the test itself and checks mutual exclusion
+ */
+static bool Enter(uint32_t ownerId)
+{
+  if (!RccOwner_TryAcquire(ownerId))
+  {
+    return false;
+  }
+  if (atomic_fetch_add(&s_Inside, 1U) != 0U)
+  {
+    atomic_fetch_add(&s_Violations, 1U);
+  }
+  return true;
+}
+
+static void Leave(uint32_t ownerId)
+{
+  atomic_fetch_sub(&s_Inside, 1U);
+  (void)RccOwner_Release(ownerId);
+}
+
+/**
+ * @brief  Checks the RCC runs the configuration, locked, with a matching cache
+ * @note   Only called while holding the token.
+ */
+static bool IsRunning(const Clock_Config_t *config)
+{
+  uint32_t cr = RccSim_Peek(RCC_CR_OFFSET);
+  uint32_t clksel = config->isHsiClock ? RCC_CR_CLKSEL_0 : RCC_CR_CLKSEL_1;
+  return ((cr & RCC_CR_CLKSEL) == clksel) && ((cr & RCC_CR_DEF_CLOCK) == 0U) &&
+         ((cr & (RCC_CR_SYS_DIV | RCC_CR_BUS_DIV)) == config->crDividers) &&
+         (RccSim_Peek(RCC_PLLCFGR_OFFSET) == config->pllcfgr) &&
+         ((RccSim_Peek(RCC_LOCK_OFFSET) & RCC_LOCK_LOCK_STATUS) != 0U) &&
+         (GetSystemClockHz() == GetClockConfigSysClockHz(config)) &&
+         (GetBusClockHz() == GetClockConfigBusClockHz(config));
+}
+
+/**
+ * @brief  Checks a switch either ran or was turned away
+ * @retval true if the switch ran
+ */
+static bool CheckSwitch(Stress_Thread_t *self, Stress_Action_t action, int32_t status)
+{
+  if (status == CLOCK_ERROR_BUSY)
+  {
+    self->busy[action]++;
+    return false;
+  }
+  if (status != CLOCK_OK)
+  {
+    Fail(self, s_ActionNames[action], status);
+    return false;
+  }
+  self->done[action]++;
+  return true;
+}
+
+static void NestedSwitch(Stress_Thread_t *self, uint32_t ownerId)
+{
+  Clock_Config_t config;
+  RandomConfig(self, &config);
+  if (!Enter(ownerId))
+  {
+    self->busy[STRESS_ACTION_NESTED_SWITCH]++;
+    return;
+  }
+
+  int32_t status = SetClockConfig(&config);
+  if (RccOwner_GetDepth() != 1U)
+  {
+    Fail(self, "token depth after nested switch", (int32_t)RccOwner_GetDepth());
+  }
+  if (CheckSwitch(self, STRESS_ACTION_NESTED_SWITCH, status) && !IsRunning(&config))
+  {
+    Fail(self, "RCC does not run the switched configuration", status);
+  }
+  Leave(ownerId);
+}
+
+static void SplitSwitch(Stress_Thread_t *self)
+{
+  Clock_Config_t config;
+  RandomConfig(self, &config);
+  int32_t status = StartClockSwitchConfig(&config, NULL, NULL);
+  if (status == CLOCK_OK)
+  {
+    // Other threads keep trying the RCC while this one polls
+    for (uint32_t i = 0U; i < 8U; i++)
+    {
+      (void)PollClockSwitch();
+      sched_yield();
+    }
+    status = CompleteSystemAndBusClockConfig();
+  }
+  (void)CheckSwitch(self, STRESS_ACTION_SPLIT_SWITCH, status);
+}
+
+/**
+ * @brief  Toggles one APB1 peripheral clock, as a driver ISR would
+ */
+static void Peripheral(Stress_Thread_t *self, uint32_t ownerId)
+{
+  if (!Enter(ownerId))
+  {
+    self->busy[STRESS_ACTION_PERIPHERAL]++;
+    return;
+  }
+
+  uint32_t bit = 1UL << (self->index % 32U);
+  Rcc_Txn_t txn;
+  RccTxn_Begin(&txn);
+  uint32_t value = RccTxn_Read(&txn, RCC_APB1ENR_OFFSET) ^ bit;
+  RccTxn_Unlock(&txn);
+  RccTxn_Write(&txn, RCC_APB1ENR_OFFSET, value);
+  RccTxn_Lock(&txn);
+  RccTxn_Commit(&txn);
+  if (RccSim_Peek(RCC_APB1ENR_OFFSET) != value)
+  {
+    Fail(self, "peripheral clock write lost", 0);
+  }
+  self->done[STRESS_ACTION_PERIPHERAL]++;
+  Leave(ownerId);
+}
+
+/**
+ * @brief  Runs first of the two fixed notifiers after a change
+ */
+static void FirstPostChange(const Clock_Notify_Info_t *info, void *context)
+{
+  (void)info;
+  (void)context;
+  if (atomic_exchange(&s_NotifyStep, 1U) != 0U)
+  {
+    (void)atomic_fetch_add(&s_NotifyViolations, 1U);
+  }
+}
+
+/**
+ * @brief  Runs last of the two fixed notifiers after a change
+ */
+static void LastPostChange(const Clock_Notify_Info_t *info, void *context)
+{
+  (void)info;
+  (void)context;
+  if (atomic_exchange(&s_NotifyStep, 0U) != 1U)
+  {
+    (void)atomic_fetch_add(&s_NotifyViolations, 1U);
+  }
+}
+
+static void IgnorePostChange(const Clock_Notify_Info_t *info, void *context)
+{
+  (void)info;
+  (void)context;
+}
+
+/**
+ * @brief  Registers a notifier at a random priority and takes it out again
+ */
+static void Notifier(Stress_Thread_t *self)
+{
+  int32_t handle = ClockNotify_Register(NULL, IgnorePostChange, (uint8_t)Random(self), NULL);
+  if ((handle == CLOCK_ERROR_BUSY) || (handle == CLOCK_ERROR_REGISTRY_FULL))
+  {
+    self->busy[STRESS_ACTION_NOTIFIER]++;
+    return;
+  }
+  if (handle < 0)
+  {
+    Fail(self, "notifier not registered", handle);
+    return;
+  }
+
+  // Turned away while a switch or walk runs, the table must lose it later
+  int32_t status;
+  while ((status = ClockNotify_Unregister(handle)) == CLOCK_ERROR_BUSY)
+  {
+    sched_yield();
+  }
+  if (status != CLOCK_OK)
+  {
+    Fail(self, "notifier not unregistered", status);
+    return;
+  }
+  self->done[STRESS_ACTION_NOTIFIER]++;
+}
+
+static void *StressThread(void *arg)
+{
+  Stress_Thread_t *self = (Stress_Thread_t *)arg;
+  uint32_t ownerId = RccOwner_GetContextId();
+
+  for (uint32_t i = 0U; i < self->iterations; i++)
+  {
+    Stress_Action_t action = (Stress_Action_t)(Random(self) % (uint32_t)STRESS_ACTION_COUNT);
+    switch (action)
+    {
+      case STRESS_ACTION_SWITCH:
+      {
+        Clock_Config_t config;
+        RandomConfig(self, &config);
+        (void)CheckSwitch(self, action, SetClockConfig(&config));
+        break;
+      }
+      case STRESS_ACTION_NESTED_SWITCH:
+        NestedSwitch(self, ownerId);
+        break;
+      case STRESS_ACTION_SPLIT_SWITCH:
+        SplitSwitch(self);
+        break;
+      case STRESS_ACTION_NOTIFIER:
+        Notifier(self);
+        break;
+      default:
+        Peripheral(self, ownerId);
+        break;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief  Plays the RCC interrupt, firing at any point of the other threads
+ */
+static void *IrqThread(void *arg)
+{
+  (void)arg;
+  while (!atomic_load(&s_IsStopping))
+  {
+    RCC_IRQHandler();
+    s_IrqCount++;
+    sched_yield();
+  }
+  return NULL;
+}
+
+/**
+ * @brief  Lets the other threads in between any two register accesses
+ */
+static void YieldOnAccess(void *context)
+{
+  (void)context;
+  sched_yield();
+}
+
+int32_t main(int argc, char **argv)
+{
+  uint32_t threads = STRESS_DEFAULT_THREADS;
+  uint32_t iterations = STRESS_DEFAULT_ITERATIONS;
+  uint64_t seed = STRESS_DEFAULT_SEED;
+  for (int i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "--threads") == 0) && ((i + 1) < argc))
+    {
+      threads = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else if ((strcmp(argv[i], "--iterations") == 0) && ((i + 1) < argc))
+    {
+      iterations = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else if ((strcmp(argv[i], "--seed") == 0) && ((i + 1) < argc))
+    {
+      seed = strtoull(argv[++i], NULL, 0);
+    }
+    else
+    {
+      fprintf(stderr, "Usage: %s [--threads <n>] [--iterations <n>] [--seed <n>]\n", argv[0]);
+      return 2;
+    }
+  }
+  if ((threads == 0U) || (threads > STRESS_MAX_THREADS))
+  {
+    fprintf(stderr, "--threads must be 1..%u\n", STRESS_MAX_THREADS);
+    return 2;
+  }
+
+  RccSim_Init(NULL);
+  // Post-change runs highest priority value first
+  int32_t firstHandle = ClockNotify_Register(NULL, FirstPostChange, 255U, NULL);
+  int32_t lastHandle = ClockNotify_Register(NULL, LastPostChange, 0U, NULL);
+  if ((firstHandle < 0) || (lastHandle < 0))
+  {
+    fprintf(stderr, "Cannot register the fixed notifiers\n");
+    return 2;
+  }
+  RccSim_SetAccessHook(YieldOnAccess, NULL);
+  pthread_t irqThread;
+  if (pthread_create(&irqThread, NULL, IrqThread, NULL) != 0)
+  {
+    fprintf(stderr, "Cannot start the interrupt thread\n");
+    return 2;
+  }
+  for (uint32_t i = 0U; i < threads; i++)
+  {
+    s_Threads[i].index = i;
+    s_Threads[i].rng = (seed ^ ((uint64_t)(i + 1U) * 0x9E3779B97F4A7C15ULL)) | 1U;
+    s_Threads[i].iterations = iterations;
+    if (pthread_create(&s_Threads[i].thread, NULL, StressThread, &s_Threads[i]) != 0)
+    {
+      fprintf(stderr, "Cannot start thread %u\n", i);
+      return 2;
+    }
+  }
+
+  uint32_t errors = 0U;
+  uint32_t done[STRESS_ACTION_COUNT] = { 0U };
+  uint32_t busy[STRESS_ACTION_COUNT] = { 0U };
+  for (uint32_t i = 0U; i < threads; i++)
+  {
+    (void)pthread_join(s_Threads[i].thread, NULL);
+    errors += s_Threads[i].errors;
+    for (uint32_t action = 0U; action < (uint32_t)STRESS_ACTION_COUNT; action++)
+    {
+      done[action] += s_Threads[i].done[action];
+      busy[action] += s_Threads[i].busy[action];
+    }
+  }
+  atomic_store(&s_IsStopping, true);
+  (void)pthread_join(irqThread, NULL);
+
+  if (RccOwner_GetOwner() != RCC_OWNER_NONE)
+  {
+    fprintf(stderr, "FAIL: token still held by %u\n", RccOwner_GetOwner());
+    errors++;
+  }
+  if (IsClockSwitchInProgress())
+  {
+    fprintf(stderr, "FAIL: switch still running\n");
+    errors++;
+  }
+  if (atomic_load(&s_NotifyStep) != 0U)
+  {
+    fprintf(stderr, "FAIL: post-change walk cut short\n");
+    errors++;
+  }
+  errors += atomic_load(&s_Violations) + atomic_load(&s_NotifyViolations);
+
+  printf("action,done,busy\n");
+  for (uint32_t action = 0U; action < (uint32_t)STRESS_ACTION_COUNT; action++)
+  {
+    printf("%s,%u,%u\n", s_ActionNames[action], done[action], busy[action]);
+  }
+  printf("%u threads x %u iterations, %u interrupts, %u exclusion violations, %u notifier violations, %u errors\n",
+         threads, iterations, s_IrqCount, atomic_load(&s_Violations), atomic_load(&s_NotifyViolations), errors);
+  return (errors == 0U) ? 0 : 1;
+}
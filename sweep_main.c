@@ -0,0 +1,291 @@
+/**
+ * @file    sweep_main.c
+ * @brief   Parallel sweep of simulated boots on independent RCC instances
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Every boot gets its own random clock configuration, RCC latencies (up to
+ * the manual's limits) and, for some boots, an injected fault. The boots are
+ * spread over host threads; each thread owns one simulated RCC (RccSim_t) and
+ * one clock driver (Clock_Driver_t) and re-initializes them for every boot,
+ * so the threads share nothing.
+ *
+ * Each boot is drawn from its own seed, so the results do not depend on the
+ * number of threads. All boots are then run once more, one after the other,
+ * on the RCC at RCC_BASE through the classic API, and every status, cycle
+ * count and clock frequency must match.
+ *
+ * Properties checked:
+ *   - every boot without a fault runs the requested configuration
+ *   - parallel and serial runs agree boot for boot
+ *
+ * Usage: sweep.out [--threads <n>] [--boots <n>] [--seed <n>]
+ *
+ * Build with MOCK_REGISTERS = 1, e.g.
+ *   clang -DMOCK_REGISTERS=1 startup.c clock_solver.c clock_notify.c clock_profile.c clock_fast_start.c clock_gate.c clock_governor.c clock_health.c clock_restart.c cycle_counter.c power_profile.c rcc_owner.c rcc_txn.c rcc_trace.c rcc_sim.c usart_baud.c sweep_main.c -o sweep.out -lpthread
+ *
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include "rcc_access.h"
+#include "startup.h"
+
+#define SWEEP_DEFAULT_THREADS            4U
+#define SWEEP_DEFAULT_BOOTS              20000U
+#define SWEEP_DEFAULT_SEED               0x5EED5EEDUL
+#define SWEEP_MAX_THREADS                64U
+#define SWEEP_FAULT_ONE_IN               4U      /*!< Share of boots with an injected fault */
+#define SWEEP_FAULT_WINDOW_CYCLES        8000U   /*!< Faults land within this many cycles   */
+
+/**
+ * @brief Everything a boot needs, drawn from its seed
+ */
+typedef struct
+{
+  Clock_Config_t config;
+  RccSim_Timing_t timing;
+  RccSim_Fault_t fault;
+  uint64_t faultAt;
+} Sweep_Boot_t;
+
+/**
+ * @brief What a boot ended with
+ */
+typedef struct
+{
+  int32_t status;
+  uint64_t cycles;
+  uint32_t sysClockHz;
+  uint32_t busClockHz;
+  uint32_t cr;
+} Sweep_Result_t;
+
+/**
+ * @brief Per-thread state
+ */
+typedef struct
+{
+  pthread_t thread;
+  uint32_t index;
+  uint32_t stride;
+  uint32_t boots;
+  uint64_t seed;
+  Sweep_Result_t *results;
+  RccSim_t sim;
+  Clock_Driver_t driver;
+} Sweep_Thread_t;
+
+static Sweep_Thread_t s_Threads[SWEEP_MAX_THREADS];
+
+/**
+ * @brief  xorshift64* generator
+ */
+static uint32_t Random(uint64_t *rng)
+{
+  *rng ^= *rng >> 12;
+  *rng ^= *rng << 25;
+  *rng ^= *rng >> 27;
+  return (uint32_t)((*rng * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+/**
+ * @brief  Draws boot number index of the sweep
+ */
+static void DrawBoot(uint64_t seed, uint32_t index, Sweep_Boot_t *boot)
+{
+  static const unsigned int busClockDividers[] = { 0U, 2U, 4U };
+  uint64_t rng = (seed ^ ((uint64_t)(index + 1U) * 0x9E3779B97F4A7C15ULL)) | 1U;
+
+  System_Clock_Speeds_t speed;
+  unsigned int busClockDivider;
+  bool isHsiClock;
+  do
+  {
+    speed = (System_Clock_Speeds_t)(1U + (Random(&rng) % (uint32_t)SYS_CLOCK_SPEED_MAX_ENUM_VAL));
+    busClockDivider = busClockDividers[Random(&rng) % 3U];
+    isHsiClock = ((Random(&rng) & 1U) == 0U);
+  } while (BuildClockConfig(speed, busClockDivider, isHsiClock, &boot->config) != CLOCK_OK);
+
+  RccSim_GetDefaultTiming(&boot->timing);
+  boot->timing.pllReadyCycles = 1U + (Random(&rng) % RCC_SIM_PLL_RDY_MAX_CYCLES);
+  boot->timing.hsiReadyCycles = 1U + (Random(&rng) % RCC_SIM_HSIRDY_MAX_CYCLES);
+  boot->timing.hseReadyCycles = 1U + (Random(&rng) % RCC_SIM_HSERDY_MAX_CYCLES);
+  boot->timing.clkselSwitchCycles = 1U + (Random(&rng) % RCC_SIM_CLKSEL_MAX_CYCLES);
+
+  boot->fault = RCC_SIM_FAULT_NONE;
+  boot->faultAt = 0U;
+  if ((Random(&rng) % SWEEP_FAULT_ONE_IN) == 0U)
+  {
+    boot->fault = ((Random(&rng) & 1U) == 0U) ? RCC_SIM_FAULT_RELOCK : RCC_SIM_FAULT_FALLBACK;
+    boot->faultAt = Random(&rng) % SWEEP_FAULT_WINDOW_CYCLES;
+  }
+}
+
+static void *SweepThread(void *arg)
+{
+  Sweep_Thread_t *self = (Sweep_Thread_t *)arg;
+  for (uint32_t i = self->index; i < self->boots; i += self->stride)
+  {
+    Sweep_Boot_t boot;
+    DrawBoot(self->seed, i, &boot);
+
+    RccSimInst_Init(&self->sim, &boot.timing);
+    RccSimInst_InjectFault(&self->sim, boot.fault, boot.faultAt);
+    ClockDriver_Init(&self->driver, RccSimInst_GetBase(&self->sim));
+
+    Sweep_Result_t *result = &self->results[i];
+    result->status = ClockDriver_SetClockConfig(&self->driver, &boot.config);
+    result->cycles = RccSimInst_GetCycles(&self->sim);
+    result->sysClockHz = ClockDriver_GetSystemClockHz(&self->driver);
+    result->busClockHz = ClockDriver_GetBusClockHz(&self->driver);
+    result->cr = RccSimInst_Peek(&self->sim, RCC_CR_OFFSET);
+  }
+  return NULL;
+}
+
+/**
+ * @brief  Same boot on the RCC at RCC_BASE through the classic API
+ */
+static void RunSerial(const Sweep_Boot_t *boot, Sweep_Result_t *result)
+{
+  // Every way a switch ends sets the clock cache, so the previous boot's
+  // value does not carry over
+  RccSim_Init(&boot->timing);
+  RccSim_InjectFault(boot->fault, boot->faultAt);
+
+  result->status = SetClockConfig(&boot->config);
+  result->cycles = RccSim_GetCycles();
+  result->sysClockHz = GetSystemClockHz();
+  result->busClockHz = GetBusClockHz();
+  result->cr = RccSim_Peek(RCC_CR_OFFSET);
+}
+
+static bool IsSameResult(const Sweep_Result_t *a, const Sweep_Result_t *b)
+{
+  return (a->status == b->status) && (a->cycles == b->cycles) && (a->sysClockHz == b->sysClockHz) &&
+         (a->busClockHz == b->busClockHz) && (a->cr == b->cr);
+}
+
+static double Seconds(void)
+{
+  struct timespec now;
+  (void)clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+}
+
+int32_t main(int argc, char **argv)
+{
+  uint32_t threads = SWEEP_DEFAULT_THREADS;
+  uint32_t boots = SWEEP_DEFAULT_BOOTS;
+  uint64_t seed = SWEEP_DEFAULT_SEED;
+  for (int i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "--threads") == 0) && ((i + 1) < argc))
+    {
+      threads = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else if ((strcmp(argv[i], "--boots") == 0) && ((i + 1) < argc))
+    {
+      boots = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else if ((strcmp(argv[i], "--seed") == 0) && ((i + 1) < argc))
+    {
+      seed = strtoull(argv[++i], NULL, 0);
+    }
+    else
+    {
+      fprintf(stderr, "Usage: %s [--threads <n>] [--boots <n>] [--seed <n>]\n", argv[0]);
+      return 2;
+    }
+  }
+  if ((threads == 0U) || (threads > SWEEP_MAX_THREADS))
+  {
+    fprintf(stderr, "--threads must be 1..%u\n", SWEEP_MAX_THREADS);
+    return 2;
+  }
+
+  Sweep_Result_t *parallel = calloc(boots, sizeof(Sweep_Result_t));
+  Sweep_Result_t *serial = calloc(boots, sizeof(Sweep_Result_t));
+  if ((boots != 0U) && ((parallel == NULL) || (serial == NULL)))
+  {
+    fprintf(stderr, "Out of memory for %u boots\n", boots);
+    return 2;
+  }
+
+  double start = Seconds();
+  for (uint32_t i = 0U; i < threads; i++)
+  {
+    s_Threads[i].index = i;
+    s_Threads[i].stride = threads;
+    s_Threads[i].boots = boots;
+    s_Threads[i].seed = seed;
+    s_Threads[i].results = parallel;
+    if (pthread_create(&s_Threads[i].thread, NULL, SweepThread, &s_Threads[i]) != 0)
+    {
+      fprintf(stderr, "Cannot start thread %u\n", i);
+      return 2;
+    }
+  }
+  for (uint32_t i = 0U; i < threads; i++)
+  {
+    (void)pthread_join(s_Threads[i].thread, NULL);
+  }
+  double parallelSeconds = Seconds() - start;
+
+  start = Seconds();
+  for (uint32_t i = 0U; i < boots; i++)
+  {
+    Sweep_Boot_t boot;
+    DrawBoot(seed, i, &boot);
+    RunSerial(&boot, &serial[i]);
+  }
+  double serialSeconds = Seconds() - start;
+
+  uint32_t failures = 0U;
+  uint32_t mismatches = 0U;
+  uint32_t faulted = 0U;
+  for (uint32_t i = 0U; i < boots; i++)
+  {
+    Sweep_Boot_t boot;
+    DrawBoot(seed, i, &boot);
+    const Sweep_Result_t *result = &parallel[i];
+    if (boot.fault != RCC_SIM_FAULT_NONE)
+    {
+      faulted++;
+    }
+    else if ((result->status != CLOCK_OK) ||
+             (result->sysClockHz != GetClockConfigSysClockHz(&boot.config)) ||
+             (result->busClockHz != GetClockConfigBusClockHz(&boot.config)) ||
+             ((result->cr & (RCC_CR_SYS_DIV | RCC_CR_BUS_DIV)) != boot.config.crDividers))
+    {
+      failures++;
+      if (failures <= 5U)
+      {
+        fprintf(stderr, "FAIL boot %u: status %d, %lu Hz\n", i, result->status, (unsigned long)result->sysClockHz);
+      }
+    }
+
+    if (!IsSameResult(result, &serial[i]))
+    {
+      mismatches++;
+      if (mismatches <= 5U)
+      {
+        fprintf(stderr, "MISMATCH boot %u: status %d/%d, %llu/%llu cycles\n", i, result->status,
+                serial[i].status, (unsigned long long)result->cycles, (unsigned long long)serial[i].cycles);
+      }
+    }
+  }
+
+  printf("parallel %.3f s, serial %.3f s\n", parallelSeconds, serialSeconds);
+  printf("%u boots (%u with faults) on %u threads, %u mismatches, %u failures\n",
+         boots, faulted, threads, mismatches, failures);
+  free(parallel);
+  free(serial);
+  return ((failures == 0U) && (mismatches == 0U)) ? 0 : 1;
+}
@@ -5,15 +5,367 @@
  * @date    September 2025
  *
  * This file can be used to test different inputs into startup.c. Could also be used to make rough unit tests too.
+ * Build with MOCK_REGISTERS = 1 so that the RCC is backed by the simulator in rcc_sim.c.
+ * With RCC_TRACE_ENABLE = 1 the first bring-up is also traced to the file given as the
+ * first argument (default rcc_trace.bin) for trace_analyze.c.
  *
  */
 #include <stdio.h>
 #include "startup.h"
+#include "clock_solver.h"
+#include "clock_notify.h"
+#include "clock_profile.h"
+#include "clock_fast_start.h"
+#include "clock_gate.h"
+#include "clock_governor.h"
+#include "power_profile.h"
+#include "clock_restart.h"
+#include "clock_health.h"
+#include "usart_baud.h"
+#include "rcc_owner.h"
+#include "rcc_access.h"
 
-int32_t main(void)
+static void OnClockSwitchDone(int32_t status, void *context)
 {
+  (void)context;
+  printf("Clock switch callback, status %d\n", status);
+}
+
+static void OnClockPreChange(const Clock_Notify_Info_t *info, void *context)
+{
+  printf("  %s: pause, %lu -> %lu Hz bus\n", (const char *)context,
+         (unsigned long)info->oldBusClockHz, (unsigned long)info->newBusClockHz);
+}
+
+static void OnClockPostChange(const Clock_Notify_Info_t *info, void *context)
+{
+  printf("  %s: resume at %lu Hz bus, status %d\n", (const char *)context,
+         (unsigned long)info->newBusClockHz, info->status);
+}
+
+#if (CLOCK_PROFILE_ENABLE == 1)
+static void PrintClockProfile(void)
+{
+  static const char *const phaseNames[CLOCK_PHASE_COUNT] =
+  {
+    "unlock", "def_clock", "pll_lock", "osc_ready", "clksel", "relock"
+  };
+
+  for (uint32_t phase = 0U; phase < (uint32_t)CLOCK_PHASE_COUNT; phase++)
+  {
+    Clock_Profile_Stats_t stats;
+    if (ClockProfile_GetStats((Clock_Phase_t)phase, &stats))
+    {
+      printf("Phase %-9s count %lu, min %lu, max %lu, mean %lu cycles\n", phaseNames[phase],
+             (unsigned long)stats.count, (unsigned long)stats.minCycles,
+             (unsigned long)stats.maxCycles, (unsigned long)stats.meanCycles);
+    }
+  }
+}
+#endif // if (CLOCK_PROFILE_ENABLE == 1)
+
+static void PrintClockCache(void)
+{
+  printf("Cached clocks: system %lu Hz, bus %lu Hz\n",
+         (unsigned long)GetSystemClockHz(), (unsigned long)GetBusClockHz());
+}
+
+int32_t main(int argc, char **argv)
+{
+  RccSim_Init(NULL);
+  PrintClockCache();
+
+#if (RCC_TRACE_ENABLE == 1)
+  RccTrace_Start();
+#endif // if (RCC_TRACE_ENABLE == 1)
+  uint64_t startCycles = RccSim_GetCycles();
   int32_t retVal = SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_10M, 0, false);
-  printf("Run complete! Return value is: %d\n", retVal);
+#if (RCC_TRACE_ENABLE == 1)
+  RccTrace_Stop();
+  const char *tracePath = (argc > 1) ? argv[1] : "rcc_trace.bin";
+  printf("Traced %lu records (%lu accesses dropped) to %s: %s\n", (unsigned long)RccTrace_GetRecordCount(),
+         (unsigned long)RccTrace_GetDroppedCount(), tracePath, RccTrace_SaveFile(tracePath) ? "ok" : "failed");
+#else
+  (void)argc;
+  (void)argv;
+#endif // if (RCC_TRACE_ENABLE == 1)
+  printf("Run complete! Return value is: %d, clock bring-up took %llu cycles\n",
+         retVal, (unsigned long long)(RccSim_GetCycles() - startCycles));
+  printf("Waits: PLL_RDY %lu, HSERDY %lu, CLKSEL %lu cycles\n",
+         (unsigned long)GetClockWaitCycles(CLOCK_WAIT_PLL_READY),
+         (unsigned long)GetClockWaitCycles(CLOCK_WAIT_OSC_READY),
+         (unsigned long)GetClockWaitCycles(CLOCK_WAIT_CLKSEL));
+
+  startCycles = RccSim_GetCycles();
+  retVal = SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_40M, 2, true);
+  printf("Run complete! Return value is: %d, clock bring-up took %llu cycles\n",
+         retVal, (unsigned long long)(RccSim_GetCycles() - startCycles));
+
+  // Split-phase: do 3000 cycles of other start-up work while the HSE settles
+  RccSim_Init(NULL);
+  startCycles = RccSim_GetCycles();
+  retVal = BeginSystemAndBusClockConfig(SYS_CLOCK_SPEED_10M, 0, false);
+  RccSim_Advance(3000U);
+  if (retVal == CLOCK_OK)
+  {
+    retVal = CompleteSystemAndBusClockConfig();
+  }
+  printf("Run complete! Return value is: %d, split-phase bring-up plus 3000 cycles of work took %llu cycles\n",
+         retVal, (unsigned long long)(RccSim_GetCycles() - startCycles));
+
+  // Non-blocking runtime switch driven by RCC_IRQn, with other work in between
+  startCycles = RccSim_GetCycles();
+  retVal = StartClockSwitch(SYS_CLOCK_SPEED_20M, 0, true, OnClockSwitchDone, NULL);
+  while ((retVal == CLOCK_OK) && IsClockSwitchInProgress())
+  {
+    RccSim_Advance(100U);
+    if (RccSim_TakeInterrupt())
+    {
+      RCC_IRQHandler();
+    }
+  }
+  printf("Run complete! Return value is: %d, interrupt-driven switch took %llu cycles\n",
+         PollClockSwitch(), (unsigned long long)(RccSim_GetCycles() - startCycles));
+
+  // Drivers notified around runtime changes: USART1 pauses first, resumes last
+  (void)ClockNotify_Register(OnClockPreChange, OnClockPostChange, 1U, "USART1");
+  int32_t timHandle = ClockNotify_Register(OnClockPreChange, OnClockPostChange, 5U, "TIM2");
+
+  // Incremental reconfiguration: same config again, then a bus divider change only
+  startCycles = RccSim_GetCycles();
+  retVal = SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_20M, 0, true);
+  printf("Run complete! Return value is: %d, no-op reconfiguration took %llu cycles\n",
+         retVal, (unsigned long long)(RccSim_GetCycles() - startCycles));
+
+  startCycles = RccSim_GetCycles();
+  retVal = SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_20M, 2, true);
+  printf("Run complete! Return value is: %d, divider-only reconfiguration took %llu cycles\n",
+         retVal, (unsigned long long)(RccSim_GetCycles() - startCycles));
+
+  (void)ClockNotify_Unregister(timHandle);
+
+  // Hz-based configuration: highest legal bus clock, or the reason it can't be done
+  Clock_Config_t config;
+  retVal = SolveClockConfig(10000000UL, 5000000UL, false, &config);
+  printf("Solve 10MHz (bus <= 5MHz): %d, PLLCFGR 0x%02lx, CR dividers 0x%03lx, bus %lu Hz\n", retVal,
+         (unsigned long)config.pllcfgr, (unsigned long)config.crDividers,
+         (unsigned long)GetClockConfigBusClockHz(&config));
+  printf("Solve 160MHz: %d, solve 30MHz: %d\n",
+         SolveClockConfig(160000000UL, CLOCK_MAX_BUS_CLOCK_HZ, true, &config),
+         SolveClockConfig(30000000UL, CLOCK_MAX_BUS_CLOCK_HZ, true, &config));
+
+  startCycles = RccSim_GetCycles();
+  retVal = SetSystemClockHz(2500000UL, CLOCK_MAX_BUS_CLOCK_HZ, true);
+  printf("Run complete! Return value is: %d, 2.5MHz by Hz took %llu cycles\n",
+         retVal, (unsigned long long)(RccSim_GetCycles() - startCycles));
+  PrintClockCache();
+
+#if (CLOCK_PROFILE_ENABLE == 1)
+  PrintClockProfile();
+#endif // if (CLOCK_PROFILE_ENABLE == 1)
+
+  // A failed switch leaves the RCC on DEF_CLOCK, which the cache reports as 8MHz
+  RccSim_Timing_t timing;
+  RccSim_GetDefaultTiming(&timing);
+  timing.pllReadyCycles = 100000U;
+  RccSim_Init(&timing);
+  retVal = SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_20M, 0, true);
+  printf("Run complete! Return value is: %d with a PLL that never locks, gave up after %lu cycles\n",
+         retVal, (unsigned long)GetClockWaitCycles(CLOCK_WAIT_PLL_READY));
+  PrintClockCache();
+
+  // Dead crystal: HSE preferred, HSI takes over within the boot budget
+  timing.pllReadyCycles = RCC_SIM_PLL_RDY_MAX_CYCLES;
+  timing.hseReadyCycles = RCC_SIM_NEVER;
+  RccSim_Init(&timing);
+  bool isHsiClockUsed = false;
+  uint32_t budgetCycles = GetClockFallbackMinBudget(false);
+  startCycles = RccSim_GetCycles();
+  retVal = SetSystemAndBusClockConfigWithFallback(SYS_CLOCK_SPEED_20M, 0, false, budgetCycles, &isHsiClockUsed);
+  printf("Run complete! Return value is: %d, running on %s after %llu of %lu budgeted cycles\n",
+         retVal, isHsiClockUsed ? "HSI" : "HSE", (unsigned long long)(RccSim_GetCycles() - startCycles),
+         (unsigned long)budgetCycles);
+  PrintClockCache();
+
+  // Fast start: full speed on HSI right away, HSE taken over in the background
+  RccSim_Init(NULL);
+  Clock_Config_t fastConfig;
+  (void)BuildClockConfig(SYS_CLOCK_SPEED_20M, 0, false, &fastConfig);
+  startCycles = RccSim_GetCycles();
+  retVal = ClockFastStart_Begin(&fastConfig);
+  printf("Run complete! Return value is: %d, running on HSI after %llu cycles\n",
+         retVal, (unsigned long long)(RccSim_GetCycles() - startCycles));
+  Clock_Migration_State_t migration = ClockFastStart_GetState();
+  while ((migration == CLOCK_MIGRATION_WAIT_HSE) || (migration == CLOCK_MIGRATION_SWITCHING))
+  {
+    RccSim_Advance(100U);   // Application work at full speed
+    migration = ClockFastStart_Poll();
+  }
+  printf("Migration state %d, status %d, on HSE after %llu cycles\n", ClockFastStart_GetState(),
+         ClockFastStart_GetStatus(), (unsigned long long)(RccSim_GetCycles() - startCycles));
+
+  // Another context (e.g. an interrupt) owning the RCC turns the switch away instead of breaking it
+  const uint32_t isrOwnerId = 0x100U;
+  (void)RccOwner_TryAcquire(isrOwnerId);
+  retVal = SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_10M, 0, true);
+  (void)RccOwner_Release(isrOwnerId);
+  printf("Run complete! Return value is: %d while another context owns the RCC, %d once released\n",
+         retVal, SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_10M, 0, true));
+
+  // Peripheral clocks: one store per enable register, then gate everything but GPIOA and USART1
+  Clock_Peripheral_Set_t peripherals = CLOCK_PERIPH_SET(CLOCK_PERIPH_GPIOA) | CLOCK_PERIPH_SET(CLOCK_PERIPH_GPIOB) |
+                                       CLOCK_PERIPH_SET(CLOCK_PERIPH_USART1) | CLOCK_PERIPH_SET(CLOCK_PERIPH_USART2) |
+                                       CLOCK_PERIPH_SET(CLOCK_PERIPH_SPI1) | CLOCK_PERIPH_SET(CLOCK_PERIPH_I2C1) |
+                                       CLOCK_PERIPH_SET(CLOCK_PERIPH_TIM1) | CLOCK_PERIPH_SET(CLOCK_PERIPH_TIM2) |
+                                       CLOCK_PERIPH_SET(CLOCK_PERIPH_DMA1) | CLOCK_PERIPH_SET(CLOCK_PERIPH_DMA2);
+  RccSim_ResetAccessCounts();
+  retVal = ClockGate_Enable(peripherals);
+  printf("Enable 10 peripherals: %d, %lu reads, %lu writes, AHB1ENR 0x%08lx APB1ENR 0x%08lx APB2ENR 0x%08lx\n", retVal,
+         (unsigned long)RccSim_GetReadCount(), (unsigned long)RccSim_GetWriteCount(),
+         (unsigned long)RccSim_Peek(RCC_AHB1ENR_OFFSET), (unsigned long)RccSim_Peek(RCC_APB1ENR_OFFSET),
+         (unsigned long)RccSim_Peek(RCC_APB2ENR_OFFSET));
+  retVal = ClockGate_Reset(CLOCK_PERIPH_SET(CLOCK_PERIPH_USART2) | CLOCK_PERIPH_SET(CLOCK_PERIPH_SPI1));
+  printf("Reset USART2 and SPI1: %d, APB1RSTR 0x%08lx\n", retVal, (unsigned long)RccSim_Peek(RCC_APB1RSTR_OFFSET));
+  retVal = ClockGate_SetEnabled(CLOCK_PERIPH_SET(CLOCK_PERIPH_GPIOA) | CLOCK_PERIPH_SET(CLOCK_PERIPH_USART1));
+  printf("Gate all but GPIOA and USART1: %d, enabled set 0x%llx\n", retVal,
+         (unsigned long long)ClockGate_GetEnabled());
+
+  // Power profiles: burst and run share a PLL setting, so moving between them is divider-only
+  (void)PowerProfile_Init(g_PowerProfileDefaults, POWER_PROFILE_DEFAULT_COUNT);
+  static const uint32_t profileSequence[] = { POWER_PROFILE_BURST, POWER_PROFILE_RUN, POWER_PROFILE_BURST,
+                                              POWER_PROFILE_IDLE, POWER_PROFILE_RUN };
+  for (uint32_t i = 0U; i < (sizeof(profileSequence) / sizeof(profileSequence[0])); i++)
+  {
+    uint32_t profile = profileSequence[i];
+    RccSim_ResetAccessCounts();
+    startCycles = RccSim_GetCycles();
+    retVal = PowerProfile_Apply(profile);
+    printf("Profile %-5s: %d, %llu cycles, %lu writes, system %lu Hz, bus %lu Hz, APB1LPENR 0x%08lx\n",
+           g_PowerProfileDefaults[profile].name, retVal, (unsigned long long)(RccSim_GetCycles() - startCycles),
+           (unsigned long)RccSim_GetWriteCount(), (unsigned long)GetSystemClockHz(),
+           (unsigned long)GetBusClockHz(), (unsigned long)RccSim_Peek(RCC_APB1LPENR_OFFSET));
+  }
+
+  // Governor: 10 nearly idle windows, then 10 at full load, one level per window
+  const Clock_Governor_Config_t governorConfig =
+  {
+    .maxSysClockSpeed = SYS_CLOCK_SPEED_80M, .minSysClockSpeed = SYS_CLOCK_SPEED_1_25M, .isHsiClock = true,
+    .windowCycles = 20000U, .upPercent = 80U, .downPercent = 30U
+  };
+  retVal = ClockGovernor_Init(&governorConfig);
+  printf("Governor started: %d\n", retVal);
+  System_Clock_Speeds_t governorSpeed = ClockGovernor_GetSysClockSpeed();
+  for (uint32_t window = 0U; window < 20U; window++)
+  {
+    uint32_t busyCycles = (window < 10U) ? 1000U : 20000U;
+    startCycles = RccSim_GetCycles();
+    while ((RccSim_GetCycles() - startCycles) < 20000U)
+    {
+      RccSim_Advance(busyCycles / 20U);
+      ClockGovernor_IdleEnter();
+      RccSim_Advance((20000U - busyCycles) / 20U);
+      ClockGovernor_IdleExit();
+      retVal = ClockGovernor_Update();
+    }
+    if (ClockGovernor_GetSysClockSpeed() != governorSpeed)
+    {
+      governorSpeed = ClockGovernor_GetSysClockSpeed();
+      printf("Window %2lu: utilization %3lu%%, system %lu Hz (%d)\n", (unsigned long)window,
+             (unsigned long)ClockGovernor_GetUtilization(), (unsigned long)GetSystemClockHz(), retVal);
+    }
+  }
+
+  // Second chip: its own simulated RCC and driver, the RCC at RCC_BASE is left alone
+  RccSim_t otherSim;
+  Clock_Driver_t otherDriver;
+  RccSimInst_Init(&otherSim, NULL);
+  ClockDriver_Init(&otherDriver, RccSimInst_GetBase(&otherSim));
+  uint32_t systemCr = RccSim_Peek(RCC_CR_OFFSET);
+  startCycles = RccSim_GetCycles();
+  retVal = ClockDriver_SetClockConfig(&otherDriver, &fastConfig);
+  printf("Second RCC: %d after %llu cycles, system %lu Hz; first RCC %s, %llu cycles, system %lu Hz\n", retVal,
+         (unsigned long long)RccSimInst_GetCycles(&otherSim), (unsigned long)ClockDriver_GetSystemClockHz(&otherDriver),
+         (RccSim_Peek(RCC_CR_OFFSET) == systemCr) ? "unchanged" : "CHANGED",
+         (unsigned long long)(RccSim_GetCycles() - startCycles), (unsigned long)GetSystemClockHz());
+
+  // Warm restart with a dead crystal: the cold boot spends the fallback
+  // budget on HSE once, a watchdog reset goes straight to the recorded HSI
+  // configuration, and power-on or a lost record start cold again
+  static const char *const resetCauseNames[] = { "power-on", "pin", "software", "IWDG", "WWDG", "low-power" };
+  static const struct
+  {
+    const char *name;
+    uint32_t resetFlags;
+    bool isRecordLost;
+  } restarts[] =
+  {
+    { "Power-on",       0U,                                        false },
+    { "WWDG reset",     RCC_CSR_WWDGRSTF | RCC_CSR_PINRSTF,        false },
+    { "Software reset", RCC_CSR_SFTRSTF | RCC_CSR_PINRSTF,         true  },
+    { "Power-on",       RCC_CSR_PORRSTF | RCC_CSR_PINRSTF,         false },
+  };
+  Clock_Config_t bootConfig;
+  (void)BuildClockConfig(SYS_CLOCK_SPEED_40M, 2, false, &bootConfig);
+  RccSim_Timing_t deadHseTiming;
+  RccSim_GetDefaultTiming(&deadHseTiming);
+  deadHseTiming.hseReadyCycles = RCC_SIM_NEVER;
+  RccSim_Init(&deadHseTiming);
+  for (uint32_t i = 0U; i < (sizeof(restarts) / sizeof(restarts[0])); i++)
+  {
+    if (i != 0U)
+    {
+      RccSim_Reset(restarts[i].resetFlags);
+      SystemClockUpdate();    // The clock cache starts over with the RAM
+    }
+    if (restarts[i].isRecordLost)
+    {
+      ClockRestart_Invalidate();
+    }
+    bool isWarmStart = false;
+    retVal = ClockRestart_Boot(&bootConfig, 8000U, &isWarmStart);
+    printf("%s: %s boot (%s), %d after %llu cycles, system %lu Hz on %s, RCC_CSR 0x%08lx\n", restarts[i].name,
+           isWarmStart ? "warm" : "cold", resetCauseNames[ClockRestart_GetResetCause()], retVal,
+           (unsigned long long)RccSim_GetCycles(), (unsigned long)GetSystemClockHz(),
+           ((RccSim_Peek(RCC_CR_OFFSET) & RCC_CR_CLKSEL) == RCC_CR_CLKSEL_0) ? "HSI" : "HSE",
+           (unsigned long)RccSim_Peek(RCC_CSR_OFFSET));
+  }
+
+  // Silent fallback to DEF_CLOCK while running, caught by the health check
+  // (as from a 100-cycle SysTick) and switched back
+  ClockHealth_Init(true);
+  Clock_Health_t health = ClockHealth_Check();
+  RccSim_InjectFault(RCC_SIM_FAULT_FALLBACK, RccSim_GetCycles() + 50U);
+  RccSim_Advance(100U);
+  Clock_Health_t detected = ClockHealth_Check();
+  printf("Health %d, then %d at %lu Hz\n", health, detected, (unsigned long)GetSystemClockHz());
+  startCycles = RccSim_GetCycles();
+  uint32_t checks = 0U;
+  do
+  {
+    RccSim_Advance(100U);
+    checks++;
+  } while ((ClockHealth_Check() != CLOCK_HEALTH_OK) && (checks < 100U));
+  Clock_Health_Stats_t healthStats;
+  ClockHealth_GetStats(&healthStats);
+  printf("Health %d after %lu more checks, %llu cycles, %lu Hz; %lu checks, %lu faults, %lu fallbacks, "
+         "%lu restores, %lu failed\n", ClockHealth_GetLast(), (unsigned long)checks,
+         (unsigned long long)(RccSim_GetCycles() - startCycles), (unsigned long)GetSystemClockHz(),
+         (unsigned long)healthStats.checks, (unsigned long)healthStats.faults, (unsigned long)healthStats.fallbacks,
+         (unsigned long)healthStats.restores, (unsigned long)healthStats.restoreFailures);
+
+  // Bus divider and BRR chosen together for two USARTs, BRR kept up to date
+  // across a later speed change (the simulator has no USARTs, so plain RAM)
+  static USART_TypeDef usart1;
+  static USART_TypeDef usart2;
+  const Usart_Baud_Port_t ports[] = { { &usart1, 115200U }, { &usart2, 460800U } };
+  Usart_Baud_Plan_t plan;
+  retVal = UsartBaud_Apply(ports, 2U, &plan);
+  printf("USART baud: %d, bus /%lu = %lu Hz, BRR 0x%04lx/0x%04lx, error %lu/%lu ppm\n", retVal,
+         (unsigned long)plan.busClockDivider, (unsigned long)GetBusClockHz(), (unsigned long)usart1.BRR,
+         (unsigned long)usart2.BRR, (unsigned long)plan.errorPpm[0], (unsigned long)plan.errorPpm[1]);
+  retVal = SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_10M, 0, true);
+  printf("After switching to %lu Hz: %d, BRR 0x%04lx/0x%04lx\n", (unsigned long)GetBusClockHz(), retVal,
+         (unsigned long)usart1.BRR, (unsigned long)usart2.BRR);
 
   return 0;
-}
\ No newline at end of file
+}
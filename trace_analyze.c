@@ -0,0 +1,457 @@
+/**
+ * @file    trace_analyze.c
+ * @brief   Host analyzer for RCC access traces (rcc_trace.h)
+ * @author  SMC
+ * @date    September 2025
+ *
+ * Reads a trace saved by RccTrace_SaveFile() or dumped from the target's RAM
+ * buffer and reports:
+ *   - the cycles spent in each bring-up phase. Phases start with the same
+ *     register writes as in the simulator (rcc_sim.h), so the numbers line up
+ *     with bench_main.c except for the first access, whose start is not in
+ *     the trace;
+ *   - every poll, i.e. run of back-to-back reads of one register (repeat
+ *     records count as the reads they stand for);
+ *   - redundant reads: RCC_PLLCFGR or RCC_LOCK read again with no write since
+ *     the last read of it (only software changes them);
+ *   - redundant writes: RCC_CR or RCC_PLLCFGR written with the value it
+ *     already holds, or RCC_LOCK written while known to be locked;
+ *   - late polls: reads of a poll after one that already saw a bit change.
+ *
+ * Usage: trace_analyze <trace file> [--list]
+ *   --list also prints every record with its phase.
+ *
+ * Host tool, builds without the rest of the tree, e.g.
+ *   clang trace_analyze.c -o trace_analyze
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "rcc_access.h"
+#include "rcc_trace.h"
+
+#define TRACE_NUM_REGS                   ((RCC_LOCK_OFFSET / 2UL) + 1UL)   /*!< UNL/UNH are 16-bit */
+#define TRACE_REG_INDEX(offset)          ((offset) / 2UL)
+
+typedef enum
+{
+  TRACE_PHASE_OTHER = 0,
+  TRACE_PHASE_UNLOCK,
+  TRACE_PHASE_DEF_CLOCK,
+  TRACE_PHASE_PLL_LOCK,
+  TRACE_PHASE_OSC_READY,
+  TRACE_PHASE_CLKSEL_SWITCH,
+  TRACE_PHASE_RELOCK,
+  TRACE_PHASE_COUNT
+} Trace_Phase_t;
+
+static const char *const s_PhaseNames[TRACE_PHASE_COUNT] =
+{
+  "other", "unlock", "def_clock", "pll_lock", "osc_ready", "clksel_switch", "relock"
+};
+
+/**
+ * @brief One access, or several identical reads merged by a repeat record
+ */
+typedef struct
+{
+  uint32_t cycles;          /*!< After the first access                    */
+  uint32_t lastCycles;      /*!< After the last access                     */
+  uint32_t count;
+  uint32_t value;
+  uint8_t offset;
+  bool isWrite;
+} Trace_Access_t;
+
+/**
+ * @brief What the analyzer knows about one register
+ */
+typedef struct
+{
+  bool isKnown;             /*!< value holds what the register contains   */
+  uint32_t value;
+  bool isReadSinceWrite;    /*!< Last access to the RCC since was a read   */
+} Trace_Reg_t;
+
+/**
+ * @brief Analysis state and results
+ */
+typedef struct
+{
+  Trace_Phase_t phase;
+  bool isLocked;
+  bool isUnlockArmed;
+  Trace_Reg_t regs[TRACE_NUM_REGS];
+  uint64_t phaseCycles[TRACE_PHASE_COUNT];
+  uint32_t phaseReads[TRACE_PHASE_COUNT];
+  uint32_t phaseWrites[TRACE_PHASE_COUNT];
+  uint32_t redundantReads;
+  uint32_t redundantWrites;
+  uint32_t latePolls;
+  uint32_t polls;
+  uint32_t pollStart;       /*!< First access of the poll in progress      */
+  uint32_t pollChange;      /*!< First access of it that saw a new value   */
+  uint32_t longestPollCycles;
+  uint32_t longestPollReads;
+} Trace_Analysis_t;
+
+static const char *RegName(uint32_t offset)
+{
+  switch (offset)
+  {
+    case RCC_CR_OFFSET:      return "RCC_CR";
+    case RCC_PLLCFGR_OFFSET: return "RCC_PLLCFGR";
+    case RCC_UNL_OFFSET:     return "RCC_UNL";
+    case RCC_UNH_OFFSET:     return "RCC_UNH";
+    case RCC_LOCK_OFFSET:    return "RCC_LOCK";
+    default:                 return "?";
+  }
+}
+
+/**
+ * @brief  Works out which phase a write starts, as RccSim does
+ */
+static Trace_Phase_t PhaseForWrite(const Trace_Analysis_t *analysis, const Trace_Access_t *access)
+{
+  if (access->offset == RCC_UNL_OFFSET)
+  {
+    return TRACE_PHASE_UNLOCK;
+  }
+  if (access->offset == RCC_LOCK_OFFSET)
+  {
+    return TRACE_PHASE_RELOCK;
+  }
+  if (access->offset == RCC_PLLCFGR_OFFSET)
+  {
+    return TRACE_PHASE_PLL_LOCK;
+  }
+  const Trace_Reg_t *cr = &analysis->regs[TRACE_REG_INDEX(RCC_CR_OFFSET)];
+  if ((access->offset != RCC_CR_OFFSET) || analysis->isLocked || !cr->isKnown)
+  {
+    return analysis->phase;
+  }
+
+  uint32_t rising = access->value & ~cr->value;
+  uint32_t falling = cr->value & ~access->value;
+  if ((rising & RCC_CR_DEF_CLOCK) != 0U)
+  {
+    return TRACE_PHASE_DEF_CLOCK;
+  }
+  if ((falling & RCC_CR_DEF_CLOCK) != 0U)
+  {
+    return TRACE_PHASE_CLKSEL_SWITCH;
+  }
+  if ((rising & (RCC_CR_HSION | RCC_CR_HSEON)) != 0U)
+  {
+    return TRACE_PHASE_OSC_READY;
+  }
+  if ((rising & RCC_CR_PLLON) != 0U)
+  {
+    return TRACE_PHASE_PLL_LOCK;
+  }
+  return analysis->phase;
+}
+
+/**
+ * @brief  Tracks RCC_UNL/RCC_UNH/RCC_LOCK like the hardware
+ */
+static void UpdateLock(Trace_Analysis_t *analysis, const Trace_Access_t *access)
+{
+  if (!access->isWrite)
+  {
+    if (access->offset == RCC_LOCK_OFFSET)
+    {
+      analysis->isLocked = ((access->value & RCC_LOCK_LOCK_STATUS) != 0U);
+    }
+    return;
+  }
+
+  if (access->offset == RCC_UNL_OFFSET)
+  {
+    analysis->isUnlockArmed = ((access->value & RCC_UNL_UNLOCK) == RCC_UNL_KEY);
+    return;
+  }
+  if (access->offset == RCC_UNH_OFFSET)
+  {
+    if (analysis->isUnlockArmed && ((access->value & RCC_UNH_UNLOCK) == RCC_UNH_KEY))
+    {
+      analysis->isLocked = false;
+    }
+    analysis->isUnlockArmed = false;
+    return;
+  }
+  analysis->isUnlockArmed = false;
+  if ((access->offset == RCC_LOCK_OFFSET) && ((access->value & RCC_LOCK_LOCK) != 0U))
+  {
+    analysis->isLocked = true;
+  }
+}
+
+/**
+ * @brief  Ends the poll in progress, if any, before access index end
+ */
+static void EndPoll(Trace_Analysis_t *analysis, const Trace_Access_t *accesses, uint32_t end, bool isListing)
+{
+  uint32_t reads = 0U;
+  uint32_t lateReads = 0U;
+  for (uint32_t i = analysis->pollStart; i < end; i++)
+  {
+    reads += accesses[i].count;
+    if ((analysis->pollChange != 0U) && (i >= analysis->pollChange))
+    {
+      lateReads += (i == analysis->pollChange) ? (accesses[i].count - 1U) : accesses[i].count;
+    }
+  }
+
+  if (reads >= 2U)
+  {
+    const Trace_Access_t *first = &accesses[analysis->pollStart];
+    uint32_t cycles = accesses[end - 1U].lastCycles - first->cycles;
+    analysis->polls++;
+    if (cycles > analysis->longestPollCycles)
+    {
+      analysis->longestPollCycles = cycles;
+      analysis->longestPollReads = reads;
+    }
+
+    if (lateReads != 0U)
+    {
+      const Trace_Access_t *change = &accesses[analysis->pollChange];
+      analysis->latePolls++;
+      printf("  #%u: late poll, %s read %u more times (%u cycles) after #%u saw 0x%08lx\n",
+             analysis->pollStart, RegName(first->offset), lateReads,
+             accesses[end - 1U].lastCycles - change->cycles, analysis->pollChange, (unsigned long)change->value);
+    }
+    else if (isListing)
+    {
+      printf("  #%u: poll of %s, %u reads over %u cycles\n", analysis->pollStart, RegName(first->offset),
+             reads, cycles);
+    }
+  }
+  analysis->pollStart = end;
+  analysis->pollChange = 0U;
+}
+
+static void Analyze(Trace_Analysis_t *analysis, const Trace_Access_t *accesses, uint32_t count, bool isListing)
+{
+  memset(analysis, 0, sizeof(*analysis));
+  analysis->isLocked = true;    // The RCC comes out of reset locked
+
+  for (uint32_t i = 0U; i < count; i++)
+  {
+    const Trace_Access_t *access = &accesses[i];
+    Trace_Reg_t *reg = &analysis->regs[TRACE_REG_INDEX(access->offset)];
+
+    // Polls: back-to-back reads of one register
+    bool isPollRead = !access->isWrite && (i > 0U) && !accesses[i - 1U].isWrite &&
+                      (accesses[i - 1U].offset == access->offset);
+    if (!isPollRead)
+    {
+      EndPoll(analysis, accesses, i, isListing);
+    }
+    else if (analysis->pollChange == 0U)
+    {
+      analysis->pollChange = i;   // The previous read returned something else
+    }
+
+    if (access->isWrite)
+    {
+      analysis->phase = PhaseForWrite(analysis, access);
+      bool isNoChange = reg->isKnown && (reg->value == access->value) &&
+                        ((access->offset == RCC_CR_OFFSET) || (access->offset == RCC_PLLCFGR_OFFSET));
+      bool isRelocked = (access->offset == RCC_LOCK_OFFSET) && analysis->isLocked;
+      if (isNoChange || isRelocked)
+      {
+        analysis->redundantWrites++;
+        printf("  #%u: redundant write of %s (0x%08lx), %s\n", i, RegName(access->offset),
+               (unsigned long)access->value, isRelocked ? "already locked" : "value unchanged");
+      }
+      for (uint32_t r = 0U; r < TRACE_NUM_REGS; r++)
+      {
+        analysis->regs[r].isReadSinceWrite = false;
+      }
+    }
+    else if ((access->offset == RCC_PLLCFGR_OFFSET) || (access->offset == RCC_LOCK_OFFSET))
+    {
+      // Only software changes these, so reading them again tells nothing new
+      uint32_t redundant = access->count - 1U;
+      if (reg->isReadSinceWrite && (reg->value == access->value))
+      {
+        redundant++;
+      }
+      if (redundant != 0U)
+      {
+        analysis->redundantReads += redundant;
+        printf("  #%u: %u redundant read%s of %s (0x%08lx), no write since the last read\n", i, redundant,
+               (redundant == 1U) ? "" : "s", RegName(access->offset), (unsigned long)access->value);
+      }
+    }
+    reg->isKnown = true;
+    reg->value = access->value;
+    reg->isReadSinceWrite = !access->isWrite;
+    UpdateLock(analysis, access);
+
+    // The time since the previous access ends with this one
+    if (i > 0U)
+    {
+      analysis->phaseCycles[analysis->phase] += access->lastCycles - accesses[i - 1U].lastCycles;
+    }
+    if (access->isWrite)
+    {
+      analysis->phaseWrites[analysis->phase]++;
+    }
+    else
+    {
+      analysis->phaseReads[analysis->phase] += access->count;
+    }
+
+    if (isListing)
+    {
+      printf("%5u %10lu %-5s %-11s 0x%08lx x%-5u %s\n", i, (unsigned long)access->cycles,
+             access->isWrite ? "write" : "read", RegName(access->offset), (unsigned long)access->value,
+             access->count, s_PhaseNames[analysis->phase]);
+    }
+
+    // Relocking is a single write, whatever follows is outside the bring-up
+    if (access->isWrite && (access->offset == RCC_LOCK_OFFSET))
+    {
+      analysis->phase = TRACE_PHASE_OTHER;
+    }
+  }
+  EndPoll(analysis, accesses, count, isListing);
+}
+
+/**
+ * @brief  Loads and checks a trace file, folding repeat records into the
+ *         read they repeat
+ * @retval Accesses (caller frees), NULL on error
+ */
+static Trace_Access_t *LoadTrace(const char *path, uint32_t *count, uint32_t *dropped)
+{
+  FILE *file = fopen(path, "rb");
+  if (file == NULL)
+  {
+    fprintf(stderr, "Cannot open %s\n", path);
+    return NULL;
+  }
+
+  uint8_t header[RCC_TRACE_HEADER_SIZE];
+  if ((fread(header, 1U, sizeof(header), file) != sizeof(header)) ||
+      (RccTrace_GetLe(&header[0], 4U) != RCC_TRACE_MAGIC) ||
+      (RccTrace_GetLe(&header[4], 2U) != RCC_TRACE_VERSION) ||
+      (RccTrace_GetLe(&header[6], 2U) != RCC_TRACE_RECORD_SIZE))
+  {
+    fprintf(stderr, "%s is not an RCC trace (version %u)\n", path, RCC_TRACE_VERSION);
+    (void)fclose(file);
+    return NULL;
+  }
+  uint32_t numRecords = RccTrace_GetLe(&header[8], 4U);
+  *dropped = RccTrace_GetLe(&header[12], 4U);
+  *count = 0U;
+
+  Trace_Access_t *accesses = calloc((numRecords != 0U) ? numRecords : 1U, sizeof(Trace_Access_t));
+  for (uint32_t i = 0U; (accesses != NULL) && (i < numRecords); i++)
+  {
+    uint8_t bytes[RCC_TRACE_RECORD_SIZE];
+    RccTrace_Record_t record;
+    bool isValid = (fread(bytes, 1U, sizeof(bytes), file) == sizeof(bytes));
+    if (isValid)
+    {
+      RccTrace_DecodeRecord(bytes, &record);
+      isValid = (record.offset <= RCC_LOCK_OFFSET) && ((record.offset % 2U) == 0U);
+    }
+    Trace_Access_t *last = (*count != 0U) ? &accesses[*count - 1U] : NULL;
+    if (isValid && ((record.flags & RCC_TRACE_FLAG_REPEAT) != 0U))
+    {
+      isValid = (last != NULL) && !last->isWrite && (last->offset == record.offset);
+      if (isValid)
+      {
+        last->count += record.value;
+        last->lastCycles = record.cycles;
+      }
+    }
+    else if (isValid)
+    {
+      Trace_Access_t *access = &accesses[(*count)++];
+      access->cycles = record.cycles;
+      access->lastCycles = record.cycles;
+      access->count = 1U;
+      access->value = record.value;
+      access->offset = record.offset;
+      access->isWrite = ((record.flags & RCC_TRACE_FLAG_WRITE) != 0U);
+    }
+
+    if (!isValid)
+    {
+      fprintf(stderr, "%s: record %u of %u is missing or malformed\n", path, i, numRecords);
+      free(accesses);
+      accesses = NULL;
+    }
+  }
+  (void)fclose(file);
+  return accesses;
+}
+
+int32_t main(int argc, char **argv)
+{
+  const char *path = NULL;
+  bool isListing = false;
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--list") == 0)
+    {
+      isListing = true;
+    }
+    else if ((path == NULL) && (argv[i][0] != '-'))
+    {
+      path = argv[i];
+    }
+    else
+    {
+      path = NULL;
+      break;
+    }
+  }
+  if (path == NULL)
+  {
+    fprintf(stderr, "Usage: %s <trace file> [--list]\n", argv[0]);
+    return 2;
+  }
+
+  uint32_t count = 0U;
+  uint32_t dropped = 0U;
+  Trace_Access_t *accesses = LoadTrace(path, &count, &dropped);
+  if (accesses == NULL)
+  {
+    return 2;
+  }
+
+  // Repeated reads of one register are folded into one entry
+  uint64_t busAccesses = 0U;
+  for (uint32_t i = 0U; i < count; i++)
+  {
+    busAccesses += accesses[i].count;
+  }
+  uint32_t totalCycles = (count != 0U) ? (accesses[count - 1U].lastCycles - accesses[0].cycles) : 0U;
+  printf("Trace %s: %llu accesses in %u entries, %u dropped, %u cycles\n", path,
+         (unsigned long long)busAccesses, count, dropped, totalCycles);
+  Trace_Analysis_t analysis;
+  Analyze(&analysis, accesses, count, isListing);
+
+  printf("phase,cycles,reads,writes\n");
+  for (uint32_t phase = 0U; phase < (uint32_t)TRACE_PHASE_COUNT; phase++)
+  {
+    printf("%s,%llu,%u,%u\n", s_PhaseNames[phase], (unsigned long long)analysis.phaseCycles[phase],
+           analysis.phaseReads[phase], analysis.phaseWrites[phase]);
+  }
+  printf("%u polls, longest %u reads over %u cycles\n", analysis.polls, analysis.longestPollReads,
+         analysis.longestPollCycles);
+  printf("%u redundant reads, %u redundant writes, %u late polls\n", analysis.redundantReads,
+         analysis.redundantWrites, analysis.latePolls);
+
+  free(accesses);
+  return 0;
+}
@@ -0,0 +1,691 @@
+/**
+ * @file    unit_main.c
+ * @brief   Asserting checks of the clock modules against the simulated RCC
+ * @author  SMC
+ * @date    September 2025
+ *
+ * test_main.c walks through the features and prints what they do; this
+ * program checks the results. Every check that fails is printed with its
+ * line, and the exit code is non-zero if any did.
+ *
+ * Checked:
+ *   - rcc_txn.c: reserved offsets and the key registers are not staged, so
+ *     a transaction never holds a write that its commit would drop
+ *   - cycle_counter.c: a host cycle source set with CycleCounter_SetSource()
+ *     times the waits, across the 32-bit wrap, until it is taken out again
+ *   - clock_gate.c: per-bus masks, and the number of reads and stores of
+ *     each gating call
+ *   - power_profile.c: profiles on one PLL setting switch with a single
+ *     RCC_CR store between the keys and the lock, others through DEF_CLOCK
+ *   - clock_governor.c: one level per window above the up or below the down
+ *     threshold, none in between, and no level claimed when the first
+ *     switch is turned away or fails
+ *   - clock_health.c: a switch that failed is not counted as a silent fault
+ *     and auto-restore goes back to the last good configuration, while a
+ *     real fallback is still counted
+ *   - clock_restart.c: a damaged, illegal or invalidated record is rejected,
+ *     the reset cause follows the RCC_CSR flag priority, and power-on or a
+ *     damaged record take the cold path
+ *   - clock_fast_start.c: an HSERDY timeout that comes while a switch of the
+ *     same owner runs leaves HSEON alone until that switch has ended
+ *   - usart_baud.c: BRR, error and bus divider picked for known clocks, BRR
+ *     rewritten before the other drivers hear of a clock change, the divider
+ *     changed on the last good configuration after a failed switch, and the
+ *     ports kept when the divider switch fails
+ *   - clock_notify.c: a post-change callback that registers or unregisters
+ *     is turned away, and every entry of the walk runs exactly once
+ *   - startup.c: RCC_IRQHandler() firing inside the register accesses of a
+ *     poll leaves the step to the poll, and the switch ends exactly once
+ *
+ * Usage: unit.out
+ *
+ * Build with MOCK_REGISTERS = 1, e.g.
+ *   clang -DMOCK_REGISTERS=1 startup.c clock_solver.c clock_notify.c clock_profile.c clock_fast_start.c clock_gate.c clock_governor.c clock_health.c clock_restart.c cycle_counter.c power_profile.c rcc_owner.c rcc_txn.c rcc_trace.c rcc_sim.c usart_baud.c unit_main.c -o unit.out -lpthread
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "rcc_access.h"
+#include "rcc_txn.h"
+#include "rcc_owner.h"
+#include "cycle_counter.h"
+#include "startup.h"
+#include "clock_notify.h"
+#include "clock_gate.h"
+#include "power_profile.h"
+#include "usart_baud.h"
+#include "clock_health.h"
+#include "clock_governor.h"
+#include "clock_restart.h"
+#include "clock_fast_start.h"
+
+#define CHECK(condition)                 Check((condition), #condition, __LINE__)
+
+static uint32_t s_Checks;
+static uint32_t s_Failures;
+
+static void Check(bool isPassed, const char *condition, int32_t line)
+{
+  s_Checks++;
+  if (!isPassed)
+  {
+    s_Failures++;
+    printf("FAIL line %d: %s\n", line, condition);
+  }
+}
+
+/**
+ * @brief  Simulated RCC out of reset with zeroed access counters
+ */
+static void ResetRcc(void)
+{
+  RccSim_Init(NULL);
+  SystemClockUpdate();
+  RccSim_ResetAccessCounts();
+}
+
+static void TestRccTxn(void)
+{
+  static const uint32_t unstaged[] =
+  {
+    0x18UL, 0x1CUL, 0x28UL, 0x2CUL, 0x38UL, 0x48UL, 0x58UL, 0x68UL,
+    RCC_UNL_OFFSET, RCC_UNH_OFFSET, RCC_LOCK_OFFSET, RCC_CSR_OFFSET + 4UL, 0x41UL
+  };
+  ResetRcc();
+  Rcc_Txn_t txn;
+  RccTxn_Begin(&txn);
+  for (uint32_t i = 0U; i < (sizeof(unstaged) / sizeof(unstaged[0])); i++)
+  {
+    RccTxn_Write(&txn, unstaged[i], 0xFFFFFFFFUL);
+    RccTxn_Modify(&txn, unstaged[i], 0U, 1U);
+    CHECK(RccTxn_Read(&txn, unstaged[i]) == 0U);
+  }
+  CHECK((txn.loadedMask == 0U) && (txn.dirtyMask == 0U) && (txn.reads == 0U));
+
+  RccTxn_Unlock(&txn);
+  RccTxn_Write(&txn, RCC_APB1ENR_OFFSET, 0x5UL);
+  RccTxn_Lock(&txn);
+  RccTxn_Commit(&txn);
+  CHECK(txn.dirtyMask == 0U);
+  CHECK(RccSim_Peek(RCC_APB1ENR_OFFSET) == 0x5UL);
+  CHECK(RccSim_Peek(RCC_LOCK_OFFSET) == RCC_LOCK_LOCK_STATUS);
+}
+
+static uint32_t s_HostCycles;
+
+static uint32_t HostCycles(void)
+{
+  return s_HostCycles;
+}
+
+static void TestCycleCounter(void)
+{
+  ResetRcc();
+  s_HostCycles = 0xFFFFFF00UL;
+  CycleCounter_SetSource(HostCycles);
+  CHECK(CycleCounter_Now() == 0xFFFFFF00UL);
+  CHECK(CycleCounter_NowAt(RCC_BASE) == 0xFFFFFF00UL);
+
+  // HSEON is off, so HSERDY never comes; only the host cycles end the wait
+  Cycle_Wait_t wait;
+  CycleWait_Start(&wait, RCC_CR_OFFSET, RCC_CR_HSERDY, RCC_CR_HSERDY, CycleCounter_Now(), 1000U);
+  s_HostCycles += 999U;
+  CHECK(CycleWait_Poll(&wait, NULL) == CYCLE_WAIT_PENDING);
+  s_HostCycles++;
+  CHECK(CycleWait_Poll(&wait, NULL) == CYCLE_WAIT_TIMEOUT);
+  CHECK(wait.elapsedCycles == 1000U);
+
+  CycleCounter_SetSource(NULL);
+  CHECK(CycleCounter_Now() == (uint32_t)RccSim_GetCycles());
+}
+
+static void TestClockGate(void)
+{
+  uint32_t masks[CLOCK_BUS_COUNT];
+  Clock_Peripheral_Set_t set = CLOCK_PERIPH_SET(CLOCK_PERIPH_GPIOA) | CLOCK_PERIPH_SET(CLOCK_PERIPH_DMA2) |
+                               CLOCK_PERIPH_SET(CLOCK_PERIPH_RNG) | CLOCK_PERIPH_SET(CLOCK_PERIPH_USART2) |
+                               CLOCK_PERIPH_SET(CLOCK_PERIPH_USART1) | CLOCK_PERIPH_SET(CLOCK_PERIPH_TIM11);
+  CHECK(ClockGate_GetMasks(set, masks) == CLOCK_OK);
+  CHECK(masks[CLOCK_BUS_AHB1] == ((1UL << 0) | (1UL << 22)));
+  CHECK(masks[CLOCK_BUS_AHB2] == (1UL << 6));
+  CHECK(masks[CLOCK_BUS_APB1] == (1UL << 17));
+  CHECK(masks[CLOCK_BUS_APB2] == ((1UL << 4) | (1UL << 18)));
+  CHECK(ClockGate_GetMasks(CLOCK_PERIPH_SET(CLOCK_PERIPH_COUNT), masks) == CLOCK_ERROR_INVALID_ARG);
+  CHECK(ClockGate_GetMasks(set, NULL) == CLOCK_ERROR_INVALID_ARG);
+
+  // Enable: per bus touched one read and one store, plus the keys and the lock
+  ResetRcc();
+  CHECK(ClockGate_Enable(CLOCK_PERIPH_SET(CLOCK_PERIPH_USART1) | CLOCK_PERIPH_SET(CLOCK_PERIPH_TIM11)) == CLOCK_OK);
+  CHECK(RccSim_GetReadCount() == 1U);
+  CHECK(RccSim_GetWriteCount() == 4U);
+  CHECK(RccSim_Peek(RCC_APB2ENR_OFFSET) == ((1UL << 4) | (1UL << 18)));
+  CHECK(RccSim_Peek(RCC_LOCK_OFFSET) == RCC_LOCK_LOCK_STATUS);
+
+  // Disable leaves the other peripherals of the bus clocked
+  RccSim_ResetAccessCounts();
+  CHECK(ClockGate_Disable(CLOCK_PERIPH_SET(CLOCK_PERIPH_USART1)) == CLOCK_OK);
+  CHECK(RccSim_Peek(RCC_APB2ENR_OFFSET) == (1UL << 18));
+  CHECK(RccSim_GetWriteCount() == 4U);
+
+  // SetEnabled: one store per bus and no reads
+  RccSim_ResetAccessCounts();
+  CHECK(ClockGate_SetEnabled(set) == CLOCK_OK);
+  CHECK(RccSim_GetReadCount() == 0U);
+  CHECK(RccSim_GetWriteCount() == (2U + (uint32_t)CLOCK_BUS_COUNT + 1U));
+  CHECK(ClockGate_GetEnabled() == set);
+
+  // Reset pulses the bits and leaves the enables alone
+  CHECK(ClockGate_Reset(CLOCK_PERIPH_SET(CLOCK_PERIPH_USART2)) == CLOCK_OK);
+  CHECK(RccSim_Peek(RCC_APB1RSTR_OFFSET) == 0U);
+  CHECK(ClockGate_GetEnabled() == set);
+  CHECK(ClockGate_Enable(CLOCK_PERIPH_SET(CLOCK_PERIPH_COUNT)) == CLOCK_ERROR_INVALID_ARG);
+}
+
+static void TestPowerProfile(void)
+{
+  Clock_Config_t burst;
+  Clock_Config_t run;
+  Clock_Config_t idle;
+  ResetRcc();
+  CHECK(PowerProfile_Init(g_PowerProfileDefaults, POWER_PROFILE_DEFAULT_COUNT) == CLOCK_OK);
+  CHECK(PowerProfile_GetActive() == POWER_PROFILE_NONE);
+  CHECK(PowerProfile_GetConfig(POWER_PROFILE_BURST, &burst) == CLOCK_OK);
+  CHECK(PowerProfile_GetConfig(POWER_PROFILE_RUN, &run) == CLOCK_OK);
+  CHECK(PowerProfile_GetConfig(POWER_PROFILE_IDLE, &idle) == CLOCK_OK);
+  CHECK(run.pllcfgr == burst.pllcfgr);
+  CHECK(GetClockConfigSysClockHz(&run) == 40000000UL);
+  CHECK(GetClockConfigBusClockHz(&run) == 20000000UL);
+  CHECK(PowerProfile_GetConfig(POWER_PROFILE_DEFAULT_COUNT, &run) == CLOCK_ERROR_INVALID_ARG);
+
+  CHECK(PowerProfile_Apply(POWER_PROFILE_BURST) == CLOCK_OK);
+  CHECK(PowerProfile_GetActive() == POWER_PROFILE_BURST);
+  CHECK(GetSystemClockHz() == 80000000UL);
+
+  // Burst <-> run: the keys, one RCC_CR store and the lock; no DEF_CLOCK trip
+  static const uint32_t dividerOnly[] = { POWER_PROFILE_RUN, POWER_PROFILE_BURST };
+  for (uint32_t i = 0U; i < (sizeof(dividerOnly) / sizeof(dividerOnly[0])); i++)
+  {
+    RccSim_ResetAccessCounts();
+    RccSim_ResetPhaseCycles();
+    CHECK(PowerProfile_Apply(dividerOnly[i]) == CLOCK_OK);
+    CHECK(RccSim_GetWriteCount() == 4U);
+    CHECK(RccSim_GetPhaseCycles(RCC_SIM_PHASE_DEF_CLOCK) == 0U);
+    CHECK(RccSim_Peek(RCC_PLLCFGR_OFFSET) == burst.pllcfgr);
+    CHECK(PowerProfile_GetActive() == dividerOnly[i]);
+  }
+  CHECK(GetSystemClockHz() == 80000000UL);
+
+  // Idle needs another PLL setting and goes through DEF_CLOCK; its sleep
+  // mask only keeps the wake-up peripherals
+  RccSim_ResetPhaseCycles();
+  CHECK(PowerProfile_Apply(POWER_PROFILE_IDLE) == CLOCK_OK);
+  CHECK(RccSim_GetPhaseCycles(RCC_SIM_PHASE_DEF_CLOCK) != 0U);
+  CHECK(RccSim_Peek(RCC_PLLCFGR_OFFSET) == idle.pllcfgr);
+  CHECK(GetSystemClockHz() == 1250000UL);
+  CHECK(RccSim_Peek(RCC_APB1LPENR_OFFSET) == (1UL << 0));
+
+  // Applying the active profile again writes nothing
+  RccSim_ResetAccessCounts();
+  CHECK(PowerProfile_Apply(POWER_PROFILE_IDLE) == CLOCK_OK);
+  CHECK(RccSim_GetWriteCount() == 0U);
+}
+
+#define GOVERNOR_WINDOW_CYCLES           20000U
+
+/**
+ * @brief  Updates the governor until its level switch ends
+ * @note   The governor starts its next window when the switch ends, so the
+ *         windows stay aligned with RunGovernorWindow().
+ */
+static int32_t FinishGovernorSwitch(int32_t status)
+{
+  while (status == CLOCK_IN_PROGRESS)
+  {
+    RccSim_Advance(100U);
+    status = ClockGovernor_Update();
+  }
+  return status;
+}
+
+/**
+ * @brief  One governor window at a given load, then the level switch it started
+ * @retval Status of the last ClockGovernor_Update()
+ */
+static int32_t RunGovernorWindow(uint32_t busyPercent)
+{
+  uint32_t busyCycles = (GOVERNOR_WINDOW_CYCLES * busyPercent) / 100U;
+  int32_t status = CLOCK_OK;
+  for (uint32_t slice = 0U; slice < 20U; slice++)
+  {
+    RccSim_Advance(busyCycles / 20U);
+    ClockGovernor_IdleEnter();
+    RccSim_Advance((GOVERNOR_WINDOW_CYCLES - busyCycles) / 20U);
+    ClockGovernor_IdleExit();
+    status = ClockGovernor_Update();
+  }
+  return FinishGovernorSwitch(status);
+}
+
+static void TestClockGovernor(void)
+{
+  Clock_Governor_Config_t config =
+  {
+    .maxSysClockSpeed = SYS_CLOCK_SPEED_80M, .minSysClockSpeed = SYS_CLOCK_SPEED_1_25M, .isHsiClock = true,
+    .windowCycles = GOVERNOR_WINDOW_CYCLES, .upPercent = 80U, .downPercent = 30U
+  };
+
+  // Another context holds the RCC: no level is claimed
+  ResetRcc();
+  CHECK(RccOwner_TryAcquire(0x1234U));
+  CHECK(ClockGovernor_Init(&config) == CLOCK_ERROR_BUSY);
+  CHECK(ClockGovernor_GetSysClockSpeed() == SYS_CLOCK_SPEED_UNDEFINED);
+  CHECK(ClockGovernor_Update() == CLOCK_ERROR_NOT_STARTED);
+  CHECK(RccOwner_Release(0x1234U));
+
+  CHECK(ClockGovernor_Init(&config) == CLOCK_IN_PROGRESS);
+  CHECK(ClockGovernor_GetSysClockSpeed() == SYS_CLOCK_SPEED_UNDEFINED);
+  CHECK(FinishGovernorSwitch(CLOCK_IN_PROGRESS) == CLOCK_OK);
+  CHECK(ClockGovernor_GetSysClockSpeed() == SYS_CLOCK_SPEED_80M);
+
+  // Between the thresholds nothing moves; outside them one level per window
+  static const struct
+  {
+    uint32_t busyPercent;
+    System_Clock_Speeds_t speed;
+  } steps[] =
+  {
+    { 50U, SYS_CLOCK_SPEED_80M }, { 95U, SYS_CLOCK_SPEED_80M }, { 10U, SYS_CLOCK_SPEED_40M },
+    { 10U, SYS_CLOCK_SPEED_20M }, { 50U, SYS_CLOCK_SPEED_20M }, { 75U, SYS_CLOCK_SPEED_20M },
+    { 95U, SYS_CLOCK_SPEED_40M }, { 35U, SYS_CLOCK_SPEED_40M }, { 95U, SYS_CLOCK_SPEED_80M },
+  };
+  for (uint32_t i = 0U; i < (sizeof(steps) / sizeof(steps[0])); i++)
+  {
+    CHECK(RunGovernorWindow(steps[i].busyPercent) == CLOCK_OK);
+    CHECK(ClockGovernor_GetSysClockSpeed() == steps[i].speed);
+  }
+  CHECK(GetSystemClockHz() == 80000000UL);
+
+  // The first switch fails on a dead crystal: still no level
+  RccSim_Timing_t timing;
+  RccSim_GetDefaultTiming(&timing);
+  timing.hseReadyCycles = RCC_SIM_NEVER;
+  RccSim_Init(&timing);
+  SystemClockUpdate();
+  config.isHsiClock = false;
+  CHECK(ClockGovernor_Init(&config) == CLOCK_IN_PROGRESS);
+  CHECK(FinishGovernorSwitch(CLOCK_IN_PROGRESS) == CLOCK_ERROR_OSC_TIMEOUT);
+  CHECK(ClockGovernor_GetSysClockSpeed() == SYS_CLOCK_SPEED_UNDEFINED);
+  CHECK(ClockGovernor_Update() == CLOCK_ERROR_NOT_STARTED);
+}
+
+/**
+ * @brief  Runs health checks 100 cycles apart until the RCC is healthy
+ */
+static Clock_Health_t CheckUntilHealthy(void)
+{
+  Clock_Health_t health = ClockHealth_Check();
+  for (uint32_t i = 0U; (i < 100U) && (health != CLOCK_HEALTH_OK); i++)
+  {
+    RccSim_Advance(100U);
+    health = ClockHealth_Check();
+  }
+  return health;
+}
+
+static void TestClockHealth(void)
+{
+  RccSim_Timing_t timing;
+  RccSim_GetDefaultTiming(&timing);
+  timing.hseReadyCycles = RCC_SIM_NEVER;
+  RccSim_Init(&timing);
+  SystemClockUpdate();
+  ClockHealth_Init(true);
+  CHECK(SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_40M, 2U, true) == CLOCK_OK);
+  CHECK(ClockHealth_Check() == CLOCK_HEALTH_OK);
+
+  // The crystal is dead: the switch fails and says so itself
+  CHECK(SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_40M, 2U, false) == CLOCK_ERROR_OSC_TIMEOUT);
+  CHECK(ClockHealth_Check() != CLOCK_HEALTH_OK);
+  CHECK(CheckUntilHealthy() == CLOCK_HEALTH_OK);
+  Clock_Health_Stats_t stats;
+  ClockHealth_GetStats(&stats);
+  CHECK(stats.faults == 0U);
+  CHECK(stats.restores == 1U);
+  CHECK(stats.restoreFailures == 0U);
+  CHECK((RccSim_Peek(RCC_CR_OFFSET) & RCC_CR_CLKSEL) == RCC_CR_CLKSEL_0);
+  CHECK(GetSystemClockHz() == 40000000UL);
+
+  // A silent fallback from the good configuration is still a fault
+  RccSim_InjectFault(RCC_SIM_FAULT_FALLBACK, RccSim_GetCycles() + 50U);
+  RccSim_Advance(100U);
+  CHECK(ClockHealth_Check() == CLOCK_HEALTH_DEF_CLOCK);
+  CHECK(CheckUntilHealthy() == CLOCK_HEALTH_OK);
+  ClockHealth_GetStats(&stats);
+  CHECK(stats.faults == 1U);
+  CHECK(stats.fallbacks == 1U);
+  CHECK(stats.restores == 2U);
+  ClockHealth_Init(false);
+}
+
+static void TestClockRestart(void)
+{
+  Clock_Config_t good;
+  Clock_Config_t loaded;
+  CHECK(BuildClockConfig(SYS_CLOCK_SPEED_40M, 2U, true, &good) == CLOCK_OK);
+
+  // Load() takes back what Save() wrote, and nothing else
+  ClockRestart_Save(&good);
+  CHECK(ClockRestart_Load(&loaded));
+  CHECK((loaded.pllcfgr == good.pllcfgr) && (loaded.crDividers == good.crDividers) && loaded.isHsiClock);
+  CHECK(!ClockRestart_Load(NULL));
+  static const struct
+  {
+    uint32_t word;
+    uint32_t flipMask;
+  } damage[] =
+  {
+    { 0U, 1UL << 7 },                   // Magic
+    { 1U, RCC_CR_SYS_DIV_0 },           // A legal RCC_CR image, but not the one summed
+    { 1U, RCC_CR_HSEON },               // Both oscillators
+    { 2U, RCC_PLLCFGR_MUL },            // RCC_PLLCFGR image
+    { 3U, 1UL << 31 },                  // Checksum
+  };
+  for (uint32_t i = 0U; i < (sizeof(damage) / sizeof(damage[0])); i++)
+  {
+    ClockRestart_Save(&good);
+    ClockRestart_CorruptRecord(damage[i].word, damage[i].flipMask);
+    CHECK(!ClockRestart_Load(&loaded));
+  }
+  Clock_Config_t tooFast;
+  CHECK(BuildClockConfig(SYS_CLOCK_SPEED_80M, 4U, true, &tooFast) == CLOCK_OK);
+  tooFast.crDividers &= ~RCC_CR_BUS_DIV;   // 80MHz bus, intact checksum
+  ClockRestart_Save(&tooFast);
+  CHECK(!ClockRestart_Load(&loaded));
+  ClockRestart_Save(&good);
+  ClockRestart_Invalidate();
+  CHECK(!ClockRestart_Load(&loaded));
+
+  // Reset cause priority: power-on and brown-out over everything, then the
+  // watchdogs, software and low-power; the pin flag only on its own
+  static const struct
+  {
+    uint32_t resetFlags;
+    Clock_Reset_Cause_t cause;
+  } causes[] =
+  {
+    { RCC_CSR_PORRSTF | RCC_CSR_IWDGRSTF | RCC_CSR_PINRSTF,  CLOCK_RESET_POWER_ON },
+    { RCC_CSR_BORRSTF | RCC_CSR_WWDGRSTF,                    CLOCK_RESET_POWER_ON },
+    { RCC_CSR_WWDGRSTF | RCC_CSR_IWDGRSTF | RCC_CSR_PINRSTF, CLOCK_RESET_WWDG },
+    { RCC_CSR_IWDGRSTF | RCC_CSR_SFTRSTF | RCC_CSR_PINRSTF,  CLOCK_RESET_IWDG },
+    { RCC_CSR_SFTRSTF | RCC_CSR_LPWRRSTF | RCC_CSR_PINRSTF,  CLOCK_RESET_SOFTWARE },
+    { RCC_CSR_LPWRRSTF | RCC_CSR_PINRSTF,                    CLOCK_RESET_LOW_POWER },
+    { RCC_CSR_PINRSTF,                                       CLOCK_RESET_PIN },
+    { 0U,                                                    CLOCK_RESET_POWER_ON },
+  };
+  Clock_Config_t cold;
+  CHECK(BuildClockConfig(SYS_CLOCK_SPEED_20M, 0U, true, &cold) == CLOCK_OK);
+  for (uint32_t i = 0U; i < (sizeof(causes) / sizeof(causes[0])); i++)
+  {
+    ClockRestart_Save(&good);
+    RccSim_Reset(causes[i].resetFlags);
+    SystemClockUpdate();
+    bool isWarmStart = true;
+    CHECK(ClockRestart_Boot(&cold, 0U, &isWarmStart) == CLOCK_OK);
+    CHECK(ClockRestart_GetResetCause() == causes[i].cause);
+    CHECK(isWarmStart == (causes[i].cause != CLOCK_RESET_POWER_ON));
+    CHECK(GetSystemClockHz() == (isWarmStart ? 40000000UL : 20000000UL));
+    CHECK((RccSim_Peek(RCC_CSR_OFFSET) & RCC_CSR_RESET_FLAGS) == 0U);
+  }
+
+  // A watchdog reset with a damaged record is cold, and records the cold
+  // configuration for the next time
+  ClockRestart_Save(&good);
+  ClockRestart_CorruptRecord(3U, 1UL);
+  RccSim_Reset(RCC_CSR_IWDGRSTF | RCC_CSR_PINRSTF);
+  SystemClockUpdate();
+  bool isWarmStart = true;
+  CHECK(ClockRestart_Boot(&cold, 0U, &isWarmStart) == CLOCK_OK);
+  CHECK(!isWarmStart);
+  CHECK(GetSystemClockHz() == 20000000UL);
+  CHECK(ClockRestart_Load(&loaded) && (loaded.pllcfgr == cold.pllcfgr));
+}
+
+static USART_TypeDef s_Usart1;
+static USART_TypeDef s_Usart2;
+static uint32_t s_BrrSeenAfterChange;
+
+static void ReadBrrAfterChange(const Clock_Notify_Info_t *info, void *context)
+{
+  (void)info;
+  (void)context;
+  s_BrrSeenAfterChange = s_Usart1.BRR;
+}
+
+static void TestClockFastStart(void)
+{
+  Clock_Config_t config;
+  RccSim_Timing_t timing;
+  RccSim_GetDefaultTiming(&timing);
+  timing.hseReadyCycles = RCC_SIM_NEVER;
+  RccSim_Init(&timing);
+  SystemClockUpdate();
+  CHECK(BuildClockConfig(SYS_CLOCK_SPEED_40M, 2U, false, &config) == CLOCK_OK);
+  CHECK(ClockFastStart_Begin(&config) == CLOCK_OK);
+  CHECK((RccSim_Peek(RCC_CR_OFFSET) & RCC_CR_HSEON) != 0U);
+
+  // HSERDY times out while the same thread has a switch between two polls
+  RccSim_Advance(10000U);
+  CHECK(StartClockSwitch(SYS_CLOCK_SPEED_20M, 0U, true, NULL, NULL) == CLOCK_OK);
+  CHECK(IsClockSwitchInProgress());
+  CHECK(ClockFastStart_Poll() == CLOCK_MIGRATION_WAIT_HSE);
+  CHECK((RccSim_Peek(RCC_CR_OFFSET) & RCC_CR_HSEON) != 0U);
+  int32_t status = CLOCK_IN_PROGRESS;
+  while (status == CLOCK_IN_PROGRESS)
+  {
+    status = PollClockSwitch();
+  }
+  CHECK(status == CLOCK_OK);
+
+  // Turned off on the first poll after the switch
+  CHECK(ClockFastStart_Poll() == CLOCK_MIGRATION_FAILED);
+  CHECK(ClockFastStart_GetStatus() == CLOCK_ERROR_OSC_TIMEOUT);
+  CHECK((RccSim_Peek(RCC_CR_OFFSET) & RCC_CR_HSEON) == 0U);
+  CHECK(RccSim_Peek(RCC_LOCK_OFFSET) == RCC_LOCK_LOCK_STATUS);
+  CHECK(GetSystemClockHz() == 20000000UL);
+  CHECK(RccOwner_GetOwner() == RCC_OWNER_NONE);
+}
+
+static void TestUsartBaud(void)
+{
+  const Usart_Baud_Port_t ports[] = { { &s_Usart1, 115200U }, { &s_Usart2, 460800U } };
+  Usart_Baud_Plan_t plan;
+
+  // 40MHz: the bus is limited to 20MHz, so /2
+  CHECK(UsartBaud_Plan(40000000UL, ports, 2U, &plan) == CLOCK_OK);
+  CHECK(plan.busClockDivider == 2U);
+  CHECK(plan.busClockHz == 20000000UL);
+  CHECK(plan.brr[0] == 0x00AEU);
+  CHECK(plan.brr[1] == 0x002BU);
+  CHECK(plan.errorPpm[0] == 2235U);
+  CHECK(plan.errorPpm[1] == 9367U);
+  CHECK(plan.worstErrorPpm == 9367U);
+
+  // 10MHz: no division needed, fastest bus wins
+  CHECK(UsartBaud_Plan(10000000UL, ports, 2U, &plan) == CLOCK_OK);
+  CHECK(plan.busClockDivider == 1U);
+  CHECK(plan.brr[0] == 0x0057U);
+  CHECK(plan.brr[1] == 0x0016U);
+
+  CHECK(UsartBaud_Plan(1250000UL, &ports[1], 1U, &plan) == CLOCK_ERROR_UNREACHABLE);
+  CHECK(UsartBaud_Plan(40000000UL, ports, 0U, &plan) == CLOCK_ERROR_INVALID_ARG);
+  CHECK(UsartBaud_GetBrr(20000000UL, 0U) == 0U);
+
+  // BRR is already rewritten when a post-change notifier of any other
+  // priority runs
+  ResetRcc();
+  CHECK(SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_40M, 2U, true) == CLOCK_OK);
+  CHECK(UsartBaud_Apply(ports, 2U, &plan) == CLOCK_OK);
+  CHECK(s_Usart1.BRR == 0x00AEU);
+  int32_t handle = ClockNotify_Register(NULL, ReadBrrAfterChange, 254U, NULL);
+  CHECK(handle >= 0);
+  CHECK(SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_10M, 0U, true) == CLOCK_OK);
+  CHECK(s_BrrSeenAfterChange == 0x0057U);
+  CHECK(ClockNotify_Unregister(handle) == CLOCK_OK);
+
+  // After a switch to a dead crystal the divider goes on the HSI setting
+  RccSim_Timing_t timing;
+  RccSim_GetDefaultTiming(&timing);
+  timing.hseReadyCycles = RCC_SIM_NEVER;
+  RccSim_Init(&timing);
+  SystemClockUpdate();
+  CHECK(SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_40M, 4U, true) == CLOCK_OK);
+  CHECK(SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_40M, 4U, false) == CLOCK_ERROR_OSC_TIMEOUT);
+  CHECK(UsartBaud_Apply(ports, 1U, &plan) == CLOCK_OK);
+  CHECK(plan.busClockDivider == 2U);
+  CHECK((RccSim_Peek(RCC_CR_OFFSET) & RCC_CR_CLKSEL) == RCC_CR_CLKSEL_0);
+  CHECK(GetBusClockHz() == 20000000UL);
+  CHECK(s_Usart1.BRR == 0x00AEU);
+
+  // 300 baud needs /4 at 40MHz; turned away, USART2 is not taken on
+  const Usart_Baud_Port_t slowPort = { &s_Usart2, 300U };
+  uint32_t otherOwner = RccOwner_GetContextId() + 1U;
+  s_Usart2.BRR = 0U;
+  CHECK(RccOwner_TryAcquire(otherOwner));
+  CHECK(UsartBaud_Apply(&slowPort, 1U, &plan) == CLOCK_ERROR_BUSY);
+  CHECK(plan.busClockDivider == 4U);
+  CHECK(RccOwner_Release(otherOwner));
+  CHECK(SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_40M, 4U, true) == CLOCK_OK);
+  CHECK(s_Usart1.BRR == 0x0057U);
+  CHECK(s_Usart2.BRR == 0U);
+}
+
+static uint32_t s_IrqCount;
+static uint32_t s_PreChangeCount;
+static uint32_t s_PostChangeCount;
+static uint32_t s_SwitchDoneCount;
+static int32_t s_SwitchDoneStatus;
+
+static void FireIrq(void *context)
+{
+  (void)context;
+  s_IrqCount++;
+  RCC_IRQHandler();
+}
+
+static void CountPreChange(const Clock_Notify_Info_t *info, void *context)
+{
+  (void)info;
+  (void)context;
+  s_PreChangeCount++;
+}
+
+static void CountPostChange(const Clock_Notify_Info_t *info, void *context)
+{
+  (void)info;
+  (void)context;
+  s_PostChangeCount++;
+}
+
+static void CountSwitchDone(int32_t status, void *context)
+{
+  (void)context;
+  s_SwitchDoneCount++;
+  s_SwitchDoneStatus = status;
+}
+
+static void TestIrqPreemption(void)
+{
+  ResetRcc();
+  int32_t handle = ClockNotify_Register(CountPreChange, CountPostChange, 128U, NULL);
+  CHECK(handle >= 0);
+
+  // The interrupt fires after every register access of the polls
+  RccSim_SetAccessHook(FireIrq, NULL);
+  CHECK(StartClockSwitch(SYS_CLOCK_SPEED_40M, 2U, true, CountSwitchDone, NULL) == CLOCK_OK);
+  int32_t status = CLOCK_IN_PROGRESS;
+  while (status == CLOCK_IN_PROGRESS)
+  {
+    status = PollClockSwitch();
+  }
+  RccSim_SetAccessHook(NULL, NULL);
+
+  CHECK(s_IrqCount != 0U);
+  CHECK(status == CLOCK_OK);
+  CHECK(s_SwitchDoneCount == 1U);
+  CHECK(s_SwitchDoneStatus == CLOCK_OK);
+  CHECK(s_PreChangeCount == 1U);
+  CHECK(s_PostChangeCount == 1U);
+  CHECK(RccOwner_GetOwner() == RCC_OWNER_NONE);
+  CHECK((RccSim_Peek(RCC_CR_OFFSET) & (RCC_CR_DEF_CLOCK | RCC_CR_CLKSEL)) == RCC_CR_CLKSEL_0);   // HSI
+  CHECK(RccSim_Peek(RCC_LOCK_OFFSET) == RCC_LOCK_LOCK_STATUS);
+  CHECK(GetSystemClockHz() == 40000000UL);
+
+  // Between polls the interrupt does advance the switch
+  CHECK(StartClockSwitch(SYS_CLOCK_SPEED_20M, 0U, true, CountSwitchDone, NULL) == CLOCK_OK);
+  while (IsClockSwitchInProgress())
+  {
+    RCC_IRQHandler();
+  }
+  CHECK(PollClockSwitch() == CLOCK_OK);
+  CHECK(s_SwitchDoneCount == 2U);
+  CHECK(s_PostChangeCount == 2U);
+  CHECK(GetSystemClockHz() == 20000000UL);
+  CHECK(RccOwner_GetOwner() == RCC_OWNER_NONE);
+  CHECK(ClockNotify_Unregister(handle) == CLOCK_OK);
+}
+
+static int32_t s_CountHandle;
+static uint32_t s_ChangeCallCount;
+static int32_t s_RegisterInWalk;
+static int32_t s_UnregisterInWalk;
+
+/**
+ * @brief  Post-change callback that tries to change the table it is called from
+ */
+static void ChangeTableInWalk(const Clock_Notify_Info_t *info, void *context)
+{
+  (void)info;
+  (void)context;
+  s_ChangeCallCount++;
+  s_RegisterInWalk = ClockNotify_Register(CountPreChange, CountPostChange, 0U, NULL);
+  s_UnregisterInWalk = ClockNotify_Unregister(s_CountHandle);
+}
+
+static void TestClockNotify(void)
+{
+  ResetRcc();
+  s_PreChangeCount = 0U;
+  s_PostChangeCount = 0U;
+  s_CountHandle = ClockNotify_Register(NULL, CountPostChange, 10U, NULL);
+  int32_t changeHandle = ClockNotify_Register(NULL, ChangeTableInWalk, 20U, NULL);
+  CHECK((s_CountHandle >= 0) && (changeHandle >= 0));
+
+  // Post-change runs 20 first, which tries to shift 10 under the walk
+  CHECK(SetSystemAndBusClockConfig(SYS_CLOCK_SPEED_40M, 2U, true) == CLOCK_OK);
+  CHECK(s_RegisterInWalk == CLOCK_ERROR_BUSY);
+  CHECK(s_UnregisterInWalk == CLOCK_ERROR_BUSY);
+  CHECK(s_ChangeCallCount == 1U);
+  CHECK(s_PostChangeCount == 1U);
+  CHECK(s_PreChangeCount == 0U);
+  CHECK(ClockNotify_Unregister(changeHandle) == CLOCK_OK);
+  CHECK(ClockNotify_Unregister(s_CountHandle) == CLOCK_OK);
+}
+
+int32_t main(void)
+{
+  TestRccTxn();
+  TestCycleCounter();
+  TestClockGate();
+  TestPowerProfile();
+  TestClockGovernor();
+  TestClockHealth();
+  TestClockRestart();
+  TestClockFastStart();
+  TestUsartBaud();
+  TestIrqPreemption();
+  TestClockNotify();
+
+  printf("%u checks, %u failures\n", s_Checks, s_Failures);
+  return (s_Failures == 0U) ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+/**
+ * @file    usart_baud.c
+ * @brief   Clock-aware USART baud rates: bus divider and BRR chosen together
+ * @author  SMC
+ * @date    September 2025
+ *
+ * See usart_baud.h.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "rcc_access.h"
+#include "clock_notify.h"
+#include "startup.h"
+#include "usart_baud.h"
+
+#define USART_BAUD_NOTIFY_PRIORITY       255U    /*!< Post-change runs highest first: BRR first after a change */
+#define PPM                              1000000ULL
+
+static const struct
+{
+  uint32_t divider;
+  uint32_t busDivBits;      /*!< RCC_CR BUS_DIV value */
+} s_BusDividers[] =
+{
+  { 1U, 0U },
+  { 2U, RCC_CR_BUS_DIV_0 },
+  { 4U, RCC_CR_BUS_DIV_1 },
+};
+
+static Usart_Baud_Port_t s_Ports[USART_BAUD_MAX_PORTS];
+static uint32_t s_NumPorts = 0U;
+static int32_t s_NotifyHandle = CLOCK_ERROR_NOT_STARTED;
+
+/**
+ * @brief  BRR value for a baud rate, oversampling by 16
+ * @param busClockHz USART kernel clock (the bus clock)
+ * @param baudRate Bits per second
+ * @retval BRR (mantissa << 4 | fraction), 0 if out of range
+ */
+uint32_t UsartBaud_GetBrr(uint32_t busClockHz, uint32_t baudRate)
+{
+  if (baudRate == 0U)
+  {
+    return 0U;
+  }
+
+  // USARTDIV = f / (16 * baud) in 12.4 fixed point is f / baud, rounded
+  uint32_t brr = (uint32_t)(((uint64_t)busClockHz + (baudRate / 2U)) / baudRate);
+  return ((brr < USART_BAUD_BRR_MIN) || (brr > USART_BAUD_BRR_MAX)) ? 0U : brr;
+}
+
+/**
+ * @brief  Baud rate error of a BRR value
+ * @retval |actual - requested| / requested in parts per million
+ */
+uint32_t UsartBaud_GetErrorPpm(uint32_t busClockHz, uint32_t brr, uint32_t baudRate)
+{
+  if ((brr == 0U) || (baudRate == 0U))
+  {
+    return UINT32_MAX;
+  }
+
+  uint64_t requested = (uint64_t)baudRate * brr;    // Both sides scaled by brr
+  uint64_t diff = (busClockHz > requested) ? (busClockHz - requested) : (requested - busClockHz);
+  uint64_t ppm = ((diff * PPM) + (requested / 2U)) / requested;
+  return (ppm > UINT32_MAX) ? UINT32_MAX : (uint32_t)ppm;
+}
+
+/**
+ * @brief  Picks the bus divider and BRR values for a set of baud rates
+ * @note   Pure computation, nothing is written. Every divider that keeps the
+ *         bus clock at 20MHz or less and gives every port a BRR in range is a
+ *         candidate; the lowest worst-case error wins, then the faster bus.
+ * @param sysClockHz System clock the bus divider applies to
+ * @param ports USARTs and baud rates (only the baud rates are used)
+ * @param numPorts 1 to USART_BAUD_MAX_PORTS
+ * @param plan Filled in with the choice
+ * @retval CLOCK_OK, CLOCK_ERROR_INVALID_ARG, or CLOCK_ERROR_UNREACHABLE if no
+ *         divider can produce all baud rates
+ */
+int32_t UsartBaud_Plan(uint32_t sysClockHz, const Usart_Baud_Port_t *ports, uint32_t numPorts,
+                       Usart_Baud_Plan_t *plan)
+{
+  if ((ports == NULL) || (plan == NULL) || (numPorts == 0U) || (numPorts > USART_BAUD_MAX_PORTS))
+  {
+    return CLOCK_ERROR_INVALID_ARG;
+  }
+
+  bool isFound = false;
+  for (uint32_t i = 0U; i < (sizeof(s_BusDividers) / sizeof(s_BusDividers[0])); i++)
+  {
+    uint32_t busClockHz = sysClockHz / s_BusDividers[i].divider;
+    if (busClockHz > CLOCK_MAX_BUS_CLOCK_HZ)
+    {
+      continue;
+    }
+
+    Usart_Baud_Plan_t candidate = { .busClockDivider = s_BusDividers[i].divider, .busClockHz = busClockHz };
+    bool isUsable = true;
+    for (uint32_t port = 0U; (port < numPorts) && isUsable; port++)
+    {
+      candidate.brr[port] = UsartBaud_GetBrr(busClockHz, ports[port].baudRate);
+      candidate.errorPpm[port] = UsartBaud_GetErrorPpm(busClockHz, candidate.brr[port], ports[port].baudRate);
+      isUsable = (candidate.brr[port] != 0U);
+      if (candidate.errorPpm[port] > candidate.worstErrorPpm)
+      {
+        candidate.worstErrorPpm = candidate.errorPpm[port];
+      }
+    }
+
+    // Dividers are tried fastest bus first, so a tie keeps the faster one
+    if (isUsable && (!isFound || (candidate.worstErrorPpm < plan->worstErrorPpm)))
+    {
+      *plan = candidate;
+      isFound = true;
+    }
+  }
+  return isFound ? CLOCK_OK : CLOCK_ERROR_UNREACHABLE;
+}
+
+/**
+ * @brief  Writes BRR of every port for a bus clock
+ */
+static void WriteBrr(uint32_t busClockHz)
+{
+  for (uint32_t port = 0U; port < s_NumPorts; port++)
+  {
+    uint32_t brr = UsartBaud_GetBrr(busClockHz, s_Ports[port].baudRate);
+    if (brr != 0U)
+    {
+      *(volatile uint32_t *)&s_Ports[port].usart->BRR = brr;
+    }
+  }
+}
+
+/**
+ * @brief  Follows every clock change, including failed switches and fallbacks
+ */
+static void OnClockPostChange(const Clock_Notify_Info_t *info, void *context)
+{
+  (void)context;
+  WriteBrr(info->newBusClockHz);
+}
+
+/**
+ * @brief  Sets the bus divider and BRR for the baud rates of the USARTs in use
+ * @note   Needs a configuration applied through the startup driver first; only
+ *         BUS_DIV of the last one a switch reached is changed, so a request
+ *         that failed (e.g. a dead crystal) is not retried. If that is already
+ *         the best divider only BRR is written. The ports are remembered and
+ *         their BRR rewritten after every later clock change; if the switch
+ *         fails the ports given before stay in use. Not during a clock switch.
+ * @param ports USARTs and baud rates, USART1 and/or USART2
+ * @param numPorts 1 to USART_BAUD_MAX_PORTS
+ * @param plan Filled in with the choice (may be NULL)
+ * @retval CLOCK_OK, CLOCK_ERROR_NOT_STARTED if no configuration was applied
+ *         yet, otherwise a negative Clock_Status_t from UsartBaud_Plan() or
+ *         the switch
+ */
+int32_t UsartBaud_Apply(const Usart_Baud_Port_t *ports, uint32_t numPorts, Usart_Baud_Plan_t *plan)
+{
+  Clock_Config_t config;
+  if (!ClockDriver_GetGoodConfig(ClockDriver_GetDefault(), &config))
+  {
+    return CLOCK_ERROR_NOT_STARTED;
+  }
+
+  Usart_Baud_Plan_t chosen;
+  int32_t status = UsartBaud_Plan(GetClockConfigSysClockHz(&config), ports, numPorts, &chosen);
+  for (uint32_t port = 0U; (status == CLOCK_OK) && (port < numPorts); port++)
+  {
+    if (ports[port].usart == NULL)
+    {
+      status = CLOCK_ERROR_INVALID_ARG;
+    }
+  }
+  if (status != CLOCK_OK)
+  {
+    return status;
+  }
+
+  // In place before the switch, so the notifier writes the new BRR first
+  Usart_Baud_Port_t oldPorts[USART_BAUD_MAX_PORTS];
+  uint32_t oldNumPorts = s_NumPorts;
+  for (uint32_t port = 0U; port < oldNumPorts; port++)
+  {
+    oldPorts[port] = s_Ports[port];
+  }
+  for (uint32_t port = 0U; port < numPorts; port++)
+  {
+    s_Ports[port] = ports[port];
+  }
+  s_NumPorts = numPorts;
+  if (s_NotifyHandle < 0)
+  {
+    s_NotifyHandle = ClockNotify_Register(NULL, OnClockPostChange, USART_BAUD_NOTIFY_PRIORITY, NULL);
+  }
+
+  uint32_t busDivBits = 0U;
+  for (uint32_t i = 0U; i < (sizeof(s_BusDividers) / sizeof(s_BusDividers[0])); i++)
+  {
+    if (s_BusDividers[i].divider == chosen.busClockDivider)
+    {
+      busDivBits = s_BusDividers[i].busDivBits;
+    }
+  }
+
+  if ((config.crDividers & RCC_CR_BUS_DIV) != busDivBits)
+  {
+    // The notifier writes BRR once the new divider is in effect
+    config.crDividers = (config.crDividers & ~RCC_CR_BUS_DIV) | busDivBits;
+    status = SetClockConfig(&config);
+    if (status != CLOCK_OK)
+    {
+      for (uint32_t port = 0U; port < oldNumPorts; port++)
+      {
+        s_Ports[port] = oldPorts[port];
+      }
+      s_NumPorts = oldNumPorts;
+      WriteBrr(GetBusClockHz());   // For whatever clock the failed switch left
+    }
+    else if (s_NotifyHandle < 0)
+    {
+      WriteBrr(GetBusClockHz());   // Notifier registry full or busy
+    }
+  }
+  else
+  {
+    WriteBrr(GetBusClockHz());
+  }
+
+  if (plan != NULL)
+  {
+    *plan = chosen;
+  }
+  return status;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file    usart_baud.h
+ * @brief   Clock-aware USART baud rates: bus divider and BRR chosen together
+ * @author  SMC
+ * @date    September 2025
+ *
+ * USART1 and USART2 are clocked by the bus clock, so the achievable baud
+ * rates depend on BUS_DIV. UsartBaud_Apply() takes the baud rate of every
+ * USART in use and tries each legal BUS_DIV value for the running system
+ * clock (bus clock 20MHz or less) together with the BRR value of every
+ * USART. It keeps the divider with the lowest worst-case baud error, the
+ * faster bus on a tie, switches to it (a divider-only switch when the rest
+ * of the configuration stays) and writes BRR.
+ *
+ * BRR uses oversampling by 16: mantissa in bits 4-15, fraction in bits 0-3,
+ * i.e. BRR = bus clock / baud rate rounded, 16 to 0xFFFF.
+ *
+ * A post-change clock notifier writes BRR again after every later clock
+ * change (speed switches, power profiles, governor, health monitor
+ * fallbacks), from the new bus clock. The divider is only chosen by
+ * UsartBaud_Apply(). A port whose baud rate the new bus clock cannot reach
+ * (BRR below 16) keeps its BRR.
+ *
+ */
+
+#ifndef USART_BAUD__H
+#define USART_BAUD__H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rcc_access.h"
+#include "startup.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define USART_BAUD_MAX_PORTS             2U      /*!< USART1 and USART2 */
+#define USART_BAUD_OVERSAMPLING          16UL
+#define USART_BAUD_BRR_MIN               16UL    /*!< Mantissa 1, fraction 0 */
+#define USART_BAUD_BRR_MAX               0xFFFFUL
+
+/**
+ * @brief One USART and the baud rate it needs
+ */
+typedef struct {
+  USART_TypeDef *usart;     // e.g. (USART_TypeDef *)USART1_BASE
+  uint32_t baudRate;        // Bits per second
+} Usart_Baud_Port_t;
+
+/**
+ * @brief Divider and BRR values picked for a set of baud rates
+ */
+typedef struct {
+  uint32_t busClockDivider;               // 1, 2 or 4
+  uint32_t busClockHz;
+  uint32_t brr[USART_BAUD_MAX_PORTS];
+  uint32_t errorPpm[USART_BAUD_MAX_PORTS]; // Baud rate error of each port, parts per million
+  uint32_t worstErrorPpm;
+} Usart_Baud_Plan_t;
+
+uint32_t UsartBaud_GetBrr(uint32_t busClockHz, uint32_t baudRate);
+uint32_t UsartBaud_GetErrorPpm(uint32_t busClockHz, uint32_t brr, uint32_t baudRate);
+int32_t UsartBaud_Plan(uint32_t sysClockHz, const Usart_Baud_Port_t *ports, uint32_t numPorts,
+                       Usart_Baud_Plan_t *plan);
+int32_t UsartBaud_Apply(const Usart_Baud_Port_t *ports, uint32_t numPorts, Usart_Baud_Plan_t *plan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // USART_BAUD__H